@@ -0,0 +1,281 @@
+#include "arrow_export.h"
+
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rs_realtime {
+
+namespace {
+
+struct ColumnDesc {
+    const char* name;
+    const char* format;     // Arrow格式字符串：f=float32, g=float64, I=uint32
+};
+
+const ColumnDesc kColumns[] = {
+    {"x", "f"}, {"y", "f"}, {"z", "f"}, {"intensity", "f"}, {"timestamp", "g"}
+};
+const ColumnDesc kSeqColumn = {"seq", "I"};
+constexpr size_t kNumColumns = sizeof(kColumns) / sizeof(kColumns[0]);
+
+// 流内复用的seq列缓冲：记录批释放后归还，可能在任意线程归还
+struct SeqBufferPool {
+    std::mutex mutex;
+    std::vector<std::vector<uint32_t>> free;
+
+    std::vector<uint32_t> take() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free.empty()) {
+            return {};
+        }
+        std::vector<uint32_t> buffer = std::move(free.back());
+        free.pop_back();
+        return buffer;
+    }
+
+    void put(std::vector<uint32_t>&& buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free.push_back(std::move(buffer));
+    }
+};
+
+// 导出帧的共享所有权：所有（可能被消费方单独移走的）子数组都持有一份
+struct ExportedFrame {
+    std::shared_ptr<const PointCloudData> frame;
+    std::vector<uint32_t> seq;
+    std::shared_ptr<SeqBufferPool> seq_pool;   // 非空时 seq 缓冲在释放时归还
+
+    ~ExportedFrame() {
+        if (seq_pool) {
+            seq_pool->put(std::move(seq));
+        }
+    }
+};
+
+struct ArrayNode {
+    std::shared_ptr<ExportedFrame> owner;
+    const void* buffers[2] = {nullptr, nullptr};
+    std::vector<ArrowArray> child_storage;
+    std::vector<ArrowArray*> child_ptrs;
+};
+
+struct SchemaNode {
+    std::string format;
+    std::string name;
+    std::string metadata;
+    std::vector<ArrowSchema> child_storage;
+    std::vector<ArrowSchema*> child_ptrs;
+};
+
+struct StreamState {
+    FrameSource source;
+    std::shared_ptr<SeqBufferPool> seq_pool = std::make_shared<SeqBufferPool>();
+    std::string last_error;
+    bool finished = false;
+};
+
+void releaseArray(ArrowArray* array) {
+    auto* node = static_cast<ArrayNode*>(array->private_data);
+    for (ArrowArray* child : node->child_ptrs) {
+        if (child->release) {
+            child->release(child);
+        }
+    }
+    delete node;
+    array->release = nullptr;
+}
+
+void releaseSchema(ArrowSchema* schema) {
+    auto* node = static_cast<SchemaNode*>(schema->private_data);
+    for (ArrowSchema* child : node->child_ptrs) {
+        if (child->release) {
+            child->release(child);
+        }
+    }
+    delete node;
+    schema->release = nullptr;
+}
+
+void fillSchema(SchemaNode* node, ArrowSchema* out) {
+    out->format = node->format.c_str();
+    out->name = node->name.c_str();
+    out->metadata = node->metadata.empty() ? nullptr : node->metadata.data();
+    out->flags = 0;
+    out->n_children = static_cast<int64_t>(node->child_ptrs.size());
+    out->children = node->child_ptrs.empty() ? nullptr : node->child_ptrs.data();
+    out->dictionary = nullptr;
+    out->release = &releaseSchema;
+    out->private_data = node;
+}
+
+void fillColumnSchema(const ColumnDesc& column, ArrowSchema* out) {
+    auto* node = new SchemaNode;
+    node->format = column.format;
+    node->name = column.name;
+    fillSchema(node, out);
+}
+
+void fillColumnArray(const std::shared_ptr<ExportedFrame>& owner, const void* data, int64_t length, ArrowArray* out) {
+    auto* node = new ArrayNode;
+    node->owner = owner;
+    node->buffers[0] = nullptr;     // 无空值，省略validity位图
+    node->buffers[1] = data;
+    out->length = length;
+    out->null_count = 0;
+    out->offset = 0;
+    out->n_buffers = 2;
+    out->n_children = 0;
+    out->buffers = node->buffers;
+    out->children = nullptr;
+    out->dictionary = nullptr;
+    out->release = &releaseArray;
+    out->private_data = node;
+}
+
+// 元数据按规范编码：int32 键值对数，随后每对依次为 int32 长度 + 字节
+void appendInt32(std::string& buffer, int32_t value) {
+    char bytes[sizeof(int32_t)];
+    std::memcpy(bytes, &value, sizeof(value));
+    buffer.append(bytes, sizeof(bytes));
+}
+
+std::string encodeMetadata(const std::vector<std::pair<std::string, std::string>>& pairs) {
+    std::string buffer;
+    appendInt32(buffer, static_cast<int32_t>(pairs.size()));
+    for (const auto& kv : pairs) {
+        appendInt32(buffer, static_cast<int32_t>(kv.first.size()));
+        buffer += kv.first;
+        appendInt32(buffer, static_cast<int32_t>(kv.second.size()));
+        buffer += kv.second;
+    }
+    return buffer;
+}
+
+// 导出记录批，seq_pool 非空时追加 seq 列并从中取缓冲
+void exportRecordBatch(std::shared_ptr<const PointCloudData> frame, std::shared_ptr<SeqBufferPool> seq_pool,
+                       ArrowArray* out) {
+    const bool seq_column = seq_pool != nullptr;
+    auto owner = std::make_shared<ExportedFrame>();
+    owner->frame = std::move(frame);
+    const PointCloudData& cloud = *owner->frame;
+    const auto length = static_cast<int64_t>(cloud.point_count);
+    if (seq_column) {
+        // 复用已归还缓冲的容量，只需按帧重新填值
+        owner->seq = seq_pool->take();
+        owner->seq.assign(cloud.point_count, cloud.frame_id);
+        owner->seq_pool = std::move(seq_pool);
+    }
+
+    const void* columns[kNumColumns + 1] = {
+        cloud.x.data(), cloud.y.data(), cloud.z.data(), cloud.intensity.data(), cloud.timestamp.data(),
+        owner->seq.data()
+    };
+    const size_t num_children = kNumColumns + (seq_column ? 1 : 0);
+
+    auto* node = new ArrayNode;
+    node->owner = owner;
+    node->child_storage.resize(num_children);
+    for (size_t c = 0; c < num_children; ++c) {
+        fillColumnArray(owner, columns[c], length, &node->child_storage[c]);
+        node->child_ptrs.push_back(&node->child_storage[c]);
+    }
+    out->length = length;
+    out->null_count = 0;
+    out->offset = 0;
+    out->n_buffers = 1;             // struct数组只有validity缓冲
+    out->n_children = static_cast<int64_t>(num_children);
+    out->buffers = node->buffers;
+    out->children = node->child_ptrs.data();
+    out->dictionary = nullptr;
+    out->release = &releaseArray;
+    out->private_data = node;
+}
+
+int streamGetSchema(ArrowArrayStream*, ArrowSchema* out) {
+    exportFrameSchema(nullptr, true, out);
+    return 0;
+}
+
+int streamGetNext(ArrowArrayStream* stream, ArrowArray* out) {
+    auto* state = static_cast<StreamState*>(stream->private_data);
+    if (!state->finished) {
+        try {
+            std::shared_ptr<PointCloudData> frame = state->source();
+            if (frame) {
+                exportRecordBatch(makeArrowFrame(std::move(frame)), state->seq_pool, out);
+                return 0;
+            }
+            state->finished = true;
+        } catch (const std::exception& e) {
+            state->last_error = e.what();
+            return EIO;
+        }
+    }
+    // 流结束：返回已释放状态的数组
+    out->release = nullptr;
+    return 0;
+}
+
+const char* streamGetLastError(ArrowArrayStream* stream) {
+    auto* state = static_cast<StreamState*>(stream->private_data);
+    return state->last_error.empty() ? nullptr : state->last_error.c_str();
+}
+
+void streamRelease(ArrowArrayStream* stream) {
+    delete static_cast<StreamState*>(stream->private_data);
+    stream->release = nullptr;
+}
+
+} // namespace
+
+std::shared_ptr<const PointCloudData> makeArrowFrame(PointCloudData&& cloud) {
+    return makeArrowFrame(std::make_shared<PointCloudData>(std::move(cloud)));
+}
+
+std::shared_ptr<const PointCloudData> makeArrowFrame(std::shared_ptr<PointCloudData> frame) {
+    const size_t n = frame->point_count;
+    frame->x.resize(n);
+    frame->y.resize(n);
+    frame->z.resize(n);
+    frame->intensity.resize(n, 0.f);
+    frame->timestamp.resize(n, 0.0);
+    return frame;
+}
+
+void exportFrameSchema(const PointCloudData* metadata_frame, bool seq_column, ArrowSchema* out) {
+    auto* node = new SchemaNode;
+    node->format = "+s";
+    const size_t num_children = kNumColumns + (seq_column ? 1 : 0);
+    node->child_storage.resize(num_children);
+    for (size_t c = 0; c < num_children; ++c) {
+        fillColumnSchema(c < kNumColumns ? kColumns[c] : kSeqColumn, &node->child_storage[c]);
+        node->child_ptrs.push_back(&node->child_storage[c]);
+    }
+    if (metadata_frame) {
+        node->metadata = encodeMetadata({
+            {"seq", std::to_string(metadata_frame->frame_id)},
+            {"frame_timestamp", std::to_string(metadata_frame->frame_timestamp)}
+        });
+    }
+    fillSchema(node, out);
+}
+
+void exportFrameArray(std::shared_ptr<const PointCloudData> frame, bool seq_column, ArrowArray* out) {
+    exportRecordBatch(std::move(frame), seq_column ? std::make_shared<SeqBufferPool>() : nullptr, out);
+}
+
+void exportFrameStream(FrameSource source, ArrowArrayStream* out) {
+    auto* state = new StreamState;
+    state->source = std::move(source);
+    out->get_schema = &streamGetSchema;
+    out->get_next = &streamGetNext;
+    out->get_last_error = &streamGetLastError;
+    out->release = &streamRelease;
+    out->private_data = state;
+}
+
+} // namespace rs_realtime
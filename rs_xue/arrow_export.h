@@ -0,0 +1,51 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "arrow_c_abi.h"
+#include "point_cloud_data.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 产生下一帧的回调，返回空指针表示流结束
+ *
+ * 返回的帧由导出的记录批共享持有，帧池中的帧可直接交出，随最后一个导出结构释放而归还。
+ */
+using FrameSource = std::function<std::shared_ptr<PointCloudData>()>;
+
+/**
+ * @brief 把一帧整理为可导出的只读帧：补齐缺失的 intensity / timestamp 列（填0）
+ *
+ * 导出的Arrow数组直接引用帧内各列的内存，帧的生命周期由所有导出结构共同持有。
+ */
+std::shared_ptr<const PointCloudData> makeArrowFrame(PointCloudData&& cloud);
+
+/**
+ * @brief 同上，原地整理一个已共享的帧（例如帧池中的帧，随最后一个导出结构释放而归还）
+ */
+std::shared_ptr<const PointCloudData> makeArrowFrame(std::shared_ptr<PointCloudData> frame);
+
+/**
+ * @brief 导出记录批的Schema：struct<x, y, z, intensity: float32, timestamp: float64>
+ *
+ * @param metadata_frame 非空时把该帧的 seq 与 frame_timestamp 写入Schema元数据
+ * @param seq_column 为true时追加 seq: uint32 列（流式导出中每批的seq无法放进共享的Schema）
+ */
+void exportFrameSchema(const PointCloudData* metadata_frame, bool seq_column, ArrowSchema* out);
+
+/**
+ * @brief 把一帧零拷贝导出为记录批（struct数组），列顺序与 exportFrameSchema 一致
+ */
+void exportFrameArray(std::shared_ptr<const PointCloudData> frame, bool seq_column, ArrowArray* out);
+
+/**
+ * @brief 把帧回调导出为Arrow流，每次 get_next 拉取一帧并零拷贝导出为一个记录批（含seq列）
+ *
+ * seq列的缓冲在记录批释放后回到流内复用，稳态下不再分配。
+ * 回调抛出的异常转换为 EIO 与 get_last_error 信息。回调捕获的对象在流释放时一并释放。
+ */
+void exportFrameStream(FrameSource source, ArrowArrayStream* out);
+
+} // namespace rs_realtime
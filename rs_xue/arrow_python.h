@@ -0,0 +1,99 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include <pybind11/pybind11.h>
+
+#include "arrow_export.h"
+
+namespace py = pybind11;
+
+namespace rs_realtime {
+
+/**
+ * @brief 单帧的Arrow导出对象，Python侧实现 __arrow_c_array__（Arrow PyCapsule接口）
+ *
+ * 可多次导出，每次导出都与该对象共享同一份帧内存。
+ */
+struct ArrowFrameHandle {
+    std::shared_ptr<const PointCloudData> frame;
+};
+
+/**
+ * @brief 帧流的Arrow导出对象，Python侧实现 __arrow_c_stream__，只能被消费一次
+ */
+struct ArrowStreamHandle {
+    FrameSource source;
+};
+
+inline void releaseArrowSchemaCapsule(PyObject* capsule) {
+    auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(capsule, "arrow_schema"));
+    if (schema->release) {
+        schema->release(schema);
+    }
+    delete schema;
+}
+
+inline void releaseArrowArrayCapsule(PyObject* capsule) {
+    auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(capsule, "arrow_array"));
+    if (array->release) {
+        array->release(array);
+    }
+    delete array;
+}
+
+inline void releaseArrowStreamCapsule(PyObject* capsule) {
+    auto* stream = static_cast<ArrowArrayStream*>(PyCapsule_GetPointer(capsule, "arrow_array_stream"));
+    if (stream->release) {
+        stream->release(stream);
+    }
+    delete stream;
+}
+
+/**
+ * @brief 导出 (schema, array) 两个PyCapsule；帧的 seq 与 frame_timestamp 写入Schema元数据
+ */
+inline py::tuple exportArrowFrame(const ArrowFrameHandle& handle) {
+    auto* schema = new ArrowSchema;
+    exportFrameSchema(handle.frame.get(), false, schema);
+    py::capsule schema_capsule(schema, "arrow_schema", &releaseArrowSchemaCapsule);
+    auto* array = new ArrowArray;
+    exportFrameArray(handle.frame, false, array);
+    py::capsule array_capsule(array, "arrow_array", &releaseArrowArrayCapsule);
+    return py::make_tuple(schema_capsule, array_capsule);
+}
+
+/**
+ * @brief 导出 ArrowArrayStream 的PyCapsule，帧源随之移交给流
+ */
+inline py::capsule exportArrowStream(ArrowStreamHandle& handle) {
+    if (!handle.source) {
+        throw py::value_error("the Arrow stream has already been consumed");
+    }
+    auto* stream = new ArrowArrayStream;
+    exportFrameStream(std::move(handle.source), stream);
+    handle.source = nullptr;
+    return py::capsule(stream, "arrow_array_stream", &releaseArrowStreamCapsule);
+}
+
+/**
+ * @brief 包装帧源：调用期间若持有GIL则释放（消费方可能在持有GIL时调用 get_next），
+ *        并让流持有 owner 的引用直到流被释放
+ */
+inline ArrowStreamHandle makeArrowStream(FrameSource source, py::object owner = py::none()) {
+    // 流可能在任意线程释放，释放Python引用前先获取GIL
+    std::shared_ptr<py::object> keep(new py::object(std::move(owner)), [](py::object* obj) {
+        py::gil_scoped_acquire gil;
+        delete obj;
+    });
+    return ArrowStreamHandle{[source, keep]() mutable {
+        if (PyGILState_Check()) {
+            py::gil_scoped_release release;
+            return source();
+        }
+        return source();
+    }};
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,160 @@
+#include "bev_rasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace rs_realtime {
+
+namespace {
+
+// 每个任务块处理的点数
+constexpr size_t kPointGrain = 16384;
+// 归约阶段每个任务块处理的栅格数
+constexpr size_t kCellGrain = 4096;
+
+} // namespace
+
+BevRasterizer::BevRasterizer(const BevConfig& config, ThreadPool& pool)
+    : config_(config),
+      pool_(pool),
+      height_(0),
+      width_(0),
+      num_channels_(0) {
+    if (!(config_.resolution > 0.f) || !(config_.x_max > config_.x_min) || !(config_.y_max > config_.y_min)) {
+        throw std::invalid_argument("BevRasterizer: invalid grid extent or resolution");
+    }
+    width_ = static_cast<size_t>(std::ceil((config_.x_max - config_.x_min) / config_.resolution));
+    height_ = static_cast<size_t>(std::ceil((config_.y_max - config_.y_min) / config_.resolution));
+    for (uint32_t bit = BEV_MAX_Z; bit <= BEV_MEAN_INTENSITY; bit <<= 1) {
+        if (config_.channels & bit) {
+            ++num_channels_;
+        }
+    }
+    if (num_channels_ == 0) {
+        throw std::invalid_argument("BevRasterizer: no channel selected");
+    }
+
+    partials_.resize(pool_.size());
+    for (auto& partial : partials_) {
+        resetPartial(partial);
+    }
+}
+
+void BevRasterizer::resetPartial(Partial& partial) const {
+    const size_t cells = height_ * width_;
+    partial.count.assign(cells, 0);
+    if (config_.channels & BEV_MAX_Z) {
+        partial.max_z.assign(cells, -std::numeric_limits<float>::infinity());
+    }
+    if (config_.channels & BEV_MIN_Z) {
+        partial.min_z.assign(cells, std::numeric_limits<float>::infinity());
+    }
+    if (config_.channels & BEV_MEAN_INTENSITY) {
+        partial.sum_intensity.assign(cells, 0.f);
+    }
+}
+
+void BevRasterizer::rasterize(const float* x, const float* y, const float* z, const float* intensity,
+                              size_t n, size_t stride, const RigidTransform* transform, float* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool want_max = (config_.channels & BEV_MAX_Z) != 0;
+    const bool want_min = (config_.channels & BEV_MIN_Z) != 0;
+    const bool want_intensity = (config_.channels & BEV_MEAN_INTENSITY) != 0 && intensity != nullptr;
+    const float inv_res = 1.f / config_.resolution;
+    const RigidTransform T = transform ? *transform : RigidTransform();
+    const bool apply_transform = transform != nullptr;
+
+    // 第一步：点按块分给各线程，写各自的局部栅格
+    pool_.parallelFor(n, kPointGrain, [&](size_t begin, size_t end, size_t worker) {
+        Partial& partial = partials_[worker];
+        for (size_t i = begin; i < end; ++i) {
+            const size_t k = i * stride;
+            float px = x[k];
+            float py = y[k];
+            float pz = z[k];
+            if (apply_transform) {
+                const float tx = T.R[0] * px + T.R[1] * py + T.R[2] * pz + T.t[0];
+                const float ty = T.R[3] * px + T.R[4] * py + T.R[5] * pz + T.t[1];
+                const float tz = T.R[6] * px + T.R[7] * py + T.R[8] * pz + T.t[2];
+                px = tx;
+                py = ty;
+                pz = tz;
+            }
+            // NaN点在比较中自然被过滤
+            if (!(px >= config_.x_min && px < config_.x_max &&
+                  py >= config_.y_min && py < config_.y_max &&
+                  pz >= config_.z_min && pz <= config_.z_max)) {
+                continue;
+            }
+            const size_t ix = std::min(static_cast<size_t>((px - config_.x_min) * inv_res), width_ - 1);
+            const size_t iy = std::min(static_cast<size_t>((py - config_.y_min) * inv_res), height_ - 1);
+            const size_t cell = iy * width_ + ix;
+            partial.count[cell] += 1;
+            if (want_max) {
+                partial.max_z[cell] = std::max(partial.max_z[cell], pz);
+            }
+            if (want_min) {
+                partial.min_z[cell] = std::min(partial.min_z[cell], pz);
+            }
+            if (want_intensity) {
+                partial.sum_intensity[cell] += intensity[k];
+            }
+        }
+    });
+
+    // 第二步：按栅格并行归约到输出，同时复位局部栅格
+    const size_t cells = height_ * width_;
+    const size_t num_partials = partials_.size();
+    pool_.parallelFor(cells, kCellGrain, [&](size_t begin, size_t end, size_t) {
+        for (size_t cell = begin; cell < end; ++cell) {
+            uint32_t count = 0;
+            float max_z = -std::numeric_limits<float>::infinity();
+            float min_z = std::numeric_limits<float>::infinity();
+            float sum_intensity = 0.f;
+            for (size_t p = 0; p < num_partials; ++p) {
+                Partial& partial = partials_[p];
+                if (partial.count[cell] == 0) {
+                    continue;
+                }
+                count += partial.count[cell];
+                partial.count[cell] = 0;
+                if (want_max) {
+                    max_z = std::max(max_z, partial.max_z[cell]);
+                    partial.max_z[cell] = -std::numeric_limits<float>::infinity();
+                }
+                if (want_min) {
+                    min_z = std::min(min_z, partial.min_z[cell]);
+                    partial.min_z[cell] = std::numeric_limits<float>::infinity();
+                }
+                if (want_intensity) {
+                    sum_intensity += partial.sum_intensity[cell];
+                    partial.sum_intensity[cell] = 0.f;
+                }
+            }
+
+            size_t c = 0;
+            if (config_.channels & BEV_MAX_Z) {
+                out[(c++) * cells + cell] = count ? max_z : 0.f;
+            }
+            if (config_.channels & BEV_MIN_Z) {
+                out[(c++) * cells + cell] = count ? min_z : 0.f;
+            }
+            if (config_.channels & BEV_COUNT) {
+                out[(c++) * cells + cell] = static_cast<float>(count);
+            }
+            if (config_.channels & BEV_MEAN_INTENSITY) {
+                out[(c++) * cells + cell] = count ? sum_intensity / static_cast<float>(count) : 0.f;
+            }
+        }
+    });
+}
+
+void BevRasterizer::rasterize(const PointCloudData& cloud, const RigidTransform* transform, float* out) {
+    const float* intensity = cloud.intensity.size() >= cloud.point_count ? cloud.intensity.data() : nullptr;
+    rasterize(cloud.x.data(), cloud.y.data(), cloud.z.data(), intensity,
+              cloud.point_count, 1, transform, out);
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "point_cloud_data.h"
+#include "pose.h"
+#include "thread_pool.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief BEV通道，可按位组合
+ */
+enum BevChannel : uint32_t {
+    BEV_MAX_Z = 1u << 0,            // 栅格内最大高度
+    BEV_MIN_Z = 1u << 1,            // 栅格内最小高度
+    BEV_COUNT = 1u << 2,            // 栅格内点数（密度）
+    BEV_MEAN_INTENSITY = 1u << 3,   // 栅格内平均强度
+    BEV_ALL = BEV_MAX_Z | BEV_MIN_Z | BEV_COUNT | BEV_MEAN_INTENSITY
+};
+
+/**
+ * @brief BEV栅格配置
+ */
+struct BevConfig {
+    float x_min = -51.2f;
+    float x_max = 51.2f;
+    float y_min = -51.2f;
+    float y_max = 51.2f;
+    float z_min = -5.0f;            // 高度范围外的点不参与栅格化
+    float z_max = 5.0f;
+    float resolution = 0.2f;        // 栅格边长（米）
+    uint32_t channels = BEV_ALL;
+};
+
+/**
+ * @brief 鸟瞰图（BEV）/占据栅格光栅化
+ *
+ * 输出为 (C, H, W) 的float32张量，H沿y方向、W沿x方向，通道按 BevChannel 位序排列，
+ * 空栅格各通道均为0。可选地在栅格化时融合一个标定变换，避免单独的变换遍历。
+ * 点按块分给线程池，每个线程写私有的局部栅格，最后按栅格并行归约，
+ * 归约同时把局部栅格复位，下一帧无需再清零。
+ * 局部栅格属于实例本身，同一实例的并发调用会被串行化。
+ */
+class BevRasterizer {
+public:
+    explicit BevRasterizer(const BevConfig& config, ThreadPool& pool = ThreadPool::global());
+
+    const BevConfig& config() const { return config_; }
+    size_t height() const { return height_; }
+    size_t width() const { return width_; }
+    size_t numChannels() const { return num_channels_; }
+
+    /**
+     * @brief 栅格化任意步长的点数组
+     *
+     * @param x,y,z,intensity 各字段首元素指针，intensity可为空
+     * @param stride 相邻点同一字段之间的间隔（以float计），SoA为1，(N,4)数组为4
+     * @param transform 可选的标定变换，为空表示点已在输出坐标系下
+     * @param out 预分配的 numChannels()*height()*width() 输出缓冲
+     */
+    void rasterize(const float* x, const float* y, const float* z, const float* intensity,
+                   size_t n, size_t stride, const RigidTransform* transform, float* out);
+
+    void rasterize(const PointCloudData& cloud, const RigidTransform* transform, float* out);
+
+private:
+    struct Partial {
+        std::vector<float> max_z;
+        std::vector<float> min_z;
+        std::vector<float> sum_intensity;
+        std::vector<uint32_t> count;
+    };
+
+    void resetPartial(Partial& partial) const;
+
+    BevConfig config_;
+    ThreadPool& pool_;
+    size_t height_;
+    size_t width_;
+    size_t num_channels_;
+    std::vector<Partial> partials_;   // 每个线程一份局部栅格
+    std::mutex mutex_;                // 保护局部栅格
+};
+
+} // namespace rs_realtime
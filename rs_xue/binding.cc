@@ -4,6 +4,10 @@
 #include <pybind11/stl.h>
 #include "realtime_lidar_client.h"
 #include "pcap_converter.h"
+#include "bev_rasterizer.h"
+#include "camera_projector.h"
+#include "numpy_utils.h"
+#include "arrow_python.h"
 
 namespace py = pybind11;
 using namespace pybind11::literals;
@@ -11,24 +15,644 @@ using namespace pybind11::literals;
 PYBIND11_MODULE(rs_xue, m) {
     m.doc() = "RoboSense LiDAR driver with real-time support"; // 模块文档字符串
     
+    // 离群点过滤
+    py::enum_<rs_realtime::OutlierMethod>(m, "OutlierMethod")
+        .value("NONE", rs_realtime::OutlierMethod::NONE)
+        .value("RADIUS", rs_realtime::OutlierMethod::RADIUS)
+        .value("STATISTICAL", rs_realtime::OutlierMethod::STATISTICAL);
+
+    py::class_<rs_realtime::OutlierFilterConfig>(m, "OutlierFilterConfig")
+        .def(py::init<>())
+        .def_readwrite("method", &rs_realtime::OutlierFilterConfig::method)
+        .def_readwrite("radius", &rs_realtime::OutlierFilterConfig::radius,
+                       "Neighbourhood radius of the radius filter (m)")
+        .def_readwrite("min_neighbors", &rs_realtime::OutlierFilterConfig::min_neighbors,
+                       "Minimum neighbours within radius for a point to be kept")
+        .def_readwrite("k", &rs_realtime::OutlierFilterConfig::k,
+                       "Number of nearest neighbours of the statistical filter (max 32)")
+        .def_readwrite("std_ratio", &rs_realtime::OutlierFilterConfig::std_ratio,
+                       "Points whose mean k-NN distance exceeds mean + std_ratio * std are removed")
+        .def_readwrite("search_radius", &rs_realtime::OutlierFilterConfig::search_radius,
+                       "Neighbour search radius of the statistical filter (m)")
+        .def_readwrite("return_mask", &rs_realtime::OutlierFilterConfig::return_mask,
+                       "Return an inlier mask instead of removing outliers");
+
+    // 地面分割
+    py::class_<rs_realtime::GroundSegmentationConfig>(m, "GroundSegmentationConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &rs_realtime::GroundSegmentationConfig::enabled)
+        .def_readwrite("patch_size", &rs_realtime::GroundSegmentationConfig::patch_size,
+                       "Edge length of the horizontal patches, one plane is fitted per patch (m)")
+        .def_readwrite("num_lpr", &rs_realtime::GroundSegmentationConfig::num_lpr,
+                       "Number of lowest points averaged to seed each patch")
+        .def_readwrite("seed_threshold", &rs_realtime::GroundSegmentationConfig::seed_threshold,
+                       "Points within this height above the lowest-point average seed the plane fit (m)")
+        .def_readwrite("distance_threshold", &rs_realtime::GroundSegmentationConfig::distance_threshold,
+                       "Points closer than this to the fitted plane are ground (m)")
+        .def_readwrite("num_iterations", &rs_realtime::GroundSegmentationConfig::num_iterations,
+                       "Number of plane fitting iterations per patch")
+        .def_readwrite("max_slope_deg", &rs_realtime::GroundSegmentationConfig::max_slope_deg,
+                       "Patches whose plane is tilted more than this are not ground (degrees)")
+        .def_readwrite("min_patch_points", &rs_realtime::GroundSegmentationConfig::min_patch_points,
+                       "Patches with fewer points are not fitted and labelled non-ground")
+        .def_readwrite("remove_ground", &rs_realtime::GroundSegmentationConfig::remove_ground,
+                       "Remove ground points instead of returning a ground label per point");
+
+    // 欧氏聚类
+    py::class_<rs_realtime::ClusteringConfig>(m, "ClusteringConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &rs_realtime::ClusteringConfig::enabled)
+        .def_readwrite("tolerance", &rs_realtime::ClusteringConfig::tolerance,
+                       "Points closer than this are in the same cluster (m)")
+        .def_readwrite("min_points", &rs_realtime::ClusteringConfig::min_points,
+                       "Clusters with fewer points are labelled -1")
+        .def_readwrite("max_points", &rs_realtime::ClusteringConfig::max_points,
+                       "Clusters with more points are labelled -1; 0 = unlimited")
+        .def_readwrite("skip_ground", &rs_realtime::ClusteringConfig::skip_ground,
+                       "Leave ground points out of clustering when ground labels are available");
+
+    py::class_<rs_realtime::EuclideanClusterer>(m, "EuclideanClusterer")
+        .def(py::init([](const rs_realtime::ClusteringConfig& config) {
+                 auto clusterer = std::make_unique<rs_realtime::EuclideanClusterer>();
+                 clusterer->setConfig(config);
+                 return clusterer;
+             }),
+             "Create a clusterer; enabled is ignored for direct calls",
+             py::arg("config") = rs_realtime::ClusteringConfig())
+        .def("cluster",
+             [](rs_realtime::EuclideanClusterer& self,
+                const py::array_t<float, py::array::c_style | py::array::forcecast>& points,
+                const py::object& exclude) {
+                 const size_t n = rs_realtime::checkPointArray(points, 3);
+                 const size_t stride = static_cast<size_t>(points.shape(1));
+                 py::array_t<uint8_t, py::array::c_style | py::array::forcecast> mask;
+                 if (!exclude.is_none()) {
+                     mask = exclude.cast<py::array_t<uint8_t, py::array::c_style | py::array::forcecast>>();
+                     if (static_cast<size_t>(mask.size()) != n) {
+                         throw py::value_error("exclude must have one entry per point");
+                     }
+                 }
+                 py::array_t<int32_t> labels(static_cast<py::ssize_t>(n));
+                 rs_realtime::FrameClusters clusters;
+                 const float* data = points.data();
+                 const uint8_t* mask_ptr = exclude.is_none() ? nullptr : mask.data();
+                 int32_t* labels_ptr = labels.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     self.cluster(data, data + 1, data + 2, n, stride, mask_ptr, labels_ptr, clusters);
+                 }
+                 py::dict result = rs_realtime::clustersToDict(clusters);
+                 result["labels"] = labels;
+                 return result;
+             },
+             "Cluster (N, 3+) points; returns labels (N,) int32 (-1 = noise) and per-cluster count, centroid, min, max",
+             py::arg("points"), py::arg("exclude") = py::none());
+
+    // 法向与曲率估计
+    py::class_<rs_realtime::NormalEstimationConfig>(m, "NormalEstimationConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &rs_realtime::NormalEstimationConfig::enabled)
+        .def_readwrite("radius", &rs_realtime::NormalEstimationConfig::radius,
+                       "Neighbours farther than this from the point are not used (m)")
+        .def_readwrite("min_neighbors", &rs_realtime::NormalEstimationConfig::min_neighbors,
+                       "Points with fewer neighbours (including themselves) get NaN normal and curvature")
+        .def_readwrite("scan_rows", &rs_realtime::NormalEstimationConfig::scan_rows,
+                       "Points per scan column of organized frames; 0 uses the voxel neighbourhood")
+        .def_readwrite("row_window", &rs_realtime::NormalEstimationConfig::row_window,
+                       "Rows taken above and below the point in the scan-order neighbourhood")
+        .def_readwrite("col_window", &rs_realtime::NormalEstimationConfig::col_window,
+                       "Columns taken left and right of the point in the scan-order neighbourhood")
+        .def_readwrite("orient_to_sensor", &rs_realtime::NormalEstimationConfig::orient_to_sensor,
+                       "Flip normals to face the sensor origin")
+        .def_readwrite("dense_neighbors", &rs_realtime::NormalEstimationConfig::dense_neighbors,
+                       "Voxel neighbourhood only: where the 27 surrounding voxels hold more points than this, points "
+                       "in one radius/4 sub-voxel share a covariance of the sub-voxels fully within radius "
+                       "(approximate, faster); 0 always searches the exact radius");
+
+    py::class_<rs_realtime::NormalEstimator>(m, "NormalEstimator")
+        .def(py::init([](const rs_realtime::NormalEstimationConfig& config) {
+                 auto estimator = std::make_unique<rs_realtime::NormalEstimator>();
+                 estimator->setConfig(config);
+                 return estimator;
+             }),
+             "Create a normal estimator; enabled is ignored for direct calls",
+             py::arg("config") = rs_realtime::NormalEstimationConfig())
+        .def("estimate",
+             [](rs_realtime::NormalEstimator& self,
+                const py::array_t<float, py::array::c_style | py::array::forcecast>& points,
+                const py::object& scan_index, const py::object& exclude) {
+                 const size_t n = rs_realtime::checkPointArray(points, 3);
+                 const size_t stride = static_cast<size_t>(points.shape(1));
+                 py::array_t<uint32_t, py::array::c_style | py::array::forcecast> index;
+                 if (!scan_index.is_none()) {
+                     index = scan_index.cast<py::array_t<uint32_t, py::array::c_style | py::array::forcecast>>();
+                     if (static_cast<size_t>(index.size()) != n) {
+                         throw py::value_error("scan_index must have one entry per point");
+                     }
+                 }
+                 py::array_t<uint8_t, py::array::c_style | py::array::forcecast> mask;
+                 if (!exclude.is_none()) {
+                     mask = exclude.cast<py::array_t<uint8_t, py::array::c_style | py::array::forcecast>>();
+                     if (static_cast<size_t>(mask.size()) != n) {
+                         throw py::value_error("exclude must have one entry per point");
+                     }
+                 }
+                 const auto count = static_cast<py::ssize_t>(n);
+                 py::array_t<float> normals({count, static_cast<py::ssize_t>(3)});
+                 py::array_t<float> curvature(count);
+                 const float* data = points.data();
+                 const uint32_t* index_ptr = scan_index.is_none() ? nullptr : index.data();
+                 const uint8_t* mask_ptr = exclude.is_none() ? nullptr : mask.data();
+                 float* normal_ptr = normals.mutable_data();
+                 float* curvature_ptr = curvature.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     self.estimate(data, data + 1, data + 2, n, stride, index_ptr, mask_ptr,
+                                   normal_ptr, normal_ptr + 1, normal_ptr + 2, 3, curvature_ptr);
+                 }
+                 py::dict result;
+                 result["normals"] = normals;
+                 result["curvature"] = curvature;
+                 return result;
+             },
+             "Estimate normals (N, 3) and curvature (N,) of (N, 3+) points; NaN where the neighbourhood is too small. "
+             "With scan_rows > 0 the points are an organized scan, optionally mapped by scan_index",
+             py::arg("points"), py::arg("scan_index") = py::none(), py::arg("exclude") = py::none());
+
+    // 帧间变化检测
+    py::enum_<rs_realtime::ChangeLabel>(m, "ChangeLabel")
+        .value("STATIC", rs_realtime::ChangeLabel::STATIC)
+        .value("NEW", rs_realtime::ChangeLabel::NEW)
+        .value("VANISHED", rs_realtime::ChangeLabel::VANISHED)
+        .value("UNKNOWN", rs_realtime::ChangeLabel::UNKNOWN);
+
+    py::class_<rs_realtime::ChangeDetectionConfig>(m, "ChangeDetectionConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &rs_realtime::ChangeDetectionConfig::enabled)
+        .def_readwrite("voxel_size", &rs_realtime::ChangeDetectionConfig::voxel_size,
+                       "Edge length of the occupancy voxels (m)")
+        .def_readwrite("history_frames", &rs_realtime::ChangeDetectionConfig::history_frames,
+                       "A voxel counts as previously occupied if any of this many previous frames hit it")
+        .def_readwrite("ego_motion", &rs_realtime::ChangeDetectionConfig::ego_motion,
+                       "Compare frames in the world frame using the pose at each frame timestamp");
+
+    py::class_<rs_realtime::ChangeDetector>(m, "ChangeDetector")
+        .def(py::init([](const rs_realtime::ChangeDetectionConfig& config) {
+                 auto detector = std::make_unique<rs_realtime::ChangeDetector>();
+                 detector->setConfig(config);
+                 return detector;
+             }),
+             "Create a change detector with empty history; enabled and ego_motion are ignored for direct calls",
+             py::arg("config") = rs_realtime::ChangeDetectionConfig())
+        .def("detect",
+             [](rs_realtime::ChangeDetector& self,
+                const py::array_t<float, py::array::c_style | py::array::forcecast>& points,
+                const py::object& R, const py::object& t, const py::object& exclude) {
+                 const size_t n = rs_realtime::checkPointArray(points, 3);
+                 const size_t stride = static_cast<size_t>(points.shape(1));
+                 rs_realtime::RigidTransform world_from_frame;
+                 if (!R.is_none() && !t.is_none()) {
+                     world_from_frame = rs_realtime::toRigidTransform(
+                         R.cast<py::array_t<float, py::array::c_style | py::array::forcecast>>(),
+                         t.cast<py::array_t<float, py::array::c_style | py::array::forcecast>>());
+                 }
+                 py::array_t<uint8_t, py::array::c_style | py::array::forcecast> mask;
+                 if (!exclude.is_none()) {
+                     mask = exclude.cast<py::array_t<uint8_t, py::array::c_style | py::array::forcecast>>();
+                     if (static_cast<size_t>(mask.size()) != n) {
+                         throw py::value_error("exclude must have one entry per point");
+                     }
+                 }
+                 py::array_t<uint8_t> labels(static_cast<py::ssize_t>(n));
+                 const float* data = points.data();
+                 const uint8_t* mask_ptr = exclude.is_none() ? nullptr : mask.data();
+                 uint8_t* label_ptr = labels.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     self.detect(data, data + 1, data + 2, n, stride, world_from_frame, mask_ptr, label_ptr);
+                 }
+                 return labels;
+             },
+             "Compare (N, 3+) points with the previous frames and add them to the history; returns labels (N,) uint8 "
+             "(see ChangeLabel). R (3, 3) and t (3,) map the points into the comparison frame",
+             py::arg("points"), py::arg("R") = py::none(), py::arg("t") = py::none(), py::arg("exclude") = py::none())
+        .def("reset", &rs_realtime::ChangeDetector::reset,
+             "Forget the history; the next frame is labelled UNKNOWN");
+
+    // 多帧累积
+    py::class_<rs_realtime::AccumulatorConfig>(m, "AccumulatorConfig")
+        .def(py::init<>())
+        .def_readwrite("enabled", &rs_realtime::AccumulatorConfig::enabled)
+        .def_readwrite("max_frames", &rs_realtime::AccumulatorConfig::max_frames,
+                       "Number of most recent frames kept in the window")
+        .def_readwrite("max_age", &rs_realtime::AccumulatorConfig::max_age,
+                       "Frames older than this relative to the newest frame leave the window (s); 0 = frame count only")
+        .def_readwrite("voxel_size", &rs_realtime::AccumulatorConfig::voxel_size,
+                       "Keep only the newest point per voxel of this size (m); 0 disables deduplication")
+        .def_readwrite("world_frame", &rs_realtime::AccumulatorConfig::world_frame,
+                       "Output world coordinates instead of the newest frame's coordinates");
+
+    // 降精度输出
+    py::enum_<rs_realtime::OutputDType>(m, "OutputDType")
+        .value("FLOAT32", rs_realtime::OutputDType::FLOAT32)
+        .value("FLOAT16", rs_realtime::OutputDType::FLOAT16)
+        .value("BFLOAT16", rs_realtime::OutputDType::BFLOAT16);
+
+    m.def("to_float32",
+          [](const py::array& values) {
+              // float16 按半精度展开，uint16 视为 bfloat16 位模式
+              const py::dtype kind = values.dtype();
+              rs_realtime::OutputDType dtype;
+              if (kind.kind() == 'f' && kind.itemsize() == 2) {
+                  dtype = rs_realtime::OutputDType::FLOAT16;
+              } else if (kind.kind() == 'u' && kind.itemsize() == 2) {
+                  dtype = rs_realtime::OutputDType::BFLOAT16;
+              } else {
+                  throw py::value_error("values must be a float16 array or a uint16 array of bfloat16 bits");
+              }
+              auto contiguous = py::array::ensure(values, py::array::c_style);
+              std::vector<py::ssize_t> shape(values.shape(), values.shape() + values.ndim());
+              py::array_t<float> result(shape);
+              const auto* in = static_cast<const uint16_t*>(contiguous.data());
+              float* out = result.mutable_data();
+              const size_t n = static_cast<size_t>(values.size());
+              {
+                  py::gil_scoped_release release;
+                  rs_realtime::unpackValues(in, n, dtype, out);
+              }
+              return result;
+          },
+          "Expand reduced-precision output to float32: float16 arrays, or uint16 arrays holding bfloat16 bits",
+          py::arg("values"));
+
+    // 转换输出的写入后端
+    py::enum_<rs_realtime::WriterBackend>(m, "WriterBackend")
+        .value("SYNC", rs_realtime::WriterBackend::SYNC)
+        .value("AUTO", rs_realtime::WriterBackend::AUTO)
+        .value("IO_URING", rs_realtime::WriterBackend::IO_URING)
+        .value("THREADS", rs_realtime::WriterBackend::THREADS);
+
+    py::enum_<rs_realtime::Durability>(m, "Durability")
+        .value("NONE", rs_realtime::Durability::NONE)
+        .value("EVERY_N_FRAMES", rs_realtime::Durability::EVERY_N_FRAMES)
+        .value("END", rs_realtime::Durability::END);
+
+    py::class_<rs_realtime::NpyWriterConfig>(m, "NpyWriterConfig")
+        .def(py::init<>())
+        .def_readwrite("backend", &rs_realtime::NpyWriterConfig::backend,
+                       "SYNC writes in the conversion thread; IO_URING/AUTO batch through io_uring and fall back to THREADS")
+        .def_readwrite("direct_io", &rs_realtime::NpyWriterConfig::direct_io,
+                       "Open files with O_DIRECT (falls back to buffered writes where unsupported)")
+        .def_readwrite("durability", &rs_realtime::NpyWriterConfig::durability,
+                       "When to syncfs the output file system: NONE, EVERY_N_FRAMES or END")
+        .def_readwrite("sync_every", &rs_realtime::NpyWriterConfig::sync_every,
+                       "Frames between syncs with EVERY_N_FRAMES")
+        .def_readwrite("queue_depth", &rs_realtime::NpyWriterConfig::queue_depth,
+                       "Files in flight with io_uring")
+        .def_readwrite("threads", &rs_realtime::NpyWriterConfig::threads,
+                       "Writer threads with THREADS")
+        .def_readwrite("max_pending_bytes", &rs_realtime::NpyWriterConfig::max_pending_bytes,
+                       "Bytes of queued output before conversion waits for the writer");
+
+    // pcap转换的可选处理阶段
+    py::class_<ConvertOptions>(m, "ConvertOptions")
+        .def(py::init<>())
+        .def_readwrite("pose_file", &ConvertOptions::pose_file,
+                       "TUM-format pose file (timestamp tx ty tz qx qy qz qw); enables motion compensation when set")
+        .def_readwrite("deskew_bucket_us", &ConvertOptions::deskew_bucket_us,
+                       "Time bucket length in microseconds; points in one bucket share one pose interpolation")
+        .def_readwrite("outlier", &ConvertOptions::outlier,
+                       "Outlier filter; in mask mode the mask is saved next to each frame as *_inlier.npy")
+        .def_readwrite("ground", &ConvertOptions::ground,
+                       "Ground segmentation; in label mode the labels are saved next to each frame as *_ground.npy")
+        .def_readwrite("normals", &ConvertOptions::normals,
+                       "Normal estimation; normals and curvature are saved next to each frame as *_normal.npy and *_curvature.npy")
+        .def_readwrite("clustering", &ConvertOptions::clustering,
+                       "Euclidean clustering; the labels are saved next to each frame as *_cluster.npy")
+        .def_readwrite("change", &ConvertOptions::change,
+                       "Change detection against the previous frames; the labels are saved next to each frame as *_change.npy")
+        .def_readwrite("drop_invalid", &ConvertOptions::drop_invalid,
+                       "Drop points with NaN/Inf coordinates during conversion")
+        .def_readwrite("scan_index", &ConvertOptions::scan_index,
+                       "Save the original scan index of every kept point next to each frame as *_index.npy")
+        .def_readwrite("dtype", &ConvertOptions::dtype,
+                       "Precision of the saved points and normals: FLOAT32, FLOAT16 ('<f2') or BFLOAT16 (bits saved as '<u2')")
+        .def_readwrite("writer", &ConvertOptions::writer,
+                       "How output files are written (NpyWriterConfig): backend, O_DIRECT and durability");
+
+    // Arrow导出（PyCapsule接口，可直接交给 pyarrow / polars / DuckDB）
+    py::class_<rs_realtime::ArrowFrameHandle>(m, "ArrowFrame")
+        .def("__arrow_c_array__",
+             [](const rs_realtime::ArrowFrameHandle& self, const py::object&) {
+                 // requested_schema 按规范可以忽略，始终按自身Schema导出
+                 return rs_realtime::exportArrowFrame(self);
+             },
+             "Export the frame as an Arrow record batch (schema and array PyCapsules) without copying",
+             py::arg("requested_schema") = py::none())
+        .def("__len__", [](const rs_realtime::ArrowFrameHandle& self) { return self.frame->point_count; })
+        .def_property_readonly("frame_id", [](const rs_realtime::ArrowFrameHandle& self) { return self.frame->frame_id; })
+        .def_property_readonly("frame_timestamp",
+                               [](const rs_realtime::ArrowFrameHandle& self) { return self.frame->frame_timestamp; });
+
+    py::class_<rs_realtime::ArrowStreamHandle>(m, "ArrowStream")
+        .def("__arrow_c_stream__",
+             [](rs_realtime::ArrowStreamHandle& self, const py::object&) {
+                 return rs_realtime::exportArrowStream(self);
+             },
+             "Export the frames as an Arrow C stream PyCapsule; each frame becomes one record batch with a seq column",
+             py::arg("requested_schema") = py::none());
+
     // pcap处理函数
-    m.def("convert_pcap", &convert_pcap, "read pcd from pcd file");
+    m.def("convert_pcap", &convert_pcap,
+          "read pcd from pcap file without calibration; only options.dtype and options.writer are used, the processing stages are not",
+          py::arg("from_name"), py::arg("to_name"), py::arg("num_frames"), py::arg("options") = ConvertOptions());
     m.def("convert_pcap_with_calib", &convert_pcap_with_calib, "read pcd from pcap file and apply calibration and range filtering",
-          py::arg("from_name"), py::arg("to_name"), py::arg("R"), py::arg("t"), py::arg("ranges"), py::arg("num_frames"));
+          py::arg("from_name"), py::arg("to_name"), py::arg("R"), py::arg("t"), py::arg("ranges"), py::arg("num_frames"),
+          py::arg("options") = ConvertOptions());
+    m.def("pcap_arrow_stream", &pcap_arrow_stream,
+          "Open a pcap file as an Arrow stream of calibrated, range-filtered frames (same stages as convert_pcap_with_calib)",
+          py::arg("from_name"), py::arg("R"), py::arg("t"), py::arg("ranges"), py::arg("num_frames") = 0,
+          py::arg("options") = ConvertOptions());
     
+    // BEV栅格化
+    py::class_<rs_realtime::BevRasterizer>(m, "BevRasterizer")
+        .def(py::init([](std::pair<float, float> x_range, std::pair<float, float> y_range,
+                         std::pair<float, float> z_range, float resolution,
+                         const std::vector<std::string>& channels) {
+                 rs_realtime::BevConfig config;
+                 config.x_min = x_range.first;
+                 config.x_max = x_range.second;
+                 config.y_min = y_range.first;
+                 config.y_max = y_range.second;
+                 config.z_min = z_range.first;
+                 config.z_max = z_range.second;
+                 config.resolution = resolution;
+                 config.channels = 0;
+                 for (const auto& name : channels) {
+                     if (name == "max_z") config.channels |= rs_realtime::BEV_MAX_Z;
+                     else if (name == "min_z") config.channels |= rs_realtime::BEV_MIN_Z;
+                     else if (name == "count") config.channels |= rs_realtime::BEV_COUNT;
+                     else if (name == "mean_intensity") config.channels |= rs_realtime::BEV_MEAN_INTENSITY;
+                     else throw py::value_error("unknown BEV channel: " + name);
+                 }
+                 return std::make_unique<rs_realtime::BevRasterizer>(config);
+             }),
+             "Create a BEV rasterizer; channels are emitted in the order max_z, min_z, count, mean_intensity",
+             py::arg("x_range") = std::make_pair(-51.2f, 51.2f),
+             py::arg("y_range") = std::make_pair(-51.2f, 51.2f),
+             py::arg("z_range") = std::make_pair(-5.0f, 5.0f),
+             py::arg("resolution") = 0.2f,
+             py::arg("channels") = std::vector<std::string>{"max_z", "min_z", "count", "mean_intensity"})
+        .def_property_readonly("shape", [](const rs_realtime::BevRasterizer& self) {
+                 return py::make_tuple(self.numChannels(), self.height(), self.width());
+             },
+             "Output tensor shape (C, H, W); H runs along y and W along x")
+        .def("rasterize",
+             [](rs_realtime::BevRasterizer& self,
+                const py::array_t<float, py::array::c_style | py::array::forcecast>& points,
+                const py::object& out, const py::object& R, const py::object& t) {
+                 const size_t n = rs_realtime::checkPointArray(points, 3);
+                 const size_t stride = static_cast<size_t>(points.shape(1));
+                 rs_realtime::RigidTransform transform;
+                 const bool has_transform = !R.is_none() && !t.is_none();
+                 if (has_transform) {
+                     transform = rs_realtime::toRigidTransform(
+                         R.cast<py::array_t<float, py::array::c_style | py::array::forcecast>>(),
+                         t.cast<py::array_t<float, py::array::c_style | py::array::forcecast>>());
+                 }
+                 auto result = rs_realtime::ensureOutputArray<float>(out, {
+                     static_cast<py::ssize_t>(self.numChannels()),
+                     static_cast<py::ssize_t>(self.height()),
+                     static_cast<py::ssize_t>(self.width())
+                 });
+                 const float* data = points.data();
+                 float* ptr = result.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     self.rasterize(data, data + 1, data + 2, stride >= 4 ? data + 3 : nullptr,
+                                    n, stride, has_transform ? &transform : nullptr, ptr);
+                 }
+                 return result;
+             },
+             "Rasterize (N, 3) or (N, 4) [x, y, z, intensity] points, optionally applying calibration R/t on the fly",
+             py::arg("points"), py::arg("out") = py::none(), py::arg("R") = py::none(), py::arg("t") = py::none());
+
+    // 相机投影
+    py::class_<rs_realtime::CameraModel>(m, "CameraModel")
+        .def(py::init([](float fx, float fy, float cx, float cy, uint32_t width, uint32_t height,
+                         const py::object& R, const py::object& t, const std::vector<float>& distortion,
+                         float min_depth) {
+                 rs_realtime::CameraModel cam;
+                 cam.fx = fx;
+                 cam.fy = fy;
+                 cam.cx = cx;
+                 cam.cy = cy;
+                 cam.width = width;
+                 cam.height = height;
+                 cam.min_depth = min_depth;
+                 if (distortion.size() > cam.distortion.size()) {
+                     throw py::value_error("distortion must be [k1, k2, p1, p2] or [k1, k2, p1, p2, k3]");
+                 }
+                 std::copy(distortion.begin(), distortion.end(), cam.distortion.begin());
+                 if (!R.is_none() && !t.is_none()) {
+                     cam.extrinsic = rs_realtime::toRigidTransform(
+                         R.cast<py::array_t<float, py::array::c_style | py::array::forcecast>>(),
+                         t.cast<py::array_t<float, py::array::c_style | py::array::forcecast>>());
+                 }
+                 return cam;
+             }),
+             "Create a pinhole camera with OpenCV radtan distortion; R, t map calibrated lidar points into the camera frame (z forward)",
+             py::arg("fx"), py::arg("fy"), py::arg("cx"), py::arg("cy"), py::arg("width"), py::arg("height"),
+             py::arg("R") = py::none(), py::arg("t") = py::none(),
+             py::arg("distortion") = std::vector<float>{}, py::arg("min_depth") = 0.1f)
+        .def_readwrite("fx", &rs_realtime::CameraModel::fx)
+        .def_readwrite("fy", &rs_realtime::CameraModel::fy)
+        .def_readwrite("cx", &rs_realtime::CameraModel::cx)
+        .def_readwrite("cy", &rs_realtime::CameraModel::cy)
+        .def_readwrite("width", &rs_realtime::CameraModel::width)
+        .def_readwrite("height", &rs_realtime::CameraModel::height)
+        .def_readwrite("min_depth", &rs_realtime::CameraModel::min_depth)
+        .def_readwrite("distortion", &rs_realtime::CameraModel::distortion, "[k1, k2, p1, p2, k3]");
+
+    py::class_<rs_realtime::CameraProjector>(m, "CameraProjector")
+        .def(py::init([](const std::vector<rs_realtime::CameraModel>& cameras) {
+                 return std::make_unique<rs_realtime::CameraProjector>(cameras);
+             }),
+             "Create a projector for a set of cameras",
+             py::arg("cameras"))
+        .def_property_readonly("num_cameras", &rs_realtime::CameraProjector::numCameras)
+        .def("project_depth",
+             [](rs_realtime::CameraProjector& self,
+                const py::array_t<float, py::array::c_style | py::array::forcecast>& points,
+                const py::object& out) {
+                 const size_t n = rs_realtime::checkPointArray(points, 3);
+                 const size_t stride = static_cast<size_t>(points.shape(1));
+                 std::vector<std::vector<py::ssize_t>> shapes;
+                 for (size_t c = 0; c < self.numCameras(); ++c) {
+                     shapes.push_back({static_cast<py::ssize_t>(self.camera(c).height),
+                                       static_cast<py::ssize_t>(self.camera(c).width)});
+                 }
+                 auto images = rs_realtime::ensureOutputList<float>(out, shapes);
+                 std::vector<float*> ptrs;
+                 for (auto& image : images) {
+                     ptrs.push_back(image.mutable_data());
+                 }
+                 const float* data = points.data();
+                 {
+                     py::gil_scoped_release release;
+                     self.projectDepth(data, data + 1, data + 2, n, stride, ptrs.data());
+                 }
+                 py::list result;
+                 for (auto& image : images) {
+                     result.append(image);
+                 }
+                 return result;
+             },
+             "Project (N, 3+) points into one (H, W) min-depth image per camera (0 where empty), written into out when given",
+             py::arg("points"), py::arg("out") = py::none())
+        .def("project_points",
+             [](rs_realtime::CameraProjector& self,
+                const py::array_t<float, py::array::c_style | py::array::forcecast>& points) {
+                 const size_t n = rs_realtime::checkPointArray(points, 3);
+                 const size_t stride = static_cast<size_t>(points.shape(1));
+                 const float* data = points.data();
+                 // 每个Python线程一份列表缓冲，跨调用复用容量，投影后只拷贝一次到numpy数组
+                 thread_local std::vector<rs_realtime::CameraPoints> lists;
+                 {
+                     py::gil_scoped_release release;
+                     self.projectPoints(data, data + 1, data + 2, n, stride, lists);
+                 }
+                 py::list result;
+                 for (const rs_realtime::CameraPoints& list : lists) {
+                     const auto count = static_cast<py::ssize_t>(list.index.size());
+                     py::dict entry;
+                     entry["u"] = py::array_t<float>(count, list.u.data());
+                     entry["v"] = py::array_t<float>(count, list.v.data());
+                     entry["depth"] = py::array_t<float>(count, list.depth.data());
+                     entry["index"] = py::array_t<uint32_t>(count, list.index.data());
+                     result.append(entry);
+                 }
+                 return result;
+             },
+             "Project (N, 3+) points and return per camera a dict of u, v, depth and index of the points inside the image",
+             py::arg("points"));
+
+    // 帧池与大页
+    py::enum_<rs_realtime::HugePageMode>(m, "HugePageMode")
+        .value("NONE", rs_realtime::HugePageMode::NONE)
+        .value("TRANSPARENT", rs_realtime::HugePageMode::TRANSPARENT)
+        .value("EXPLICIT", rs_realtime::HugePageMode::EXPLICIT);
+
+    py::class_<rs_realtime::FramePoolConfig>(m, "FramePoolConfig")
+        .def(py::init<>())
+        .def_readwrite("frames", &rs_realtime::FramePoolConfig::frames,
+                       "Number of frames and driver messages allocated up front")
+        .def_readwrite("max_points", &rs_realtime::FramePoolConfig::max_points,
+                       "Points reserved per frame, at least the sensor's maximum per frame; 0 lets buffers grow on the first frames")
+        .def_readwrite("huge_pages", &rs_realtime::FramePoolConfig::huge_pages,
+                       "Huge page backing for frame buffers (process-wide)");
+
+    // 客户端运行计数
+    py::class_<rs_realtime::ClientStats>(m, "ClientStats")
+        .def_readonly("frames_received", &rs_realtime::ClientStats::frames_received,
+                      "Frames assembled by the driver")
+        .def_readonly("frames_processed", &rs_realtime::ClientStats::frames_processed,
+                      "Frames that went through conversion and all processing stages")
+        .def_readonly("frames_delivered", &rs_realtime::ClientStats::frames_delivered,
+                      "Frames handed out by get / get_frame / get_bev / get_depth / get_arrow")
+        .def_readonly("frames_overwritten", &rs_realtime::ClientStats::frames_overwritten,
+                      "Processed frames replaced by a newer one before anybody fetched them")
+        .def_readonly("points_received", &rs_realtime::ClientStats::points_received,
+                      "Total points output by the driver")
+        .def_readonly("max_queue_depth", &rs_realtime::ClientStats::max_queue_depth,
+                      "Largest backlog of driver frames waiting for the processing thread")
+        .def_readonly("message_allocations", &rs_realtime::ClientStats::message_allocations,
+                      "Driver messages allocated because the message pool was empty")
+        .def_readonly("message_growths", &rs_realtime::ClientStats::message_growths,
+                      "Driver message point buffers reallocated because a frame exceeded their capacity")
+        .def_readonly("frame_pool_misses", &rs_realtime::ClientStats::frame_pool_misses,
+                      "Frames allocated because the frame pool was empty")
+        .def_readonly("column_allocations", &rs_realtime::ClientStats::column_allocations,
+                      "Frame column buffer allocations in the whole process")
+        .def_readonly("huge_page_allocations", &rs_realtime::ClientStats::huge_page_allocations,
+                      "Frame column buffer allocations backed by huge pages");
+
     // 绑定RealtimeLidarClient类
     py::class_<rs_realtime::RealtimeLidarClient>(m, "Client")
         .def(py::init<>())
         .def("initialize", 
-             [](rs_realtime::RealtimeLidarClient& self, const std::string& lidar_ip) {
-                 return self.initialize(lidar_ip, 6699, 7788, robosense::lidar::LidarType::RSEM4, "0.0.0.0");
+             [](rs_realtime::RealtimeLidarClient& self, const std::string& lidar_ip,
+                uint16_t msop_port, uint16_t difop_port, const std::string& host_ip) {
+                 return self.initialize(lidar_ip, msop_port, difop_port, robosense::lidar::LidarType::RSEM4, host_ip);
              },
-             "Initialize with LiDAR IP (uses default port 6699 and RSEM4 type)",
-             py::arg("lidar_ip"))
+             "Initialize with LiDAR IP (RSEM4 type); ports and the local address to bind are optional",
+             py::arg("lidar_ip"), py::arg("msop_port") = 6699, py::arg("difop_port") = 7788,
+             py::arg("host_ip") = "0.0.0.0")
+        .def("get_stats", &rs_realtime::RealtimeLidarClient::get_stats,
+             "Snapshot of the frame and allocation counters")
+        .def("reset_stats", &rs_realtime::RealtimeLidarClient::reset_stats,
+             "Reset the frame counters to zero")
+        .def("set_frame_pool", &rs_realtime::RealtimeLidarClient::set_frame_pool,
+             "Configure the frame pool; pre-warmed at initialize(), or immediately when already initialized",
+             py::arg("config"))
         .def("get", &rs_realtime::RealtimeLidarClient::get_numpy,
              "Get point cloud data as numpy array with shape (N, 3) containing [x, y, z] coordinates")
+        .def("get_frame", &rs_realtime::RealtimeLidarClient::get_frame,
+             "Get the next frame as a dict of arrays (points, intensity, timestamp, frame_id, receive_time, ready_time, stats, and stage outputs)")
+        .def("set_drop_invalid", &rs_realtime::RealtimeLidarClient::set_drop_invalid,
+             "Drop points with NaN/Inf coordinates during conversion, optionally keeping a map to the original scan index",
+             py::arg("enable") = true, py::arg("scan_index") = false)
+        .def("set_output_dtype", &rs_realtime::RealtimeLidarClient::set_output_dtype,
+             "Set the precision of points returned by get() and get_frame(): FLOAT32, FLOAT16, or BFLOAT16 as uint16 bits; "
+             "intensity_uint8 returns intensity as uint8",
+             py::arg("dtype"), py::arg("intensity_uint8") = false)
+        .def("set_outlier_filter", &rs_realtime::RealtimeLidarClient::set_outlier_filter,
+             "Configure the outlier filter applied to every frame",
+             py::arg("config"))
+        .def("set_ground_segmentation", &rs_realtime::RealtimeLidarClient::set_ground_segmentation,
+             "Configure the ground segmentation applied to every frame after outlier filtering",
+             py::arg("config"))
+        .def("set_clustering", &rs_realtime::RealtimeLidarClient::set_clustering,
+             "Configure the Euclidean clustering applied to every frame after ground segmentation",
+             py::arg("config"))
+        .def("set_normals", &rs_realtime::RealtimeLidarClient::set_normals,
+             "Configure the normal and curvature estimation applied to every frame after ground segmentation",
+             py::arg("config"))
+        .def("set_change_detection", &rs_realtime::RealtimeLidarClient::set_change_detection,
+             "Configure the frame-to-frame change detection applied to every frame after clustering; resets the history",
+             py::arg("config"))
+        .def("set_accumulation", &rs_realtime::RealtimeLidarClient::set_accumulation,
+             "Configure the sliding-window accumulation of recent frames transformed by the pose stream; resets the window",
+             py::arg("config"))
+        .def("get_accumulated", &rs_realtime::RealtimeLidarClient::get_accumulated,
+             "Wait for the next frame and return the accumulated window as a dict (points, intensity, age, frame_id, timestamp, num_frames)")
+        .def("get_bev", &rs_realtime::RealtimeLidarClient::get_bev,
+             "Get the next frame rasterized into a (C, H, W) BEV tensor, written into out when given",
+             py::arg("rasterizer"), py::arg("out") = py::none())
+        .def("get_arrow", &rs_realtime::RealtimeLidarClient::get_arrow,
+             "Get the next frame as an ArrowFrame exporting x, y, z, intensity, timestamp without copying")
+        .def("arrow_stream",
+             [](py::object self, int max_frames) {
+                 auto& client = self.cast<rs_realtime::RealtimeLidarClient&>();
+                 // 流持有客户端的引用，客户端不会先于流被销毁
+                 return rs_realtime::makeArrowStream(client.frame_source(max_frames), self);
+             },
+             "Stream frames as Arrow record batches until the client stops or max_frames (0 = unlimited) is reached",
+             py::arg("max_frames") = 0)
+        .def("get_depth", &rs_realtime::RealtimeLidarClient::get_depth,
+             "Get the next frame projected into one sparse (H, W) depth image per camera, written into out when given",
+             py::arg("projector"), py::arg("out") = py::none())
         .def("set_calib", &rs_realtime::RealtimeLidarClient::set_calib,
              "Set calibration parameters R (3x3) and t (3x1)")
+        .def("push_pose", &rs_realtime::RealtimeLidarClient::push_pose,
+             "Push an ego pose (calibrated frame in world) for motion compensation, q in [x, y, z, w] order",
+             py::arg("timestamp"), py::arg("t"), py::arg("q"))
+        .def("load_poses", &rs_realtime::RealtimeLidarClient::load_poses,
+             "Load poses from a TUM-format file, returns the number of poses loaded",
+             py::arg("path"))
+        .def("set_deskew", &rs_realtime::RealtimeLidarClient::set_deskew,
+             "Enable or disable motion compensation using per-point timestamps and the pose stream",
+             py::arg("enable"), py::arg("bucket_us") = 1000.0)
         .def("stop", &rs_realtime::RealtimeLidarClient::stop,
              "Stop the LiDAR client");
 }
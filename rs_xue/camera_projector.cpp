@@ -0,0 +1,120 @@
+#include "camera_projector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace rs_realtime {
+
+namespace {
+
+// 每组批量投影的点数，组内的中间结果留在栈上
+constexpr size_t kBlock = 256;
+
+} // namespace
+
+CameraProjector::CameraProjector(const std::vector<CameraModel>& cameras, ThreadPool& pool)
+    : cameras_(cameras),
+      pool_(pool) {
+    for (const auto& cam : cameras_) {
+        if (cam.width == 0 || cam.height == 0 || !(cam.fx > 0.f) || !(cam.fy > 0.f)) {
+            throw std::invalid_argument("CameraProjector: invalid image size or focal length");
+        }
+        // 图像四角对应的（未畸变）归一化半径，放宽到2倍
+        const float u_far = std::max(cam.cx, static_cast<float>(cam.width) - cam.cx) / cam.fx;
+        const float v_far = std::max(cam.cy, static_cast<float>(cam.height) - cam.cy) / cam.fy;
+        max_r2_.push_back(4.f * (u_far * u_far + v_far * v_far));
+    }
+}
+
+template <typename Sink>
+void CameraProjector::projectCamera(size_t c, const float* x, const float* y, const float* z, size_t n,
+                                    size_t stride, Sink&& sink) const {
+    const CameraModel& cam = cameras_[c];
+    const auto& R = cam.extrinsic.R;
+    const auto& t = cam.extrinsic.t;
+    const float k1 = cam.distortion[0];
+    const float k2 = cam.distortion[1];
+    const float p1 = cam.distortion[2];
+    const float p2 = cam.distortion[3];
+    const float k3 = cam.distortion[4];
+    const float max_r2 = max_r2_[c];
+    // 以像素中心为整数坐标，+0.5后取整即为像素下标
+    const float u_limit = static_cast<float>(cam.width);
+    const float v_limit = static_cast<float>(cam.height);
+
+    float bu[kBlock];
+    float bv[kBlock];
+    float bd[kBlock];
+    for (size_t base = 0; base < n; base += kBlock) {
+        const size_t m = std::min(kBlock, n - base);
+
+        // 批量变换与畸变，无效点的深度记为0
+        for (size_t i = 0; i < m; ++i) {
+            const size_t k = (base + i) * stride;
+            const float px = x[k];
+            const float py = y[k];
+            const float pz = z[k];
+            const float qx = R[0] * px + R[1] * py + R[2] * pz + t[0];
+            const float qy = R[3] * px + R[4] * py + R[5] * pz + t[1];
+            const float qz = R[6] * px + R[7] * py + R[8] * pz + t[2];
+            const float inv_z = 1.f / qz;
+            const float xn = qx * inv_z;
+            const float yn = qy * inv_z;
+            const float r2 = xn * xn + yn * yn;
+            const float radial = 1.f + r2 * (k1 + r2 * (k2 + r2 * k3));
+            const float xy2 = 2.f * xn * yn;
+            const float xd = xn * radial + p1 * xy2 + p2 * (r2 + 2.f * xn * xn);
+            const float yd = yn * radial + p1 * (r2 + 2.f * yn * yn) + p2 * xy2;
+            bu[i] = cam.fx * xd + cam.cx + 0.5f;
+            bv[i] = cam.fy * yd + cam.cy + 0.5f;
+            bd[i] = (qz > cam.min_depth && r2 < max_r2) ? qz : 0.f;
+        }
+
+        for (size_t i = 0; i < m; ++i) {
+            if (bd[i] > 0.f && bu[i] >= 0.f && bu[i] < u_limit && bv[i] >= 0.f && bv[i] < v_limit) {
+                sink(base + i, bu[i], bv[i], bd[i]);
+            }
+        }
+    }
+}
+
+void CameraProjector::projectDepth(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                   float* const* out) {
+    pool_.parallelFor(cameras_.size(), 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; ++c) {
+            const size_t width = cameras_[c].width;
+            float* image = out[c];
+            std::fill(image, image + width * cameras_[c].height, 0.f);
+            projectCamera(c, x, y, z, n, stride, [&](size_t, float u, float v, float depth) {
+                float& pixel = image[static_cast<size_t>(v) * width + static_cast<size_t>(u)];
+                if (pixel == 0.f || depth < pixel) {
+                    pixel = depth;
+                }
+            });
+        }
+    });
+}
+
+void CameraProjector::projectDepth(const PointCloudData& cloud, float* const* out) {
+    projectDepth(cloud.x.data(), cloud.y.data(), cloud.z.data(), cloud.point_count, 1, out);
+}
+
+void CameraProjector::projectPoints(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                    std::vector<CameraPoints>& out) {
+    out.resize(cameras_.size());
+    pool_.parallelFor(cameras_.size(), 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; ++c) {
+            CameraPoints& list = out[c];
+            list.clear();
+            projectCamera(c, x, y, z, n, stride, [&](size_t i, float u, float v, float depth) {
+                list.u.push_back(u - 0.5f);
+                list.v.push_back(v - 0.5f);
+                list.depth.push_back(depth);
+                list.index.push_back(static_cast<uint32_t>(i));
+            });
+        }
+    });
+}
+
+} // namespace rs_realtime
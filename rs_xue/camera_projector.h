@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "point_cloud_data.h"
+#include "pose.h"
+#include "thread_pool.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 针孔相机模型（OpenCV radtan畸变）
+ *
+ * 像素坐标以像素中心为整数，与OpenCV一致。
+ */
+struct CameraModel {
+    float fx = 1.0f;
+    float fy = 1.0f;
+    float cx = 0.0f;
+    float cy = 0.0f;
+    std::array<float, 5> distortion {0.f, 0.f, 0.f, 0.f, 0.f};  // k1, k2, p1, p2, k3
+    RigidTransform extrinsic;       // 点云坐标系到相机坐标系的变换（相机z轴朝前）
+    uint32_t width = 0;
+    uint32_t height = 0;
+    float min_depth = 0.1f;         // 深度小于该值（含相机后方）的点不投影（米）
+};
+
+/**
+ * @brief 单个相机的投影点列表，各列等长
+ */
+struct CameraPoints {
+    std::vector<float> u;           // 亚像素列坐标
+    std::vector<float> v;           // 亚像素行坐标
+    std::vector<float> depth;       // 相机坐标系下的z
+    std::vector<uint32_t> index;    // 点在输入中的下标
+
+    void clear() {
+        u.clear();
+        v.clear();
+        depth.clear();
+        index.clear();
+    }
+};
+
+/**
+ * @brief 多相机点云投影
+ *
+ * 输出每个相机的稀疏深度图（同一像素取最小深度），或落入图像内的 (u, v, depth, index) 列表。
+ * 相机之间在线程池上并行；每个相机内按定长分组先批量完成变换、归一化和畸变
+ * （无分支，可向量化），再逐点写入深度图或列表。实例只保存相机参数，
+ * 列表直接写入调用方的缓冲，不同线程可以同时调用同一实例。
+ *
+ * 畸变多项式在视场外会折返回图像内，因此归一化半径超过图像角点对应半径2倍的点直接丢弃。
+ */
+class CameraProjector {
+public:
+    explicit CameraProjector(const std::vector<CameraModel>& cameras, ThreadPool& pool = ThreadPool::global());
+
+    size_t numCameras() const { return cameras_.size(); }
+    const CameraModel& camera(size_t c) const { return cameras_[c]; }
+
+    /**
+     * @brief 生成各相机的稀疏深度图，无点的像素为0
+     *
+     * @param stride 相邻点同一字段之间的间隔（以float计），SoA为1，(N,3)数组为3
+     * @param out out[c] 为第c个相机预分配的 height*width 缓冲
+     */
+    void projectDepth(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                      float* const* out);
+
+    void projectDepth(const PointCloudData& cloud, float* const* out);
+
+    /**
+     * @brief 生成各相机的投影点列表，直接写入 out[c]（对应第c个相机）
+     *
+     * 调用方跨帧复用 out 时不再分配内存。
+     */
+    void projectPoints(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                       std::vector<CameraPoints>& out);
+
+private:
+    template <typename Sink>
+    void projectCamera(size_t c, const float* x, const float* y, const float* z, size_t n, size_t stride,
+                       Sink&& sink) const;
+
+    std::vector<CameraModel> cameras_;
+    std::vector<float> max_r2_;         // 各相机允许的最大归一化半径平方
+    ThreadPool& pool_;
+};
+
+} // namespace rs_realtime
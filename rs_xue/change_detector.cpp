@@ -0,0 +1,280 @@
+#include "change_detector.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace rs_realtime {
+
+namespace {
+
+// 体素键只用低63位，全1不会与有效键冲突
+constexpr uint64_t kEmptyKey = ~0ull;
+constexpr size_t kMinTableSize = 1024;
+// 每个任务块处理的体素数
+constexpr size_t kCellGrain = 512;
+// 每个任务块扫描的历史哈希表槽位数
+constexpr size_t kSlotGrain = 16384;
+// 每个任务块写标签的点数
+constexpr size_t kPointGrain = 16384;
+
+bool isIdentity(const RigidTransform& T) {
+    const RigidTransform identity;
+    return T.R == identity.R && T.t == identity.t;
+}
+
+// 当前帧在体素 coord 的3x3x3邻域内是否有占据，找到一个即返回
+bool occupiedNear(const VoxelHashGrid& grid, const int32_t* coord) {
+    for (int32_t dx = -1; dx <= 1; ++dx) {
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            for (int32_t dz = -1; dz <= 1; ++dz) {
+                if (grid.findCell(coord[0] + dx, coord[1] + dy, coord[2] + dz) != VoxelHashGrid::kInvalidCell) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+ChangeDetector::ChangeDetector(ThreadPool& pool)
+    : pool_(pool) {
+}
+
+void ChangeDetector::setConfig(const ChangeDetectionConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    config_.history_frames = std::max<uint32_t>(config_.history_frames, 1);
+    std::fill(table_key_.begin(), table_key_.end(), kEmptyKey);
+    table_used_ = 0;
+    generation_ = 0;
+}
+
+void ChangeDetector::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fill(table_key_.begin(), table_key_.end(), kEmptyKey);
+    table_used_ = 0;
+    generation_ = 0;
+}
+
+uint32_t ChangeDetector::lastSeen(uint64_t key) const {
+    if (table_key_.empty()) {
+        return 0;
+    }
+    const uint64_t mask = table_key_.size() - 1;
+    uint64_t slot = VoxelHashGrid::hashKey(key) & mask;
+    while (table_key_[slot] != kEmptyKey) {
+        if (table_key_[slot] == key) {
+            return table_seen_[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return 0;
+}
+
+void ChangeDetector::rebuildTable(size_t capacity) {
+    size_t size = kMinTableSize;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    size = std::max(size, table_key_.size());
+
+    // 旧表换到备用缓冲，只搬回下一帧仍在历史窗口内的体素
+    table_key_.swap(spare_key_);
+    table_seen_.swap(spare_seen_);
+    table_key_.assign(size, kEmptyKey);
+    table_seen_.resize(size);
+    table_used_ = 0;
+    const uint64_t mask = size - 1;
+    for (size_t i = 0; i < spare_key_.size(); ++i) {
+        const uint64_t key = spare_key_[i];
+        if (key == kEmptyKey || generation_ - spare_seen_[i] >= config_.history_frames) {
+            continue;
+        }
+        uint64_t slot = VoxelHashGrid::hashKey(key) & mask;
+        while (table_key_[slot] != kEmptyKey) {
+            slot = (slot + 1) & mask;
+        }
+        table_key_[slot] = key;
+        table_seen_[slot] = spare_seen_[i];
+        ++table_used_;
+    }
+}
+
+void ChangeDetector::insertCells() {
+    const size_t num_cells = grid_.numCells();
+    // 负载超过一半时清理过期体素，清理后仍然拥挤才扩容
+    if (table_key_.empty() || (table_used_ + num_cells) * 2 > table_key_.size()) {
+        rebuildTable(2 * num_cells);
+        if ((table_used_ + num_cells) * 2 > table_key_.size()) {
+            rebuildTable(2 * (table_used_ + num_cells));
+        }
+    }
+    const uint64_t mask = table_key_.size() - 1;
+    for (size_t c = 0; c < num_cells; ++c) {
+        const int32_t* coord = grid_.cellCoord(static_cast<uint32_t>(c));
+        const uint64_t key = VoxelHashGrid::packKey(coord[0], coord[1], coord[2]);
+        uint64_t slot = VoxelHashGrid::hashKey(key) & mask;
+        while (table_key_[slot] != kEmptyKey && table_key_[slot] != key) {
+            slot = (slot + 1) & mask;
+        }
+        if (table_key_[slot] == kEmptyKey) {
+            table_key_[slot] = key;
+            ++table_used_;
+        }
+        table_seen_[slot] = generation_;
+    }
+}
+
+size_t ChangeDetector::detect(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                              const RigidTransform& world_from_frame, const uint8_t* exclude, uint8_t* labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return detectLocked(x, y, z, n, stride, world_from_frame, exclude, labels);
+}
+
+size_t ChangeDetector::detectLocked(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                    const RigidTransform& world_from_frame, const uint8_t* exclude,
+                                    uint8_t* labels) {
+    const float voxel_size = std::max(config_.voxel_size, 1e-3f);
+
+    // 变换到比较坐标系，被排除的点置为NaN，体素索引会跳过它们
+    const bool transform = !isIdentity(world_from_frame);
+    if (transform || exclude) {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        world_x_.resize(n);
+        world_y_.resize(n);
+        world_z_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            world_x_[i] = exclude && exclude[i] ? nan : x[i * stride];
+            world_y_[i] = y[i * stride];
+            world_z_[i] = z[i * stride];
+        }
+        if (transform) {
+            transformPoints(world_from_frame, world_x_.data(), world_y_.data(), world_z_.data(), n);
+        }
+        x = world_x_.data();
+        y = world_y_.data();
+        z = world_z_.data();
+        stride = 1;
+    }
+    grid_.build(x, y, z, n, stride, voxel_size);
+    ++generation_;
+
+    // 第一步：按体素并行地查询历史占据，3x3x3 邻域在历史中全空的体素为 NEW；比较期间哈希表只读
+    const size_t num_cells = grid_.numCells();
+    const uint32_t history = config_.history_frames;
+    const bool has_history = table_used_ > 0;
+    auto inWindow = [&](uint32_t seen) { return seen != 0 && generation_ - seen <= history; };
+    cell_label_.resize(num_cells);
+    pool_.parallelFor(num_cells, kCellGrain, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; ++c) {
+            if (!has_history) {
+                cell_label_[c] = static_cast<uint8_t>(ChangeLabel::UNKNOWN);
+                continue;
+            }
+            const int32_t* coord = grid_.cellCoord(static_cast<uint32_t>(c));
+            bool occupied_before = false;
+            for (int32_t dx = -1; dx <= 1 && !occupied_before; ++dx) {
+                for (int32_t dy = -1; dy <= 1 && !occupied_before; ++dy) {
+                    for (int32_t dz = -1; dz <= 1; ++dz) {
+                        if (inWindow(lastSeen(VoxelHashGrid::packKey(coord[0] + dx, coord[1] + dy, coord[2] + dz)))) {
+                            occupied_before = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            cell_label_[c] = static_cast<uint8_t>(occupied_before ? ChangeLabel::STATIC : ChangeLabel::NEW);
+        }
+    });
+
+    // 第二步：并行扫描历史体素，3x3x3 邻域在当前帧全空的为消失体素。
+    // 两个方向都按邻域膨胀后比较，表面在体素边界上的抖动不会被判为变化
+    if (has_history) {
+        vanished_.resize(pool_.size());
+        for (std::vector<int32_t>& list : vanished_) {
+            list.clear();
+        }
+        pool_.parallelFor(table_key_.size(), kSlotGrain, [&](size_t begin, size_t end, size_t worker) {
+            std::vector<int32_t>& list = vanished_[worker];
+            for (size_t slot = begin; slot < end; ++slot) {
+                if (table_key_[slot] == kEmptyKey || !inWindow(table_seen_[slot])) {
+                    continue;
+                }
+                int32_t coord[3];
+                VoxelHashGrid::unpackKey(table_key_[slot], coord);
+                if (!occupiedNear(grid_, coord)) {
+                    list.insert(list.end(), coord, coord + 3);
+                }
+            }
+        });
+
+        // 消失体素2个体素以内、仍为 STATIC 的当前体素标为 VANISHED；消失体素通常很少，串行即可
+        for (const std::vector<int32_t>& list : vanished_) {
+            for (size_t v = 0; v < list.size(); v += 3) {
+                for (int32_t dx = -2; dx <= 2; ++dx) {
+                    for (int32_t dy = -2; dy <= 2; ++dy) {
+                        for (int32_t dz = -2; dz <= 2; ++dz) {
+                            const uint32_t c = grid_.findCell(list[v] + dx, list[v + 1] + dy, list[v + 2] + dz);
+                            if (c != VoxelHashGrid::kInvalidCell &&
+                                cell_label_[c] == static_cast<uint8_t>(ChangeLabel::STATIC)) {
+                                cell_label_[c] = static_cast<uint8_t>(ChangeLabel::VANISHED);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // 第三步：逐点继承体素的标签
+    changed_count_.assign(pool_.size(), 0);
+    pool_.parallelFor(n, kPointGrain, [&](size_t begin, size_t end, size_t worker) {
+        size_t changed = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t cell = grid_.pointCell(i);
+            const uint8_t label = cell == VoxelHashGrid::kInvalidCell
+                                      ? static_cast<uint8_t>(ChangeLabel::UNKNOWN)
+                                      : cell_label_[cell];
+            labels[i] = label;
+            changed += label == static_cast<uint8_t>(ChangeLabel::NEW) ||
+                       label == static_cast<uint8_t>(ChangeLabel::VANISHED);
+        }
+        changed_count_[worker] += changed;
+    });
+
+    // 第四步：当前帧并入历史
+    insertCells();
+
+    size_t changed = 0;
+    for (size_t count : changed_count_) {
+        changed += count;
+    }
+    return changed;
+}
+
+size_t ChangeDetector::apply(const PoseBuffer& poses, PointCloudData& cloud) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled) {
+        return 0;
+    }
+    const size_t n = cloud.point_count;
+    const uint8_t* exclude = nullptr;
+    if (cloud.inlier.size() == n) {
+        exclude_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            exclude_[i] = !cloud.inlier[i];
+        }
+        exclude = exclude_.data();
+    }
+    RigidTransform world_from_frame;
+    if (config_.ego_motion) {
+        poses.interpolate(cloud.frame_timestamp, world_from_frame);
+    }
+    cloud.change.resize(n);
+    return detectLocked(cloud.x.data(), cloud.y.data(), cloud.z.data(), n, 1, world_from_frame, exclude,
+                        cloud.change.data());
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "point_cloud_data.h"
+#include "pose.h"
+#include "thread_pool.h"
+#include "voxel_grid.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 帧间变化检测配置
+ */
+struct ChangeDetectionConfig {
+    bool enabled = false;
+    float voxel_size = 0.2f;        // 占据栅格的体素边长（米）
+    uint32_t history_frames = 1;    // 与之前多少帧的占据并集比较
+    bool ego_motion = true;         // 按帧时间戳的位姿把各帧变换到世界系后比较，false 直接在传感器系比较
+};
+
+/**
+ * @brief 逐点的变化标签
+ */
+enum class ChangeLabel : uint8_t {
+    STATIC = 0,     // 邻域之前有占据，附近也没有消失的体素
+    NEW = 1,        // 3x3x3 邻域在历史帧中都没有占据：新出现的物体
+    VANISHED = 2,   // 2个体素以内有消失的体素（历史中被占据、当前帧3x3x3邻域全空）：物体离开处的边缘
+    UNKNOWN = 3     // NaN点、被排除的点，以及还没有历史帧可比较时的所有点
+};
+
+/**
+ * @brief 基于体素占据的帧间变化检测（动态点提取）
+ *
+ * 跨帧保留一张开放寻址哈希表：体素键 -> 最近一次被占据的帧序号，
+ * 只要体素在最近 history_frames 帧内出现过就视为“之前被占据”。
+ * 新一帧先建体素索引，再按体素并行地查询每个体素的3x3x3邻域，邻域在历史中全空为 NEW；
+ * 同时并行扫描历史体素，当前帧在其3x3x3邻域内全空的为消失体素，消失体素2个体素以内的
+ * 其余体素为 VANISHED，剩下的为 STATIC。两个方向都按邻域膨胀后比较，表面在体素边界上的抖动不算变化。
+ * 体素内的点继承体素的标签，不做逐点的邻域搜索。
+ * 最后把当前帧的体素写入哈希表，过期的体素在表需要扩容或清理时一并丢弃，
+ * 哈希表与体素索引跨帧复用，稳定后不再分配内存。
+ *
+ * 启用 ego_motion 时按帧时间戳从位姿缓冲插值位姿，在世界系下比较，
+ * 车辆自身运动不会让整个场景都被判为变化。
+ */
+class ChangeDetector {
+public:
+    explicit ChangeDetector(ThreadPool& pool = ThreadPool::global());
+
+    /**
+     * @brief 设置配置并清空历史
+     */
+    void setConfig(const ChangeDetectionConfig& config);
+    const ChangeDetectionConfig& config() const { return config_; }
+
+    /**
+     * @brief 清空历史，下一帧的点全部标为 UNKNOWN
+     */
+    void reset();
+
+    /**
+     * @brief 与历史帧比较并标记一帧，随后把该帧并入历史
+     *
+     * @param world_from_frame 该帧到比较坐标系的变换，不做运动补偿时传单位变换
+     * @param exclude 可选，长度n，非0的点不参与比较、也不写入历史
+     * @param labels 输出，长度n，取值为 ChangeLabel
+     * @return 标为 NEW 或 VANISHED 的点数
+     */
+    size_t detect(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                  const RigidTransform& world_from_frame, const uint8_t* exclude, uint8_t* labels);
+
+    /**
+     * @brief 标记一帧点云，写入 cloud.change
+     *
+     * 离群点（掩码模式）不参与比较。启用 ego_motion 时使用 poses 在 cloud.frame_timestamp 的插值位姿。
+     *
+     * @return 标为 NEW 或 VANISHED 的点数，未启用时返回0
+     */
+    size_t apply(const PoseBuffer& poses, PointCloudData& cloud);
+
+private:
+    size_t detectLocked(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                        const RigidTransform& world_from_frame, const uint8_t* exclude, uint8_t* labels);
+    uint32_t lastSeen(uint64_t key) const;
+    void insertCells();
+    void rebuildTable(size_t capacity);
+
+    ChangeDetectionConfig config_;
+    ThreadPool& pool_;
+    std::mutex mutex_;                  // 保护历史与跨帧复用的缓冲
+
+    VoxelHashGrid grid_;                // 当前帧的体素索引
+    std::vector<uint64_t> table_key_;   // 历史占据：体素键
+    std::vector<uint32_t> table_seen_;  // 历史占据：最近一次被占据的帧序号
+    std::vector<uint64_t> spare_key_;   // 重建哈希表时交换用的旧表，复用容量
+    std::vector<uint32_t> spare_seen_;
+    size_t table_used_ = 0;
+    uint32_t generation_ = 0;           // 当前帧序号，从1开始
+    std::vector<uint8_t> cell_label_;   // 当前帧各体素的标签
+    std::vector<std::vector<int32_t>> vanished_;  // 每个工作线程找到的消失体素坐标
+    std::vector<size_t> changed_count_; // 每个工作线程标为变化的点数
+    std::vector<float> world_x_;        // 变换到比较坐标系的坐标副本，被排除的点置为NaN
+    std::vector<float> world_y_;
+    std::vector<float> world_z_;
+    std::vector<uint8_t> exclude_;
+};
+
+} // namespace rs_realtime
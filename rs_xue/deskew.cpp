@@ -0,0 +1,92 @@
+#include "deskew.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rs_realtime {
+
+namespace {
+
+// 单帧最多的时间桶数量，超过时自动加大桶长度
+constexpr size_t kMaxBuckets = 1 << 16;
+
+} // namespace
+
+size_t Deskewer::apply(const PoseBuffer& poses, double ref_time,
+                       float* x, float* y, float* z, const double* timestamp, size_t n) {
+    if (!config_.enabled || n == 0 || poses.size() == 0) {
+        return 0;
+    }
+
+    // 确定帧内时间范围
+    double t_min = timestamp[0];
+    double t_max = timestamp[0];
+    for (size_t i = 1; i < n; ++i) {
+        t_min = std::min(t_min, timestamp[i]);
+        t_max = std::max(t_max, timestamp[i]);
+    }
+    if (!std::isfinite(t_min) || !std::isfinite(t_max)) {
+        return 0;
+    }
+
+    double bucket_s = std::max(config_.bucket_us, 1.0) * 1e-6;
+    size_t num_buckets = static_cast<size_t>((t_max - t_min) / bucket_s) + 1;
+    if (num_buckets > kMaxBuckets) {
+        bucket_s = (t_max - t_min) / static_cast<double>(kMaxBuckets - 1);
+        num_buckets = kMaxBuckets;
+    }
+    const double inv_bucket = 1.0 / bucket_s;
+
+    // 每个桶取中心时刻插值一次，参考时刻放在末尾一并查询
+    bucket_time_.resize(num_buckets + 1);
+    bucket_transform_.resize(num_buckets + 1);
+    bucket_in_range_.resize(num_buckets + 1);
+    for (size_t b = 0; b < num_buckets; ++b) {
+        bucket_time_[b] = std::min(t_min + (static_cast<double>(b) + 0.5) * bucket_s, t_max);
+    }
+    bucket_time_[num_buckets] = ref_time;
+    poses.interpolate(bucket_time_.data(), num_buckets + 1,
+                      bucket_transform_.data(), bucket_in_range_.data());
+
+    // 预先合成 T(t_ref)^-1 * T(t_b)
+    const RigidTransform ref_inv = bucket_transform_[num_buckets].inverse();
+    for (size_t b = 0; b < num_buckets; ++b) {
+        bucket_transform_[b] = ref_inv * bucket_transform_[b];
+    }
+
+    // 计算每个点所在的桶
+    bucket_index_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const size_t b = static_cast<size_t>((timestamp[i] - t_min) * inv_bucket);
+        bucket_index_[i] = static_cast<uint32_t>(std::min(b, num_buckets - 1));
+    }
+
+    // 按扫描顺序找出同一桶的连续段，每段一次向量化变换
+    size_t corrected = 0;
+    size_t begin = 0;
+    while (begin < n) {
+        const uint32_t b = bucket_index_[begin];
+        size_t end = begin + 1;
+        while (end < n && bucket_index_[end] == b) {
+            ++end;
+        }
+        transformPoints(bucket_transform_[b], x + begin, y + begin, z + begin, end - begin);
+        if (bucket_in_range_[b]) {
+            corrected += end - begin;
+        }
+        begin = end;
+    }
+    return corrected;
+}
+
+size_t Deskewer::apply(const PoseBuffer& poses, PointCloudData& cloud) {
+    if (cloud.timestamp.size() < cloud.point_count) {
+        // 点类型或字段配置不含逐点时间戳
+        return 0;
+    }
+    return apply(poses, cloud.frame_timestamp,
+                 cloud.x.data(), cloud.y.data(), cloud.z.data(),
+                 cloud.timestamp.data(), cloud.point_count);
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "point_cloud_data.h"
+#include "pose.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 运动补偿配置
+ */
+struct DeskewConfig {
+    bool enabled = false;        // 是否启用运动补偿
+    double bucket_us = 1000.0;   // 时间桶长度（微秒），同一桶内的点共用一次位姿插值
+};
+
+/**
+ * @brief 基于逐点时间戳和位姿流的运动补偿（去畸变）
+ *
+ * 将一帧内每个点从其采样时刻的载体坐标系变换到帧参考时刻的坐标系：
+ * p_ref = T(t_ref)^-1 * T(t_i) * p_i。
+ * 帧内时间按 bucket_us 分桶，每个桶只做一次SE(3)插值，
+ * 扫描顺序上连续落在同一桶内的点作为一段，用向量化的变换内核处理。
+ *
+ * 位姿描述的是输出（标定后）坐标系在世界系下的位姿，因此运动补偿在标定之后进行。
+ */
+class Deskewer {
+public:
+    Deskewer() = default;
+
+    void setConfig(const DeskewConfig& config) { config_ = config; }
+    const DeskewConfig& config() const { return config_; }
+
+    /**
+     * @brief 对SoA坐标原地做运动补偿
+     *
+     * @param poses 位姿缓冲区
+     * @param ref_time 参考时刻，补偿后的点位于该时刻的坐标系
+     * @return 位姿覆盖范围内的点数；未启用或没有位姿时返回0且不修改数据
+     */
+    size_t apply(const PoseBuffer& poses, double ref_time,
+                 float* x, float* y, float* z, const double* timestamp, size_t n);
+
+    /**
+     * @brief 对一帧点云做运动补偿，参考时刻取帧时间戳
+     */
+    size_t apply(const PoseBuffer& poses, PointCloudData& cloud);
+
+private:
+    DeskewConfig config_;
+
+    // 跨帧复用的临时缓冲
+    std::vector<uint32_t> bucket_index_;
+    std::vector<double> bucket_time_;
+    std::vector<RigidTransform> bucket_transform_;
+    std::vector<uint8_t> bucket_in_range_;
+};
+
+} // namespace rs_realtime
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace rs_realtime {
+
+/**
+ * @brief 3x3对称矩阵的闭式特征分解（三角函数法）
+ *
+ * 协方差按 (xx, xy, xz, yy, yz, zz) 顺序给出。输出升序排列的特征值，
+ * 以及最小特征值对应的单位特征向量（平面法向）。
+ * 无分支迭代、无动态内存，适合在逐点/逐块的热循环中内联调用。
+ */
+inline void eigenSymmetric3(const float cov[6], float eigenvalues[3], float normal[3]) {
+    const float a00 = cov[0], a01 = cov[1], a02 = cov[2];
+    const float a11 = cov[3], a12 = cov[4], a22 = cov[5];
+
+    const float p1 = a01 * a01 + a02 * a02 + a12 * a12;
+    const float q = (a00 + a11 + a22) / 3.f;
+    float e_min, e_mid, e_max;
+    if (p1 <= 1e-20f) {
+        // 已是对角阵
+        e_min = std::min(a00, std::min(a11, a22));
+        e_max = std::max(a00, std::max(a11, a22));
+        e_mid = a00 + a11 + a22 - e_min - e_max;
+    } else {
+        const float d0 = a00 - q, d1 = a11 - q, d2 = a22 - q;
+        const float p2 = d0 * d0 + d1 * d1 + d2 * d2 + 2.f * p1;
+        const float p = std::sqrt(p2 / 6.f);
+        const float inv_p = 1.f / p;
+        // B = (A - qI) / p，r = det(B) / 2
+        const float b00 = d0 * inv_p, b11 = d1 * inv_p, b22 = d2 * inv_p;
+        const float b01 = a01 * inv_p, b02 = a02 * inv_p, b12 = a12 * inv_p;
+        float r = 0.5f * (b00 * (b11 * b22 - b12 * b12) -
+                          b01 * (b01 * b22 - b12 * b02) +
+                          b02 * (b01 * b12 - b11 * b02));
+        r = std::max(-1.f, std::min(1.f, r));
+        const float phi = std::acos(r) / 3.f;
+        e_max = q + 2.f * p * std::cos(phi);
+        e_min = q + 2.f * p * std::cos(phi + 2.0943951f);  // + 2π/3
+        e_mid = 3.f * q - e_max - e_min;
+    }
+    eigenvalues[0] = e_min;
+    eigenvalues[1] = e_mid;
+    eigenvalues[2] = e_max;
+
+    // (A - λI) 的任意两行叉乘即为特征向量，取模最大的一组保证数值稳定
+    const float r0[3] = {a00 - e_min, a01, a02};
+    const float r1[3] = {a01, a11 - e_min, a12};
+    const float r2[3] = {a02, a12, a22 - e_min};
+    const float c01[3] = {r0[1] * r1[2] - r0[2] * r1[1], r0[2] * r1[0] - r0[0] * r1[2], r0[0] * r1[1] - r0[1] * r1[0]};
+    const float c02[3] = {r0[1] * r2[2] - r0[2] * r2[1], r0[2] * r2[0] - r0[0] * r2[2], r0[0] * r2[1] - r0[1] * r2[0]};
+    const float c12[3] = {r1[1] * r2[2] - r1[2] * r2[1], r1[2] * r2[0] - r1[0] * r2[2], r1[0] * r2[1] - r1[1] * r2[0]};
+    const float n01 = c01[0] * c01[0] + c01[1] * c01[1] + c01[2] * c01[2];
+    const float n02 = c02[0] * c02[0] + c02[1] * c02[1] + c02[2] * c02[2];
+    const float n12 = c12[0] * c12[0] + c12[1] * c12[1] + c12[2] * c12[2];
+    const float* best = c01;
+    float best_norm = n01;
+    if (n02 > best_norm) {
+        best = c02;
+        best_norm = n02;
+    }
+    if (n12 > best_norm) {
+        best = c12;
+        best_norm = n12;
+    }
+    if (best_norm <= 1e-30f) {
+        // 最小特征值重根（各向同性），法向不确定，取z轴
+        normal[0] = 0.f;
+        normal[1] = 0.f;
+        normal[2] = 1.f;
+        return;
+    }
+    const float inv_norm = 1.f / std::sqrt(best_norm);
+    normal[0] = best[0] * inv_norm;
+    normal[1] = best[1] * inv_norm;
+    normal[2] = best[2] * inv_norm;
+}
+
+/**
+ * @brief 批量求解n个3x3对称阵的最小特征值及其单位特征向量
+ *
+ * 六个分量各存一列（SoA）。算法与 eigenSymmetric3 相同，但 acos、cos、sin 换成多项式近似，
+ * 分支换成选择，循环体可被编译器向量化（SSE/AVX下一次处理4/8个矩阵，
+ * 需要 -fno-math-errno -fno-trapping-math，rs_xue_kernels 已统一设置）；
+ * 多项式的截断误差在1e-7量级，与单精度舍入相当。最小特征值重根（法向不确定）时输出z轴。
+ */
+inline void eigenSymmetric3Batch(const float* __restrict xx, const float* __restrict xy, const float* __restrict xz,
+                                 const float* __restrict yy, const float* __restrict yz, const float* __restrict zz,
+                                 size_t n, float* __restrict lambda_min,
+                                 float* __restrict nx, float* __restrict ny, float* __restrict nz) {
+    for (size_t i = 0; i < n; ++i) {
+        const float a00 = xx[i], a01 = xy[i], a02 = xz[i];
+        const float a11 = yy[i], a12 = yz[i], a22 = zz[i];
+
+        const float p1 = a01 * a01 + a02 * a02 + a12 * a12;
+        const float q = (a00 + a11 + a22) * (1.f / 3.f);
+        const float d0 = a00 - q, d1 = a11 - q, d2 = a22 - q;
+        const float p = std::sqrt((d0 * d0 + d1 * d1 + d2 * d2 + 2.f * p1) * (1.f / 6.f));
+        // 各向同性（p为0）时 B 的各项均为0，最小特征值退化为q
+        const float inv_p = 1.f / (p + 1e-30f);
+        const float b00 = d0 * inv_p, b11 = d1 * inv_p, b22 = d2 * inv_p;
+        const float b01 = a01 * inv_p, b02 = a02 * inv_p, b12 = a12 * inv_p;
+        float r = 0.5f * (b00 * (b11 * b22 - b12 * b12) -
+                          b01 * (b01 * b22 - b12 * b02) +
+                          b02 * (b01 * b12 - b11 * b02));
+        r = std::max(-1.f, std::min(1.f, r));
+
+        // acos(|r|) = sqrt(1 - |r|) * P(|r|)（Abramowitz & Stegun 4.4.46，误差2e-8），r<0时取 π - acos(|r|)
+        const float t = std::fabs(r);
+        float acos_t = -0.0012624911f;
+        acos_t = acos_t * t + 0.0066700901f;
+        acos_t = acos_t * t - 0.0170881256f;
+        acos_t = acos_t * t + 0.0308918810f;
+        acos_t = acos_t * t - 0.0501743046f;
+        acos_t = acos_t * t + 0.0889789874f;
+        acos_t = acos_t * t - 0.2145988016f;
+        acos_t = acos_t * t + 1.5707963050f;
+        acos_t *= std::sqrt(1.f - t);
+        const float phi = (r < 0.f ? 3.14159265f - acos_t : acos_t) * (1.f / 3.f);
+
+        // phi 位于 [0, π/3]，泰勒展开到12阶/13阶即可
+        const float phi2 = phi * phi;
+        const float cos_phi =
+            1.f + phi2 * (-1.f / 2 + phi2 * (1.f / 24 + phi2 * (-1.f / 720 + phi2 * (1.f / 40320 + phi2 * (-1.f / 3628800)))));
+        const float sin_phi =
+            phi * (1.f + phi2 * (-1.f / 6 + phi2 * (1.f / 120 + phi2 * (-1.f / 5040 + phi2 * (1.f / 362880 + phi2 * (-1.f / 39916800))))));
+        // cos(phi + 2π/3) = -cos(phi)/2 - sin(phi)·√3/2
+        const float e_min = q - p * (cos_phi + 1.7320508f * sin_phi);
+        lambda_min[i] = e_min;
+
+        // 与 eigenSymmetric3 相同：取 (A - λI) 两行叉乘中模最大的一组
+        const float r00 = a00 - e_min, r11 = a11 - e_min, r22 = a22 - e_min;
+        const float c01x = a01 * a12 - a02 * r11, c01y = a02 * a01 - r00 * a12, c01z = r00 * r11 - a01 * a01;
+        const float c02x = a01 * r22 - a02 * a12, c02y = a02 * a02 - r00 * r22, c02z = r00 * a12 - a01 * a02;
+        const float c12x = r11 * r22 - a12 * a12, c12y = a12 * a02 - a01 * r22, c12z = a01 * a12 - r11 * a02;
+        const float n01 = c01x * c01x + c01y * c01y + c01z * c01z;
+        const float n02 = c02x * c02x + c02y * c02y + c02z * c02z;
+        const float n12 = c12x * c12x + c12y * c12y + c12z * c12z;
+        const bool pick02 = n02 > n01;
+        float bx = pick02 ? c02x : c01x;
+        float by = pick02 ? c02y : c01y;
+        float bz = pick02 ? c02z : c01z;
+        float best = pick02 ? n02 : n01;
+        const bool pick12 = n12 > best;
+        bx = pick12 ? c12x : bx;
+        by = pick12 ? c12y : by;
+        bz = pick12 ? c12z : bz;
+        best = pick12 ? n12 : best;
+        const float valid = best > 1e-30f ? 1.f : 0.f;
+        const float inv_norm = valid / std::sqrt(best + 1e-30f);
+        nx[i] = bx * inv_norm;
+        ny[i] = by * inv_norm;
+        nz[i] = bz * inv_norm + (1.f - valid);
+    }
+}
+
+} // namespace rs_realtime
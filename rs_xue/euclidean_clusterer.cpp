@@ -0,0 +1,266 @@
+#include "euclidean_clusterer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace rs_realtime {
+
+namespace {
+
+// 每个任务块处理的体素数
+constexpr size_t kCellGrain = 256;
+// 每个任务块写标签的点数
+constexpr size_t kPointGrain = 16384;
+
+struct CellOffset {
+    int32_t dx;
+    int32_t dy;
+    int32_t dz;
+};
+
+// 5x5x5 邻域中字典序为正的一半偏移（62个），体素边长为 tolerance/√3 时距离不超过 tolerance 的点最远相隔2个体素
+const std::vector<CellOffset>& halfNeighborhood() {
+    static const std::vector<CellOffset> offsets = [] {
+        std::vector<CellOffset> result;
+        for (int32_t dx = -2; dx <= 2; ++dx) {
+            for (int32_t dy = -2; dy <= 2; ++dy) {
+                for (int32_t dz = -2; dz <= 2; ++dz) {
+                    if (dx > 0 || (dx == 0 && (dy > 0 || (dy == 0 && dz > 0)))) {
+                        result.push_back({dx, dy, dz});
+                    }
+                }
+            }
+        }
+        return result;
+    }();
+    return offsets;
+}
+
+// 点到体素 (cx, cy, cz) 包围盒的最小距离平方
+inline float cellDistance2(const int32_t* cell, float size, float px, float py, float pz) {
+    auto axis = [size](int32_t c, float p) {
+        const float lo = static_cast<float>(c) * size;
+        const float d = p < lo ? lo - p : (p > lo + size ? p - lo - size : 0.f);
+        return d * d;
+    };
+    return axis(cell[0], px) + axis(cell[1], py) + axis(cell[2], pz);
+}
+
+} // namespace
+
+EuclideanClusterer::EuclideanClusterer(ThreadPool& pool)
+    : pool_(pool) {
+}
+
+uint32_t EuclideanClusterer::findRoot(uint32_t c) {
+    while (true) {
+        uint32_t parent = parent_[c].load(std::memory_order_relaxed);
+        if (parent == c) {
+            return c;
+        }
+        // 路径减半：把c直接挂到祖父节点，失败说明别的线程已经改过，不影响正确性
+        const uint32_t grandparent = parent_[parent].load(std::memory_order_relaxed);
+        if (grandparent != parent) {
+            parent_[c].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+        }
+        c = grandparent;
+    }
+}
+
+void EuclideanClusterer::unite(uint32_t a, uint32_t b) {
+    while (true) {
+        a = findRoot(a);
+        b = findRoot(b);
+        if (a == b) {
+            return;
+        }
+        // 编号大的根挂到编号小的根下，父指针只会减小，不会成环
+        if (a < b) {
+            std::swap(a, b);
+        }
+        uint32_t expected = a;
+        if (parent_[a].compare_exchange_weak(expected, b, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+bool EuclideanClusterer::cellsTouch(uint32_t a, uint32_t b, float tolerance2) const {
+    // 外层遍历点数少的体素
+    if (grid_.cellEnd(a) - grid_.cellBegin(a) > grid_.cellEnd(b) - grid_.cellBegin(b)) {
+        std::swap(a, b);
+    }
+    const float* sx = grid_.sortedX();
+    const float* sy = grid_.sortedY();
+    const float* sz = grid_.sortedZ();
+    const int32_t* cell_b = grid_.cellCoord(b);
+    const float size = grid_.cellSize();
+    const uint32_t b_begin = grid_.cellBegin(b);
+    const uint32_t b_end = grid_.cellEnd(b);
+    for (uint32_t p = grid_.cellBegin(a); p < grid_.cellEnd(a); ++p) {
+        const float px = sx[p];
+        const float py = sy[p];
+        const float pz = sz[p];
+        if (cellDistance2(cell_b, size, px, py, pz) > tolerance2) {
+            continue;
+        }
+        for (uint32_t q = b_begin; q < b_end; ++q) {
+            const float dx = sx[q] - px;
+            const float dy = sy[q] - py;
+            const float dz = sz[q] - pz;
+            if (dx * dx + dy * dy + dz * dz <= tolerance2) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+size_t EuclideanClusterer::cluster(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                   const uint8_t* exclude, int32_t* labels, FrameClusters& clusters) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return clusterLocked(x, y, z, n, stride, exclude, labels, clusters);
+}
+
+size_t EuclideanClusterer::clusterLocked(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                         const uint8_t* exclude, int32_t* labels, FrameClusters& clusters) {
+    const float tolerance = std::max(config_.tolerance, 1e-3f);
+    const float tolerance2 = tolerance * tolerance;
+
+    // 被排除的点置为NaN，体素索引会跳过它们
+    if (exclude) {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        masked_x_.resize(n);
+        masked_y_.resize(n);
+        masked_z_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            masked_x_[i] = exclude[i] ? nan : x[i * stride];
+            masked_y_[i] = y[i * stride];
+            masked_z_[i] = z[i * stride];
+        }
+        x = masked_x_.data();
+        y = masked_y_.data();
+        z = masked_z_.data();
+        stride = 1;
+    }
+    grid_.build(x, y, z, n, stride, tolerance / std::sqrt(3.f));
+
+    // 第一步：相邻体素之间并行合并
+    const size_t num_cells = grid_.numCells();
+    if (parent_capacity_ < num_cells) {
+        parent_.reset(new std::atomic<uint32_t>[num_cells]);
+        parent_capacity_ = num_cells;
+    }
+    for (size_t c = 0; c < num_cells; ++c) {
+        parent_[c].store(static_cast<uint32_t>(c), std::memory_order_relaxed);
+    }
+    const std::vector<CellOffset>& offsets = halfNeighborhood();
+    pool_.parallelFor(num_cells, kCellGrain, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; ++c) {
+            const uint32_t cell = static_cast<uint32_t>(c);
+            const int32_t* coord = grid_.cellCoord(cell);
+            for (const CellOffset& offset : offsets) {
+                const uint32_t other = grid_.findCell(coord[0] + offset.dx, coord[1] + offset.dy, coord[2] + offset.dz);
+                if (other == VoxelHashGrid::kInvalidCell || findRoot(cell) == findRoot(other)) {
+                    continue;
+                }
+                if (cellsTouch(cell, other, tolerance2)) {
+                    unite(cell, other);
+                }
+            }
+        }
+    });
+
+    // 第二步：统计各集合的点数；根总是集合中编号最小的体素，按编号顺序遍历时先遇到根
+    cell_root_.resize(num_cells);
+    root_count_.assign(num_cells, 0);
+    root_label_.assign(num_cells, -1);
+    for (size_t c = 0; c < num_cells; ++c) {
+        const uint32_t root = findRoot(static_cast<uint32_t>(c));
+        cell_root_[c] = root;
+        root_count_[root] += grid_.cellEnd(static_cast<uint32_t>(c)) - grid_.cellBegin(static_cast<uint32_t>(c));
+    }
+    int32_t num_clusters = 0;
+    for (size_t c = 0; c < num_cells; ++c) {
+        if (cell_root_[c] != c) {
+            continue;
+        }
+        const uint32_t count = root_count_[c];
+        if (count >= config_.min_points && (config_.max_points == 0 || count <= config_.max_points)) {
+            root_label_[c] = num_clusters++;
+        }
+    }
+
+    // 第三步：逐点标签
+    pool_.parallelFor(n, kPointGrain, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t cell = grid_.pointCell(i);
+            labels[i] = cell == VoxelHashGrid::kInvalidCell ? -1 : root_label_[cell_root_[cell]];
+        }
+    });
+
+    // 第四步：各簇的点数、质心与包围盒，质心用双精度累加
+    const size_t k = static_cast<size_t>(num_clusters);
+    clusters.count.assign(k, 0);
+    clusters.centroid.assign(k * 3, 0.f);
+    clusters.min.assign(k * 3, std::numeric_limits<float>::infinity());
+    clusters.max.assign(k * 3, -std::numeric_limits<float>::infinity());
+    centroid_sum_.assign(k * 3, 0.0);
+    const float* sx = grid_.sortedX();
+    const float* sy = grid_.sortedY();
+    const float* sz = grid_.sortedZ();
+    for (size_t c = 0; c < num_cells; ++c) {
+        const int32_t label = root_label_[cell_root_[c]];
+        if (label < 0) {
+            continue;
+        }
+        float* lo = &clusters.min[label * 3];
+        float* hi = &clusters.max[label * 3];
+        double* sum = &centroid_sum_[label * 3];
+        const uint32_t begin = grid_.cellBegin(static_cast<uint32_t>(c));
+        const uint32_t end = grid_.cellEnd(static_cast<uint32_t>(c));
+        for (uint32_t pos = begin; pos < end; ++pos) {
+            lo[0] = std::min(lo[0], sx[pos]);
+            lo[1] = std::min(lo[1], sy[pos]);
+            lo[2] = std::min(lo[2], sz[pos]);
+            hi[0] = std::max(hi[0], sx[pos]);
+            hi[1] = std::max(hi[1], sy[pos]);
+            hi[2] = std::max(hi[2], sz[pos]);
+            sum[0] += sx[pos];
+            sum[1] += sy[pos];
+            sum[2] += sz[pos];
+        }
+        clusters.count[label] += end - begin;
+    }
+    for (size_t j = 0; j < k; ++j) {
+        const double inv = 1.0 / static_cast<double>(clusters.count[j]);
+        for (size_t d = 0; d < 3; ++d) {
+            clusters.centroid[j * 3 + d] = static_cast<float>(centroid_sum_[j * 3 + d] * inv);
+        }
+    }
+    return k;
+}
+
+size_t EuclideanClusterer::apply(PointCloudData& cloud) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled) {
+        return 0;
+    }
+    const size_t n = cloud.point_count;
+    const bool mask_outliers = cloud.inlier.size() == n;
+    const bool mask_ground = config_.skip_ground && cloud.ground.size() == n;
+    const uint8_t* exclude = nullptr;
+    if (mask_outliers || mask_ground) {
+        exclude_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            exclude_[i] = (mask_outliers && !cloud.inlier[i]) || (mask_ground && cloud.ground[i]);
+        }
+        exclude = exclude_.data();
+    }
+    cloud.cluster.resize(n);
+    return clusterLocked(cloud.x.data(), cloud.y.data(), cloud.z.data(), n, 1, exclude,
+                         cloud.cluster.data(), cloud.clusters);
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "point_cloud_data.h"
+#include "thread_pool.h"
+#include "voxel_grid.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 欧氏聚类配置
+ */
+struct ClusteringConfig {
+    bool enabled = false;
+    float tolerance = 0.5f;         // 距离不超过该值的两点属于同一簇（米）
+    uint32_t min_points = 10;       // 点数少于该值的簇标为噪声（-1）
+    uint32_t max_points = 0;        // 点数多于该值的簇标为噪声，0表示不限制
+    bool skip_ground = true;        // 有地面标签时地面点不参与聚类
+};
+
+/**
+ * @brief 基于体素连通与并查集的并行欧氏聚类
+ *
+ * 体素边长取 tolerance/√3，同一体素内任意两点的距离都不超过 tolerance，
+ * 因而直接以体素为并查集的节点。每个体素只检查 5x5x5 邻域中偏移字典序为正的一半，
+ * 每对相邻体素只比较一次；两体素已属同一集合时跳过，否则逐点检查是否存在距离不超过
+ * tolerance 的点对（先按点到体素包围盒的距离剪枝）。结果与 min_samples=1 的 DBSCAN（单链接）一致。
+ *
+ * 按体素并行，并查集用CAS无锁合并（总是把编号大的根挂到编号小的根下，查找时路径减半），
+ * 合并顺序不影响结果；簇标签按各簇最小体素的编号顺序分配，同一输入的输出是确定的。
+ * NaN点与被排除的点标签为-1。
+ */
+class EuclideanClusterer {
+public:
+    explicit EuclideanClusterer(ThreadPool& pool = ThreadPool::global());
+
+    void setConfig(const ClusteringConfig& config) { config_ = config; }
+    const ClusteringConfig& config() const { return config_; }
+
+    /**
+     * @brief 聚类
+     *
+     * @param exclude 可选，长度n，非0的点不参与聚类
+     * @param labels 输出，长度n，簇标签从0开始，噪声与未参与的点为-1
+     * @param clusters 输出各簇的点数、质心与包围盒
+     * @return 簇的数量
+     */
+    size_t cluster(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                   const uint8_t* exclude, int32_t* labels, FrameClusters& clusters);
+
+    /**
+     * @brief 对一帧点云聚类，标签写入 cloud.cluster、汇总写入 cloud.clusters
+     *
+     * 带离群点掩码时离群点不参与聚类，skip_ground 且带地面标签时地面点不参与聚类。
+     *
+     * @return 簇的数量，未启用时返回0
+     */
+    size_t apply(PointCloudData& cloud);
+
+private:
+    size_t clusterLocked(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                         const uint8_t* exclude, int32_t* labels, FrameClusters& clusters);
+    uint32_t findRoot(uint32_t c);
+    void unite(uint32_t a, uint32_t b);
+    bool cellsTouch(uint32_t a, uint32_t b, float tolerance2) const;
+
+    ClusteringConfig config_;
+    ThreadPool& pool_;
+    std::mutex mutex_;                  // 保护跨帧复用的缓冲
+
+    VoxelHashGrid grid_;
+    std::unique_ptr<std::atomic<uint32_t>[]> parent_;   // 体素并查集
+    size_t parent_capacity_ = 0;
+    std::vector<uint32_t> cell_root_;
+    std::vector<uint32_t> root_count_;
+    std::vector<int32_t> root_label_;
+    std::vector<float> masked_x_;       // 有排除点时的坐标副本，被排除的点置为NaN
+    std::vector<float> masked_y_;
+    std::vector<float> masked_z_;
+    std::vector<uint8_t> exclude_;
+    std::vector<double> centroid_sum_;
+};
+
+} // namespace rs_realtime
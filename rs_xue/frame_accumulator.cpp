@@ -0,0 +1,351 @@
+#include "frame_accumulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "voxel_grid.h"
+
+namespace rs_realtime {
+
+namespace {
+
+// 体素键只用低63位，全1不会与有效键冲突
+constexpr uint64_t kEmptyKey = ~0ull;
+constexpr size_t kMinTableSize = 1024;
+constexpr size_t kInsertBlock = 32;     // 插入哈希表时一次预取的点数
+
+bool sameTransform(const RigidTransform& a, const RigidTransform& b) {
+    // 同一版本的位姿缓冲对同一时刻的插值结果逐位相同，直接比较即可
+    return a.R == b.R && a.t == b.t;
+}
+
+} // namespace
+
+void FrameAccumulator::setConfig(const AccumulatorConfig& config) {
+    config_ = config;
+    config_.max_frames = std::max<uint32_t>(config_.max_frames, 1);
+    inv_voxel_size_ = config_.voxel_size > 0.f ? 1.f / config_.voxel_size : 0.f;
+    slots_.assign(config_.max_frames, Slot());
+    clear();
+}
+
+void FrameAccumulator::clear() {
+    first_slot_ = 0;
+    num_slots_ = 0;
+    head_ = 0;
+    tail_ = 0;
+    live_points_ = 0;
+    pose_version_ = 0;
+    std::fill(table_key_.begin(), table_key_.end(), kEmptyKey);
+    table_used_ = 0;
+    stats_ = AccumulatorStats();
+}
+
+void FrameAccumulator::reserve(size_t max_points) {
+    // 缓冲取两倍窗口，存活区间大约每过一个窗口才需要搬回开头一次
+    const size_t capacity = 2 * static_cast<size_t>(config_.max_frames) * max_points;
+    if (x_.size() < capacity) {
+        // resize 会写零，页面在预留时就已缺页
+        x_.resize(capacity);
+        y_.resize(capacity);
+        z_.resize(capacity);
+        intensity_.resize(capacity);
+        alive_.resize(capacity);
+    }
+    if (config_.voxel_size > 0.f && table_key_.size() < capacity) {
+        rebuildTable(capacity);
+    }
+}
+
+uint32_t FrameAccumulator::latestFrameId() const {
+    return num_slots_ > 0 ? slotAt(num_slots_ - 1).frame_id : 0;
+}
+
+double FrameAccumulator::latestTimestamp() const {
+    return num_slots_ > 0 ? slotAt(num_slots_ - 1).timestamp : 0.0;
+}
+
+void FrameAccumulator::popFront() {
+    const Slot& slot = slotAt(0);
+    if (config_.voxel_size > 0.f) {
+        size_t alive = 0;
+        for (size_t i = slot.begin; i < slot.end; ++i) {
+            alive += alive_[i];
+        }
+        live_points_ -= alive;
+    } else {
+        live_points_ -= slot.end - slot.begin;
+    }
+    head_ = slot.end;
+    first_slot_ = (first_slot_ + 1) % slots_.size();
+    --num_slots_;
+    if (num_slots_ == 0) {
+        head_ = 0;
+        tail_ = 0;
+    }
+}
+
+void FrameAccumulator::compact() {
+    if (head_ == 0) {
+        return;
+    }
+    std::copy(x_.begin() + head_, x_.begin() + tail_, x_.begin());
+    std::copy(y_.begin() + head_, y_.begin() + tail_, y_.begin());
+    std::copy(z_.begin() + head_, z_.begin() + tail_, z_.begin());
+    std::copy(intensity_.begin() + head_, intensity_.begin() + tail_, intensity_.begin());
+    std::copy(alive_.begin() + head_, alive_.begin() + tail_, alive_.begin());
+    for (size_t i = 0; i < num_slots_; ++i) {
+        Slot& slot = slotAt(i);
+        slot.begin -= head_;
+        slot.end -= head_;
+    }
+    tail_ -= head_;
+    head_ = 0;
+    ++stats_.compactions;
+    // 下标整体变化，哈希表需要重建
+    if (config_.voxel_size > 0.f) {
+        rebuildTable(2 * live_points_);
+    }
+}
+
+void FrameAccumulator::ensureCapacity(size_t n) {
+    if (tail_ + n <= x_.size()) {
+        return;
+    }
+    compact();
+    if (tail_ + n <= x_.size()) {
+        return;
+    }
+    const size_t capacity = std::max(tail_ + n, 2 * x_.size());
+    x_.resize(capacity);
+    y_.resize(capacity);
+    z_.resize(capacity);
+    intensity_.resize(capacity);
+    alive_.resize(capacity);
+}
+
+uint64_t FrameAccumulator::voxelKey(size_t index) const {
+    return VoxelHashGrid::packKey(static_cast<int32_t>(std::floor(x_[index] * inv_voxel_size_)),
+                                  static_cast<int32_t>(std::floor(y_[index] * inv_voxel_size_)),
+                                  static_cast<int32_t>(std::floor(z_[index] * inv_voxel_size_)));
+}
+
+void FrameAccumulator::insertRange(size_t begin, size_t end) {
+    const uint64_t mask = table_key_.size() - 1;
+    uint64_t keys[kInsertBlock];
+    uint64_t home[kInsertBlock];
+    for (size_t block = begin; block < end; block += kInsertBlock) {
+        const size_t count = std::min(kInsertBlock, end - block);
+        // 先算出整块的键与起始槽位并预取，哈希表的随机访问不再逐个等待缓存未命中
+        for (size_t k = 0; k < count; ++k) {
+            keys[k] = voxelKey(block + k);
+            home[k] = VoxelHashGrid::hashKey(keys[k]) & mask;
+            __builtin_prefetch(&table_key_[home[k]]);
+            __builtin_prefetch(&table_index_[home[k]]);
+        }
+        for (size_t k = 0; k < count; ++k) {
+            const size_t i = block + k;
+            if (!alive_[i]) {
+                continue;
+            }
+            const uint64_t key = keys[k];
+            uint64_t slot = home[k];
+            while (table_key_[slot] != kEmptyKey && table_key_[slot] != key) {
+                slot = (slot + 1) & mask;
+            }
+            if (table_key_[slot] == kEmptyKey) {
+                table_key_[slot] = key;
+                table_index_[slot] = static_cast<uint32_t>(i);
+                ++table_used_;
+                continue;
+            }
+            // 条目指向的点已移出窗口、已失效或已被重新变换到别的体素时视为过期，直接覆盖
+            const size_t other = table_index_[slot];
+            if (other != i && other >= head_ && other < tail_ && alive_[other] && voxelKey(other) == key) {
+                // 缓冲按到达顺序排列，下标大的点更新
+                if (other > i) {
+                    alive_[i] = 0;
+                    --live_points_;
+                    continue;
+                }
+                alive_[other] = 0;
+                --live_points_;
+            }
+            table_index_[slot] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+void FrameAccumulator::reserveTable(size_t n) {
+    // 过期条目也占用槽位，装载因子超过0.5时按存活点重建
+    if (table_key_.empty() || (table_used_ + n) * 2 > table_key_.size()) {
+        rebuildTable(2 * (live_points_ + n));
+    }
+}
+
+void FrameAccumulator::rebuildTable(size_t capacity) {
+    size_t size = kMinTableSize;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    size = std::max(size, table_key_.size());
+    table_key_.assign(size, kEmptyKey);
+    table_index_.resize(size);
+    table_used_ = 0;
+    insertRange(head_, tail_);
+}
+
+size_t FrameAccumulator::refreshPoses(const PoseBuffer& poses) {
+    const uint64_t version = poses.version();
+    if (version == pose_version_) {
+        return 0;
+    }
+    pose_version_ = version;
+    if (num_slots_ == 0) {
+        return 0;
+    }
+
+    // 一次加锁插值所有帧的位姿
+    slot_time_.resize(num_slots_);
+    slot_transform_.resize(num_slots_);
+    for (size_t i = 0; i < num_slots_; ++i) {
+        slot_time_[i] = slotAt(i).timestamp;
+    }
+    poses.interpolate(slot_time_.data(), num_slots_, slot_transform_.data());
+
+    size_t changed = 0;
+    for (size_t i = 0; i < num_slots_; ++i) {
+        Slot& slot = slotAt(i);
+        const RigidTransform& world_from_frame = slot_transform_[i];
+        if (sameTransform(world_from_frame, slot.world_from_frame)) {
+            continue;
+        }
+        const RigidTransform delta = world_from_frame * slot.world_from_frame.inverse();
+        transformPoints(delta, x_.data() + slot.begin, y_.data() + slot.begin, z_.data() + slot.begin,
+                        slot.end - slot.begin);
+        slot.world_from_frame = world_from_frame;
+        if (config_.voxel_size > 0.f) {
+            reserveTable(slot.end - slot.begin);
+            insertRange(slot.begin, slot.end);
+        }
+        ++changed;
+    }
+    stats_.frames_retransformed += changed;
+    return changed;
+}
+
+size_t FrameAccumulator::add(const PoseBuffer& poses, const PointCloudData& cloud) {
+    if (slots_.empty()) {
+        setConfig(config_);
+    }
+    refreshPoses(poses);
+
+    while (num_slots_ >= config_.max_frames) {
+        popFront();
+    }
+
+    const size_t n = cloud.point_count;
+    ensureCapacity(n);
+
+    RigidTransform world_from_frame;
+    poses.interpolate(cloud.frame_timestamp, world_from_frame);
+    const float r0 = world_from_frame.R[0], r1 = world_from_frame.R[1], r2 = world_from_frame.R[2];
+    const float r3 = world_from_frame.R[3], r4 = world_from_frame.R[4], r5 = world_from_frame.R[5];
+    const float r6 = world_from_frame.R[6], r7 = world_from_frame.R[7], r8 = world_from_frame.R[8];
+    const float t0 = world_from_frame.t[0], t1 = world_from_frame.t[1], t2 = world_from_frame.t[2];
+
+    // 变换与筛选合为一遍：先写到 tail 处，再按有效性决定是否前进
+    const float* src_x = cloud.x.data();
+    const float* src_y = cloud.y.data();
+    const float* src_z = cloud.z.data();
+    const float* src_intensity = cloud.intensity.size() >= n ? cloud.intensity.data() : nullptr;
+    const uint8_t* inlier = cloud.inlier.size() >= n ? cloud.inlier.data() : nullptr;
+    float* __restrict dst_x = x_.data();
+    float* __restrict dst_y = y_.data();
+    float* __restrict dst_z = z_.data();
+    float* __restrict dst_intensity = intensity_.data();
+    uint8_t* __restrict dst_alive = alive_.data();
+    size_t j = tail_;
+    for (size_t i = 0; i < n; ++i) {
+        const float px = src_x[i];
+        const float py = src_y[i];
+        const float pz = src_z[i];
+        dst_x[j] = r0 * px + r1 * py + r2 * pz + t0;
+        dst_y[j] = r3 * px + r4 * py + r5 * pz + t1;
+        dst_z[j] = r6 * px + r7 * py + r8 * pz + t2;
+        dst_intensity[j] = src_intensity ? src_intensity[i] : 0.f;
+        dst_alive[j] = 1;
+        // 有限值满足 v - v == 0，NaN/Inf不满足
+        const bool valid = (px - px == 0.f) && (py - py == 0.f) && (pz - pz == 0.f) &&
+                           (!inlier || inlier[i]);
+        j += valid;
+    }
+
+    Slot& slot = slotAt(num_slots_);
+    slot.begin = tail_;
+    slot.end = j;
+    slot.timestamp = cloud.frame_timestamp;
+    slot.frame_id = cloud.frame_id;
+    slot.world_from_frame = world_from_frame;
+    ++num_slots_;
+    const size_t added = j - tail_;
+    tail_ = j;
+    live_points_ += added;
+    ++stats_.frames_added;
+
+    if (config_.voxel_size > 0.f) {
+        reserveTable(added);
+        insertRange(slot.begin, slot.end);
+    }
+
+    if (config_.max_age > 0.0) {
+        while (num_slots_ > 1 && slotAt(0).timestamp < cloud.frame_timestamp - config_.max_age) {
+            popFront();
+        }
+    }
+    return added;
+}
+
+size_t FrameAccumulator::exportPoints(float* points, size_t stride, float* intensity, float* age) const {
+    if (num_slots_ == 0) {
+        return 0;
+    }
+    const Slot& latest = slotAt(num_slots_ - 1);
+    RigidTransform out_from_world;
+    if (!config_.world_frame) {
+        out_from_world = latest.world_from_frame.inverse();
+    }
+    const float r0 = out_from_world.R[0], r1 = out_from_world.R[1], r2 = out_from_world.R[2];
+    const float r3 = out_from_world.R[3], r4 = out_from_world.R[4], r5 = out_from_world.R[5];
+    const float r6 = out_from_world.R[6], r7 = out_from_world.R[7], r8 = out_from_world.R[8];
+    const float t0 = out_from_world.t[0], t1 = out_from_world.t[1], t2 = out_from_world.t[2];
+
+    const bool dedup = config_.voxel_size > 0.f;
+    size_t j = 0;
+    for (size_t s = 0; s < num_slots_; ++s) {
+        const Slot& slot = slotAt(s);
+        const float slot_age = static_cast<float>(latest.timestamp - slot.timestamp);
+        for (size_t i = slot.begin; i < slot.end; ++i) {
+            if (dedup && !alive_[i]) {
+                continue;
+            }
+            const float px = x_[i];
+            const float py = y_[i];
+            const float pz = z_[i];
+            float* p = points + j * stride;
+            p[0] = r0 * px + r1 * py + r2 * pz + t0;
+            p[1] = r3 * px + r4 * py + r5 * pz + t1;
+            p[2] = r6 * px + r7 * py + r8 * pz + t2;
+            if (intensity) {
+                intensity[j] = intensity_[i];
+            }
+            if (age) {
+                age[j] = slot_age;
+            }
+            ++j;
+        }
+    }
+    return j;
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "point_cloud_data.h"
+#include "pose.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 多帧累积配置
+ */
+struct AccumulatorConfig {
+    bool enabled = false;
+    uint32_t max_frames = 5;        // 窗口内最多保留的帧数
+    double max_age = 0.0;           // 窗口时长（秒），早于最新帧超过该时长的帧被移出，0表示只按帧数
+    float voxel_size = 0.0f;        // 大于0时按体素去重，每个体素只保留最新的点（米）
+    bool world_frame = false;       // true 输出世界系坐标，false 输出最新帧所在的坐标系
+};
+
+/**
+ * @brief 多帧累积的运行计数
+ */
+struct AccumulatorStats {
+    uint64_t frames_added = 0;          // 累计加入的帧数
+    uint64_t frames_retransformed = 0;  // 因位姿更新而重新变换的帧次数
+    uint64_t compactions = 0;           // 存活区间搬回缓冲开头的次数
+};
+
+/**
+ * @brief 滑动窗口的多帧累积（局部地图）
+ *
+ * 每帧加入时按帧时间戳的位姿变换到世界系，追加到一段线性缓冲的末尾；
+ * 窗口内的帧在缓冲中按到达顺序首尾相接，移出最旧的帧只需前移起点，
+ * 写到缓冲末尾时才把存活区间整体搬回开头，摊还下每个点只拷贝常数次，不会每帧全量重建。
+ *
+ * 位姿缓冲的版本号变化时重新插值各帧的位姿，只有位姿确实改变的帧
+ * （通常是加入时位姿尚未到达、只能外推的最新几帧）才用增量变换 T_new * T_old^-1 重新变换。
+ *
+ * 启用体素去重时，用开放寻址哈希表记录每个体素当前的点，同一体素中较新的点使较旧的点失效；
+ * 失效的点留在缓冲中、导出时跳过。去重以点加入（或重新变换）时的位置为准。
+ */
+class FrameAccumulator {
+public:
+    FrameAccumulator() = default;
+
+    /**
+     * @brief 设置配置并清空窗口
+     */
+    void setConfig(const AccumulatorConfig& config);
+    const AccumulatorConfig& config() const { return config_; }
+
+    /**
+     * @brief 按每帧最多 max_points 个点预留缓冲，之后窗口不超过该规模时不再分配内存
+     */
+    void reserve(size_t max_points);
+
+    void clear();
+
+    /**
+     * @brief 加入一帧：先按位姿更新已有的帧，再移出超出窗口的帧
+     *
+     * 坐标非有限的点与离群点掩码为0的点不加入。
+     *
+     * @return 加入的点数
+     */
+    size_t add(const PoseBuffer& poses, const PointCloudData& cloud);
+
+    /**
+     * @brief 位姿缓冲变化后重新插值各帧位姿，只变换位姿改变的帧
+     *
+     * @return 重新变换的帧数；位姿缓冲版本未变时直接返回0
+     */
+    size_t refreshPoses(const PoseBuffer& poses);
+
+    /**
+     * @brief 窗口内（去重后）的点数
+     */
+    size_t size() const { return live_points_; }
+    size_t numFrames() const { return num_slots_; }
+
+    /**
+     * @brief 最新一帧的帧ID与时间戳，窗口为空时为0
+     */
+    uint32_t latestFrameId() const;
+    double latestTimestamp() const;
+
+    const AccumulatorStats& stats() const { return stats_; }
+
+    /**
+     * @brief 按从旧到新的顺序导出窗口内的点
+     *
+     * @param points 输出 (size(), stride)，前三列写入 x, y, z
+     * @param intensity 可选输出，长度 size()
+     * @param age 可选输出，长度 size()，点所在帧早于最新帧的时长（秒）
+     * @return 写出的点数
+     */
+    size_t exportPoints(float* points, size_t stride, float* intensity, float* age) const;
+
+private:
+    // 窗口中的一帧：在线性缓冲中的区间与当前施加的位姿
+    struct Slot {
+        size_t begin = 0;
+        size_t end = 0;
+        double timestamp = 0.0;
+        uint32_t frame_id = 0;
+        RigidTransform world_from_frame;
+    };
+
+    Slot& slotAt(size_t i) { return slots_[(first_slot_ + i) % slots_.size()]; }
+    const Slot& slotAt(size_t i) const { return slots_[(first_slot_ + i) % slots_.size()]; }
+    void popFront();
+    void ensureCapacity(size_t n);
+    void compact();
+
+    uint64_t voxelKey(size_t index) const;
+    void insertRange(size_t begin, size_t end);
+    void reserveTable(size_t n);
+    void rebuildTable(size_t capacity);
+
+    AccumulatorConfig config_;
+    AccumulatorStats stats_;
+    float inv_voxel_size_ = 0.f;
+
+    // 帧的环形队列，容量为 max_frames
+    std::vector<Slot> slots_;
+    size_t first_slot_ = 0;
+    size_t num_slots_ = 0;
+
+    // 点的线性缓冲（世界系），窗口内的点位于 [head_, tail_)
+    FrameColumn<float> x_;
+    FrameColumn<float> y_;
+    FrameColumn<float> z_;
+    FrameColumn<float> intensity_;
+    FrameColumn<uint8_t> alive_;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+    size_t live_points_ = 0;
+    uint64_t pose_version_ = 0;
+
+    // 体素去重的哈希表：体素键 -> 缓冲下标，条目可能过期，查询时校验
+    std::vector<uint64_t> table_key_;
+    std::vector<uint32_t> table_index_;
+    size_t table_used_ = 0;
+
+    // 跨帧复用的位姿插值缓冲
+    std::vector<double> slot_time_;
+    std::vector<RigidTransform> slot_transform_;
+};
+
+} // namespace rs_realtime
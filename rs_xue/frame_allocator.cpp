@@ -0,0 +1,143 @@
+#include "frame_allocator.h"
+
+#include <sys/mman.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace rs_realtime {
+
+namespace {
+
+// 每块缓冲前的头部记录分配方式，释放时不依赖当前的大页模式
+constexpr size_t kHeaderSize = 64;
+
+enum class BlockKind : uint32_t { HEAP, MAPPED };
+
+struct BlockHeader {
+    size_t mapped_length;
+    BlockKind kind;
+};
+
+std::atomic<HugePageMode> g_mode {HugePageMode::NONE};
+std::atomic<uint64_t> g_allocations {0};
+std::atomic<uint64_t> g_deallocations {0};
+std::atomic<uint64_t> g_bytes {0};
+std::atomic<uint64_t> g_huge_allocations {0};
+std::atomic<uint64_t> g_explicit_fallbacks {0};
+
+void* mapHuge(size_t length, HugePageMode mode) {
+#ifdef MAP_HUGETLB
+    if (mode == HugePageMode::EXPLICIT) {
+        void* ptr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            return ptr;
+        }
+        g_explicit_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+    // 普通映射只保证4KB对齐：多映射一个大页，把起点对齐到2MB后释放首尾多余部分，
+    // 使整个映射由完整的2MB区段组成，都能由透明大页承载
+    const size_t padded = length + kHugePageSize;
+    void* raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const auto begin = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (begin + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    const size_t head = aligned - begin;
+    const size_t tail = padded - head - length;
+    if (head > 0) {
+        ::munmap(raw, head);
+    }
+    if (tail > 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+    void* ptr = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    ::madvise(ptr, length, MADV_HUGEPAGE);
+#endif
+    return ptr;
+}
+
+} // namespace
+
+void setHugePageMode(HugePageMode mode) {
+    g_mode.store(mode, std::memory_order_relaxed);
+}
+
+HugePageMode hugePageMode() {
+    return g_mode.load(std::memory_order_relaxed);
+}
+
+FrameAllocationCounters frameAllocationCounters() {
+    FrameAllocationCounters counters;
+    counters.allocations = g_allocations.load(std::memory_order_relaxed);
+    counters.deallocations = g_deallocations.load(std::memory_order_relaxed);
+    counters.bytes_allocated = g_bytes.load(std::memory_order_relaxed);
+    counters.huge_page_allocations = g_huge_allocations.load(std::memory_order_relaxed);
+    counters.explicit_fallbacks = g_explicit_fallbacks.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void adviseHugePages(void* ptr, size_t bytes) {
+#ifdef MADV_HUGEPAGE
+    if (!ptr || g_mode.load(std::memory_order_relaxed) == HugePageMode::NONE) {
+        return;
+    }
+    const auto begin = reinterpret_cast<uintptr_t>(ptr);
+    const uintptr_t first = (begin + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    const uintptr_t last = (begin + bytes) / kHugePageSize * kHugePageSize;
+    if (last > first) {
+        ::madvise(reinterpret_cast<void*>(first), last - first, MADV_HUGEPAGE);
+    }
+#else
+    (void)ptr;
+    (void)bytes;
+#endif
+}
+
+namespace detail {
+
+void* frameAllocate(size_t bytes) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    const HugePageMode mode = g_mode.load(std::memory_order_relaxed);
+    char* base = nullptr;
+    BlockHeader header {0, BlockKind::HEAP};
+    if (mode != HugePageMode::NONE && bytes >= kHugePageThreshold) {
+        // 映射起点与长度都按大页对齐（显式大页的 munmap 也要求如此），头部占用首个大页的前64字节
+        const size_t length = (bytes + kHeaderSize + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        base = static_cast<char*>(mapHuge(length, mode));
+        if (base) {
+            header = {length, BlockKind::MAPPED};
+            g_huge_allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (!base) {
+        base = static_cast<char*>(::operator new(bytes + kHeaderSize, std::align_val_t(kHeaderSize)));
+    }
+    std::memcpy(base, &header, sizeof(header));
+    return base + kHeaderSize;
+}
+
+void frameDeallocate(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    g_deallocations.fetch_add(1, std::memory_order_relaxed);
+    char* base = static_cast<char*>(ptr) - kHeaderSize;
+    BlockHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (header.kind == BlockKind::MAPPED) {
+        ::munmap(base, header.mapped_length);
+    } else {
+        ::operator delete(base, std::align_val_t(kHeaderSize));
+    }
+}
+
+} // namespace detail
+
+} // namespace rs_realtime
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace rs_realtime {
+
+/**
+ * @brief 帧缓冲的大页策略（进程内全局生效）
+ */
+enum class HugePageMode {
+    NONE,           // 普通堆内存
+    TRANSPARENT,    // 匿名映射 + madvise(MADV_HUGEPAGE)，由内核按需合并为透明大页
+    EXPLICIT        // MAP_HUGETLB 显式大页，需预先配置 vm.nr_hugepages，失败时退回透明大页
+};
+
+/**
+ * @brief 帧缓冲分配计数（进程内全局累计）
+ */
+struct FrameAllocationCounters {
+    uint64_t allocations = 0;           // 分配次数
+    uint64_t deallocations = 0;         // 释放次数
+    uint64_t bytes_allocated = 0;       // 累计分配字节数
+    uint64_t huge_page_allocations = 0; // 走大页路径（透明或显式）的分配次数
+    uint64_t explicit_fallbacks = 0;    // 显式大页映射失败、退回透明大页的次数
+};
+
+constexpr size_t kHugePageSize = 2u << 20;         // x86-64/aarch64 的默认大页大小
+constexpr size_t kHugePageThreshold = 1u << 20;    // 不小于该值的缓冲才值得用大页
+
+void setHugePageMode(HugePageMode mode);
+HugePageMode hugePageMode();
+FrameAllocationCounters frameAllocationCounters();
+
+/**
+ * @brief 对不经过 FrameAllocator 的已有缓冲建议透明大页（大页模式为NONE时不做任何事）
+ *
+ * 只作用于缓冲内完整对齐的2MB区段，应在首次写入之前调用。
+ */
+void adviseHugePages(void* ptr, size_t bytes);
+
+namespace detail {
+
+void* frameAllocate(size_t bytes);
+void frameDeallocate(void* ptr);
+
+} // namespace detail
+
+/**
+ * @brief 点云列的分配器：计数每一次分配，大块缓冲按 HugePageMode 使用大页
+ *
+ * 不足 kHugePageThreshold 的分配走普通堆；超过阈值且启用大页时映射的起点与长度都按2MB对齐。
+ * 分配器无状态，同类型的实例之间可以互相释放。
+ */
+template <typename T>
+struct FrameAllocator {
+    using value_type = T;
+
+    FrameAllocator() noexcept = default;
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(detail::frameAllocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t) noexcept {
+        detail::frameDeallocate(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace rs_realtime
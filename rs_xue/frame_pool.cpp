@@ -0,0 +1,67 @@
+#include "frame_pool.h"
+
+namespace rs_realtime {
+
+void FramePool::Releaser::operator()(PointCloudData* frame) const {
+    if (pool) {
+        pool->release(frame);
+    } else {
+        delete frame;
+    }
+}
+
+std::shared_ptr<FramePool> FramePool::create() {
+    return std::shared_ptr<FramePool>(new FramePool());
+}
+
+void FramePool::configure(const FramePoolConfig& config) {
+    setHugePageMode(config.huge_pages);
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    // 空闲列表预留足够的槽位，还帧时不会因扩容而分配
+    free_.reserve(config.frames * 2);
+    while (free_.size() < config.frames) {
+        free_.emplace_back(new PointCloudData());
+        ++frames_created_;
+    }
+    for (auto& frame : free_) {
+        frame->reserve(config.max_points);
+    }
+}
+
+FramePool::Handle FramePool::acquire() {
+    std::unique_ptr<PointCloudData> frame;
+    size_t max_points = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            frame = std::move(free_.back());
+            free_.pop_back();
+        } else {
+            ++frames_created_;
+            ++pool_misses_;
+            max_points = config_.max_points;
+        }
+    }
+    if (!frame) {
+        frame.reset(new PointCloudData());
+        frame->reserve(max_points);
+    }
+    return Handle(frame.release(), Releaser{shared_from_this()});
+}
+
+void FramePool::release(PointCloudData* frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.emplace_back(frame);
+}
+
+FramePoolStats FramePool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FramePoolStats stats;
+    stats.frames_created = frames_created_;
+    stats.pool_misses = pool_misses_;
+    stats.free_frames = free_.size();
+    return stats;
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "frame_allocator.h"
+#include "point_cloud_data.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 帧池配置
+ */
+struct FramePoolConfig {
+    size_t frames = 4;                  // 预热的帧数（处理中、待取走、使用方各一帧，再留一帧余量）
+    size_t max_points = 0;              // 每帧预留的点数，应不小于传感器单帧最大点数；0表示不预留，随首批帧增长
+    HugePageMode huge_pages = HugePageMode::NONE; // 帧缓冲的大页策略（进程内全局生效）
+};
+
+/**
+ * @brief 帧池计数
+ */
+struct FramePoolStats {
+    uint64_t frames_created = 0;        // 创建的帧总数（含预热）
+    uint64_t pool_misses = 0;           // 空闲列表为空、临时新建帧的次数
+    uint64_t free_frames = 0;           // 当前空闲的帧数
+};
+
+/**
+ * @brief 预热的 PointCloudData 池，稳态下取帧、还帧都不分配内存
+ *
+ * acquire 返回的句柄析构时把帧（连同各列已有的容量）还回池中。
+ * 句柄持有池的引用，可以比创建它的对象活得更久（例如被Arrow导出后由Python持有）。
+ */
+class FramePool : public std::enable_shared_from_this<FramePool> {
+public:
+    struct Releaser {
+        std::shared_ptr<FramePool> pool;
+        void operator()(PointCloudData* frame) const;
+    };
+    using Handle = std::unique_ptr<PointCloudData, Releaser>;
+
+    static std::shared_ptr<FramePool> create();
+
+    /**
+     * @brief 设置大页策略并预热：补足空闲帧到 config.frames，并为每帧预留 max_points 的容量
+     */
+    void configure(const FramePoolConfig& config);
+
+    /**
+     * @brief 取一帧（内容未清空，由调用方覆盖）
+     */
+    Handle acquire();
+
+    FramePoolStats stats() const;
+
+private:
+    FramePool() = default;
+    void release(PointCloudData* frame);
+
+    mutable std::mutex mutex_;
+    FramePoolConfig config_;
+    std::vector<std::unique_ptr<PointCloudData>> free_;
+    uint64_t frames_created_ = 0;
+    uint64_t pool_misses_ = 0;
+};
+
+} // namespace rs_realtime
@@ -0,0 +1,276 @@
+#include "ground_segmenter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "eigen3x3.h"
+
+namespace rs_realtime {
+
+namespace {
+
+// 每个任务块处理的分块数（多数分块为空，开销很小）
+constexpr size_t kPatchGrain = 64;
+// 分块数上限，点云范围过大时自动放大分块边长
+constexpr size_t kMaxPatches = 1 << 20;
+constexpr uint32_t kInvalidPatch = std::numeric_limits<uint32_t>::max();
+// 矩累加的分组宽度，每组内各通道独立累加以便向量化
+constexpr uint32_t kLanes = 8;
+
+// 种子点相对参考点 (ox, oy, oz) 的一阶、二阶矩
+struct PlaneMoments {
+    float w, x, y, z, xx, xy, xz, yy, yz, zz;
+};
+
+PlaneMoments accumulateMoments(const float* __restrict x, const float* __restrict y, const float* __restrict z,
+                               const uint8_t* __restrict mask, uint32_t n, float ox, float oy, float oz) {
+    float acc[10][kLanes] = {};
+    uint32_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (uint32_t l = 0; l < kLanes; ++l) {
+            const float w = mask[i + l] ? 1.f : 0.f;
+            const float dx = (x[i + l] - ox) * w;
+            const float dy = (y[i + l] - oy) * w;
+            const float dz = (z[i + l] - oz) * w;
+            acc[0][l] += w;
+            acc[1][l] += dx;
+            acc[2][l] += dy;
+            acc[3][l] += dz;
+            acc[4][l] += dx * dx;
+            acc[5][l] += dx * dy;
+            acc[6][l] += dx * dz;
+            acc[7][l] += dy * dy;
+            acc[8][l] += dy * dz;
+            acc[9][l] += dz * dz;
+        }
+    }
+    for (; i < n; ++i) {
+        const float w = mask[i] ? 1.f : 0.f;
+        const float dx = (x[i] - ox) * w;
+        const float dy = (y[i] - oy) * w;
+        const float dz = (z[i] - oz) * w;
+        acc[0][0] += w;
+        acc[1][0] += dx;
+        acc[2][0] += dy;
+        acc[3][0] += dz;
+        acc[4][0] += dx * dx;
+        acc[5][0] += dx * dy;
+        acc[6][0] += dx * dz;
+        acc[7][0] += dy * dy;
+        acc[8][0] += dy * dz;
+        acc[9][0] += dz * dz;
+    }
+    float sum[10];
+    for (int k = 0; k < 10; ++k) {
+        sum[k] = 0.f;
+        for (uint32_t l = 0; l < kLanes; ++l) {
+            sum[k] += acc[k][l];
+        }
+    }
+    return {sum[0], sum[1], sum[2], sum[3], sum[4], sum[5], sum[6], sum[7], sum[8], sum[9]};
+}
+
+// 点到平面 n·(p - o) + d 的距离小于阈值的点置1
+void markInliers(const float* __restrict x, const float* __restrict y, const float* __restrict z,
+                 uint8_t* __restrict mask, uint32_t n, const float normal[3], float d,
+                 float ox, float oy, float oz, float threshold) {
+    const float nx = normal[0];
+    const float ny = normal[1];
+    const float nz = normal[2];
+    const float offset = d - nx * ox - ny * oy - nz * oz;
+    for (uint32_t i = 0; i < n; ++i) {
+        const float dist = nx * x[i] + ny * y[i] + nz * z[i] + offset;
+        mask[i] = std::fabs(dist) < threshold ? 1 : 0;
+    }
+}
+
+} // namespace
+
+GroundSegmenter::GroundSegmenter(ThreadPool& pool)
+    : pool_(pool) {
+}
+
+size_t GroundSegmenter::computeLabels(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                      uint8_t* ground) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return computeLabelsLocked(x, y, z, n, stride, ground);
+}
+
+size_t GroundSegmenter::computeLabelsLocked(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                            uint8_t* ground) {
+    std::fill(ground, ground + n, 0);
+
+    // 第一步：有效点的水平范围
+    float x_min = std::numeric_limits<float>::max();
+    float y_min = std::numeric_limits<float>::max();
+    float x_max = std::numeric_limits<float>::lowest();
+    float y_max = std::numeric_limits<float>::lowest();
+    size_t valid = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const float px = x[i * stride];
+        const float py = y[i * stride];
+        if (!std::isfinite(px) || !std::isfinite(py) || !std::isfinite(z[i * stride])) {
+            continue;
+        }
+        x_min = std::min(x_min, px);
+        x_max = std::max(x_max, px);
+        y_min = std::min(y_min, py);
+        y_max = std::max(y_max, py);
+        ++valid;
+    }
+    if (valid == 0) {
+        return 0;
+    }
+
+    float patch_size = std::max(config_.patch_size, 0.1f);
+    size_t nx = 0;
+    size_t ny = 0;
+    while (true) {
+        nx = static_cast<size_t>((x_max - x_min) / patch_size) + 1;
+        ny = static_cast<size_t>((y_max - y_min) / patch_size) + 1;
+        if (nx * ny <= kMaxPatches) {
+            break;
+        }
+        patch_size *= 2.f;
+    }
+    const size_t num_patches = nx * ny;
+    const float inv_patch = 1.f / patch_size;
+
+    // 第二步：按分块计数排序，得到块内连续的坐标
+    point_patch_.resize(n);
+    patch_start_.assign(num_patches + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        const float px = x[i * stride];
+        const float py = y[i * stride];
+        if (!std::isfinite(px) || !std::isfinite(py) || !std::isfinite(z[i * stride])) {
+            point_patch_[i] = kInvalidPatch;
+            continue;
+        }
+        const size_t cx = std::min(static_cast<size_t>((px - x_min) * inv_patch), nx - 1);
+        const size_t cy = std::min(static_cast<size_t>((py - y_min) * inv_patch), ny - 1);
+        const uint32_t patch = static_cast<uint32_t>(cy * nx + cx);
+        point_patch_[i] = patch;
+        ++patch_start_[patch + 1];
+    }
+    for (size_t p = 0; p < num_patches; ++p) {
+        patch_start_[p + 1] += patch_start_[p];
+    }
+
+    patch_cursor_.assign(patch_start_.begin(), patch_start_.end() - 1);
+    sorted_index_.resize(valid);
+    sorted_x_.resize(valid);
+    sorted_y_.resize(valid);
+    sorted_z_.resize(valid);
+    sorted_ground_.resize(valid);
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t patch = point_patch_[i];
+        if (patch == kInvalidPatch) {
+            continue;
+        }
+        const uint32_t pos = patch_cursor_[patch]++;
+        sorted_index_[pos] = static_cast<uint32_t>(i);
+        sorted_x_[pos] = x[i * stride];
+        sorted_y_[pos] = y[i * stride];
+        sorted_z_[pos] = z[i * stride];
+    }
+
+    // 第三步：各块独立拟合平面
+    worker_scratch_.resize(pool_.size());
+    pool_.parallelFor(num_patches, kPatchGrain, [&](size_t begin, size_t end, size_t worker) {
+        for (size_t p = begin; p < end; ++p) {
+            if (patch_start_[p + 1] > patch_start_[p]) {
+                fitPatch(patch_start_[p], patch_start_[p + 1], worker_scratch_[worker]);
+            }
+        }
+    });
+
+    size_t count = 0;
+    for (size_t pos = 0; pos < valid; ++pos) {
+        ground[sorted_index_[pos]] = sorted_ground_[pos];
+        count += sorted_ground_[pos];
+    }
+    return count;
+}
+
+void GroundSegmenter::fitPatch(uint32_t begin, uint32_t end, std::vector<float>& scratch) {
+    const uint32_t n = end - begin;
+    const float* px = sorted_x_.data() + begin;
+    const float* py = sorted_y_.data() + begin;
+    const float* pz = sorted_z_.data() + begin;
+    uint8_t* mask = sorted_ground_.data() + begin;
+
+    if (n < std::max<uint32_t>(config_.min_patch_points, 3)) {
+        std::fill(mask, mask + n, 0);
+        return;
+    }
+
+    // 初始种子：最低 num_lpr 个点的平均高度之上 seed_threshold 以内的点
+    scratch.assign(pz, pz + n);
+    const uint32_t lpr = std::max<uint32_t>(1, std::min(config_.num_lpr, n));
+    std::nth_element(scratch.begin(), scratch.begin() + (lpr - 1), scratch.end());
+    float lpr_sum = 0.f;
+    for (uint32_t i = 0; i < lpr; ++i) {
+        lpr_sum += scratch[i];
+    }
+    const float seed_height = lpr_sum / static_cast<float>(lpr) + config_.seed_threshold;
+    for (uint32_t i = 0; i < n; ++i) {
+        mask[i] = pz[i] < seed_height ? 1 : 0;
+    }
+
+    // 以块内首点为参考点累加矩，避免远处坐标的浮点抵消
+    const float ox = px[0];
+    const float oy = py[0];
+    const float oz = pz[0];
+    const float min_normal_z = std::cos(config_.max_slope_deg * 0.017453293f);
+    const uint32_t iterations = std::max<uint32_t>(1, config_.num_iterations);
+    for (uint32_t iter = 0; iter < iterations; ++iter) {
+        const PlaneMoments m = accumulateMoments(px, py, pz, mask, n, ox, oy, oz);
+        if (m.w < 3.f) {
+            std::fill(mask, mask + n, 0);
+            return;
+        }
+        const float inv_w = 1.f / m.w;
+        const float mx = m.x * inv_w;
+        const float my = m.y * inv_w;
+        const float mz = m.z * inv_w;
+        const float cov[6] = {m.xx * inv_w - mx * mx, m.xy * inv_w - mx * my, m.xz * inv_w - mx * mz,
+                              m.yy * inv_w - my * my, m.yz * inv_w - my * mz, m.zz * inv_w - mz * mz};
+        float eigenvalues[3];
+        float normal[3];
+        eigenSymmetric3(cov, eigenvalues, normal);
+        if (normal[2] < 0.f) {
+            normal[0] = -normal[0];
+            normal[1] = -normal[1];
+            normal[2] = -normal[2];
+        }
+        if (normal[2] < min_normal_z) {
+            // 坡度过大（立面、车身等），整块视为非地面
+            std::fill(mask, mask + n, 0);
+            return;
+        }
+        const float d = -(normal[0] * mx + normal[1] * my + normal[2] * mz);
+        markInliers(px, py, pz, mask, n, normal, d, ox, oy, oz, config_.distance_threshold);
+    }
+}
+
+size_t GroundSegmenter::apply(PointCloudData& cloud) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled) {
+        return 0;
+    }
+    const size_t n = cloud.point_count;
+    labels_.resize(n);
+    const size_t num_ground = computeLabelsLocked(cloud.x.data(), cloud.y.data(), cloud.z.data(), n, 1, labels_.data());
+    if (config_.remove_ground) {
+        for (size_t i = 0; i < n; ++i) {
+            labels_[i] = labels_[i] ? 0 : 1;
+        }
+        cloud.compact(labels_.data());
+    } else {
+        cloud.ground.assign(labels_.begin(), labels_.end());
+    }
+    return num_ground;
+}
+
+} // namespace rs_realtime
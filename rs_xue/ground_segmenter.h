@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "point_cloud_data.h"
+#include "thread_pool.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 地面分割配置
+ *
+ * 输入点云需已标定到z轴朝上的坐标系。
+ */
+struct GroundSegmentationConfig {
+    bool enabled = false;
+    float patch_size = 4.0f;            // 水平分块边长（米），每块独立拟合一个平面
+    uint32_t num_lpr = 20;              // 每块取最低的若干点求平均高度作为种子基准
+    float seed_threshold = 0.3f;        // 高于基准不超过该值的点作为初始种子（米）
+    float distance_threshold = 0.15f;   // 到平面距离小于该值的点判为地面（米）
+    uint32_t num_iterations = 3;        // 平面拟合迭代次数
+    float max_slope_deg = 20.0f;        // 平面法向与z轴夹角超过该值的块不视为地面
+    uint32_t min_patch_points = 10;     // 点数不足的块不拟合，全部视为非地面
+    bool remove_ground = false;         // true 压缩掉地面点，false 输出地面标签列
+};
+
+/**
+ * @brief 分块PCA平面拟合的地面分割
+ *
+ * 按水平网格分块（计数排序得到块内连续的点坐标），每块以最低点附近的点为种子，
+ * 迭代地做PCA平面拟合、按点面距离重新选取种子。块之间并行；块内的矩累加与点面距离
+ * 均为定长分组的无分支循环，可被编译器向量化。所有中间缓冲跨帧复用，稳定后不再分配内存。
+ */
+class GroundSegmenter {
+public:
+    explicit GroundSegmenter(ThreadPool& pool = ThreadPool::global());
+
+    void setConfig(const GroundSegmentationConfig& config) { config_ = config; }
+    const GroundSegmentationConfig& config() const { return config_; }
+
+    /**
+     * @brief 计算地面标签
+     *
+     * @param ground 输出，长度n，地面点为1；NaN点为0
+     * @return 地面点数量
+     */
+    size_t computeLabels(const float* x, const float* y, const float* z, size_t n, size_t stride, uint8_t* ground);
+
+    /**
+     * @brief 对一帧点云执行地面分割：按配置压缩掉地面点，或把标签写入 cloud.ground
+     *
+     * @return 地面点数量，未启用时返回0
+     */
+    size_t apply(PointCloudData& cloud);
+
+private:
+    size_t computeLabelsLocked(const float* x, const float* y, const float* z, size_t n, size_t stride, uint8_t* ground);
+    void fitPatch(uint32_t begin, uint32_t end, std::vector<float>& scratch);
+
+    GroundSegmentationConfig config_;
+    ThreadPool& pool_;
+    std::mutex mutex_;                  // 保护跨帧复用的缓冲
+
+    // 复用的中间缓冲
+    std::vector<uint32_t> point_patch_; // 每个点所属的块，NaN点为无效值
+    std::vector<uint32_t> patch_start_; // 各块在排序数组中的起始位置（前缀和）
+    std::vector<uint32_t> patch_cursor_;
+    std::vector<uint32_t> sorted_index_;
+    std::vector<float> sorted_x_;
+    std::vector<float> sorted_y_;
+    std::vector<float> sorted_z_;
+    std::vector<uint8_t> sorted_ground_;
+    std::vector<std::vector<float>> worker_scratch_;  // 每个工作线程的最低点选择缓冲
+    std::vector<uint8_t> labels_;
+};
+
+} // namespace rs_realtime
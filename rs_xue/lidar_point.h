@@ -0,0 +1,20 @@
+#pragma once
+
+// 驱动点云消息类型，实时客户端与PCAP转换共用
+
+#include <rs_driver/api/lidar_driver.hpp>
+
+#ifdef ENABLE_PCL_POINTCLOUD
+#include <rs_driver/msg/pcl_point_cloud_msg.hpp>
+#else
+#include <rs_driver/msg/point_cloud_msg.hpp>
+#endif
+
+// 驱动输出的点类型，编译时选择（PointXYZI / PointXYZIT / PointXYZIRT），
+// 转换内核按点类型具备的字段特化，缺少的字段输出为空列
+#ifndef RS_XUE_POINT_TYPE
+#define RS_XUE_POINT_TYPE PointXYZIT
+#endif
+
+typedef RS_XUE_POINT_TYPE PointT;
+typedef PointCloudT<PointT> PointCloudMsg;
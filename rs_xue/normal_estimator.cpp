@@ -0,0 +1,496 @@
+#include "normal_estimator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "eigen3x3.h"
+
+namespace rs_realtime {
+
+namespace {
+
+// 每批一起做特征分解的点数
+constexpr size_t kBatch = 64;
+// 有序帧每个任务块处理的点数
+constexpr size_t kPointGrain = 4096;
+// 体素回退时每个任务块处理的体素数
+constexpr size_t kCellGrain = 128;
+// 近似模式下稠密区域的细体素边长为 radius / kFineSteps
+constexpr int32_t kFineSteps = 4;
+// 每个细体素保存的矩的个数（与 Moments 的字段一一对应）
+constexpr size_t kMomentSize = 10;
+constexpr uint32_t kInvalidSlot = std::numeric_limits<uint32_t>::max();
+
+// 邻点相对参考点的一阶、二阶矩
+struct Moments {
+    float w, x, y, z, xx, xy, xz, yy, yz, zz;
+};
+
+inline void addNeighbor(Moments& m, float dx, float dy, float dz) {
+    m.w += 1.f;
+    m.x += dx;
+    m.y += dy;
+    m.z += dz;
+    m.xx += dx * dx;
+    m.xy += dx * dy;
+    m.xz += dx * dz;
+    m.yy += dy * dy;
+    m.yz += dy * dz;
+    m.zz += dz * dz;
+}
+
+inline void addMoments(Moments& m, const Moments& other) {
+    m.w += other.w;
+    m.x += other.x;
+    m.y += other.y;
+    m.z += other.z;
+    m.xx += other.xx;
+    m.xy += other.xy;
+    m.xz += other.xz;
+    m.yy += other.yy;
+    m.yz += other.yz;
+    m.zz += other.zz;
+}
+
+inline void storeMoments(float* out, const Moments& m) {
+    out[0] = m.w;
+    out[1] = m.x;
+    out[2] = m.y;
+    out[3] = m.z;
+    out[4] = m.xx;
+    out[5] = m.xy;
+    out[6] = m.xz;
+    out[7] = m.yy;
+    out[8] = m.yz;
+    out[9] = m.zz;
+}
+
+// 把相对参考点 a 的矩换到参考点 b 后累加，delta = a - b：
+// Σ(d+δ) = S1 + wδ，Σ(d+δ)(d+δ)^T = S2 + S1δ^T + δS1^T + wδδ^T
+inline void addShiftedMoments(Moments& m, const float* in, float delta_x, float delta_y, float delta_z) {
+    const float w = in[0];
+    const float sx = in[1];
+    const float sy = in[2];
+    const float sz = in[3];
+    m.w += w;
+    m.x += sx + w * delta_x;
+    m.y += sy + w * delta_y;
+    m.z += sz + w * delta_z;
+    m.xx += in[4] + 2.f * sx * delta_x + w * delta_x * delta_x;
+    m.xy += in[5] + sx * delta_y + sy * delta_x + w * delta_x * delta_y;
+    m.xz += in[6] + sx * delta_z + sz * delta_x + w * delta_x * delta_z;
+    m.yy += in[7] + 2.f * sy * delta_y + w * delta_y * delta_y;
+    m.yz += in[8] + sy * delta_z + sz * delta_y + w * delta_y * delta_z;
+    m.zz += in[9] + 2.f * sz * delta_z + w * delta_z * delta_z;
+}
+
+// 连续存放的一段点中，与参考点距离不超过半径的点累加到矩中（无分支，按权重0/1累加）
+inline void accumulateRange(const float* __restrict x, const float* __restrict y, const float* __restrict z,
+                            uint32_t begin, uint32_t end, float px, float py, float pz, float radius2,
+                            Moments& m) {
+    for (uint32_t j = begin; j < end; ++j) {
+        const float dx = x[j] - px;
+        const float dy = y[j] - py;
+        const float dz = z[j] - pz;
+        const float w = (dx * dx + dy * dy + dz * dz <= radius2) ? 1.f : 0.f;
+        const float wx = dx * w;
+        const float wy = dy * w;
+        const float wz = dz * w;
+        m.w += w;
+        m.x += wx;
+        m.y += wy;
+        m.z += wz;
+        m.xx += wx * dx;
+        m.xy += wx * dy;
+        m.xz += wx * dz;
+        m.yy += wy * dy;
+        m.yz += wy * dz;
+        m.zz += wz * dz;
+    }
+}
+
+/**
+ * 一批待求解的点：邻域协方差按分量分列存放，凑满后一次批量特征分解，
+ * 再按点的原始下标写回法向与曲率。
+ */
+class NormalBatch {
+public:
+    NormalBatch(float* nx, float* ny, float* nz, size_t out_stride, float* curvature, bool orient)
+        : nx_(nx), ny_(ny), nz_(nz), out_stride_(out_stride), curvature_(curvature), orient_(orient) {}
+
+    ~NormalBatch() { flush(); }
+
+    /**
+     * @brief 加入一个点的邻域矩，满一批时求解
+     */
+    void push(size_t index, float px, float py, float pz, const Moments& m) {
+        const float inv_w = 1.f / m.w;
+        const float mx = m.x * inv_w;
+        const float my = m.y * inv_w;
+        const float mz = m.z * inv_w;
+        xx_[size_] = m.xx * inv_w - mx * mx;
+        xy_[size_] = m.xy * inv_w - mx * my;
+        xz_[size_] = m.xz * inv_w - mx * mz;
+        yy_[size_] = m.yy * inv_w - my * my;
+        yz_[size_] = m.yz * inv_w - my * mz;
+        zz_[size_] = m.zz * inv_w - mz * mz;
+        px_[size_] = px;
+        py_[size_] = py;
+        pz_[size_] = pz;
+        index_[size_] = index;
+        if (++size_ == kBatch) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief 邻点不足或自身无效的点直接写NaN
+     */
+    void reject(size_t index) {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        nx_[index * out_stride_] = nan;
+        ny_[index * out_stride_] = nan;
+        nz_[index * out_stride_] = nan;
+        if (curvature_) {
+            curvature_[index] = nan;
+        }
+    }
+
+    void flush() {
+        if (size_ == 0) {
+            return;
+        }
+        eigenSymmetric3Batch(xx_, xy_, xz_, yy_, yz_, zz_, size_, lambda_, bx_, by_, bz_);
+        for (size_t k = 0; k < size_; ++k) {
+            float ux = bx_[k];
+            float uy = by_[k];
+            float uz = bz_[k];
+            // 传感器位于原点，法向与视线（原点指向该点）同向时翻转
+            if (orient_ && ux * px_[k] + uy * py_[k] + uz * pz_[k] > 0.f) {
+                ux = -ux;
+                uy = -uy;
+                uz = -uz;
+            }
+            const size_t out = index_[k] * out_stride_;
+            nx_[out] = ux;
+            ny_[out] = uy;
+            nz_[out] = uz;
+            if (curvature_) {
+                const float trace = xx_[k] + yy_[k] + zz_[k];
+                curvature_[index_[k]] = trace > 0.f ? std::max(lambda_[k], 0.f) / trace : 0.f;
+            }
+        }
+        valid_ += size_;
+        size_ = 0;
+    }
+
+    size_t valid() const { return valid_; }
+
+private:
+    float xx_[kBatch], xy_[kBatch], xz_[kBatch], yy_[kBatch], yz_[kBatch], zz_[kBatch];
+    float lambda_[kBatch], bx_[kBatch], by_[kBatch], bz_[kBatch];
+    float px_[kBatch], py_[kBatch], pz_[kBatch];
+    size_t index_[kBatch];
+    size_t size_ = 0;
+    size_t valid_ = 0;
+
+    float* nx_;
+    float* ny_;
+    float* nz_;
+    size_t out_stride_;
+    float* curvature_;
+    bool orient_;
+};
+
+inline bool isFinitePoint(float x, float y, float z) {
+    return std::isfinite(x) && std::isfinite(y) && std::isfinite(z);
+}
+
+// 细体素相对点所在细体素的偏移（各轴 ±kFineSteps 以内）中，对格内任意一点整格都在半径内的那些
+const std::vector<std::array<int32_t, 3>>& interiorFineOffsets() {
+    static const std::vector<std::array<int32_t, 3>> offsets = [] {
+        std::vector<std::array<int32_t, 3>> result;
+        // 两格之间各轴的最大距离为 (|d|+1) 格
+        auto far = [](int32_t d) { return (std::abs(d) + 1) * (std::abs(d) + 1); };
+        for (int32_t dx = -kFineSteps; dx <= kFineSteps; ++dx) {
+            for (int32_t dy = -kFineSteps; dy <= kFineSteps; ++dy) {
+                for (int32_t dz = -kFineSteps; dz <= kFineSteps; ++dz) {
+                    if (far(dx) + far(dy) + far(dz) <= kFineSteps * kFineSteps) {
+                        result.push_back({dx, dy, dz});
+                    }
+                }
+            }
+        }
+        return result;
+    }();
+    return offsets;
+}
+
+} // namespace
+
+NormalEstimator::NormalEstimator(ThreadPool& pool)
+    : pool_(pool) {
+}
+
+size_t NormalEstimator::estimate(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                 const uint32_t* scan_index, const uint8_t* exclude,
+                                 float* nx, float* ny, float* nz, size_t out_stride, float* curvature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return estimateLocked(x, y, z, n, stride, config_.scan_rows > 0, scan_index, exclude,
+                          nx, ny, nz, out_stride, curvature);
+}
+
+size_t NormalEstimator::estimateLocked(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                       bool organized, const uint32_t* scan_index, const uint8_t* exclude,
+                                       float* nx, float* ny, float* nz, size_t out_stride, float* curvature) {
+    // 被排除的点置为NaN，两种邻域都会跳过它们
+    if (exclude) {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        masked_x_.resize(n);
+        masked_y_.resize(n);
+        masked_z_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            masked_x_[i] = exclude[i] ? nan : x[i * stride];
+            masked_y_[i] = y[i * stride];
+            masked_z_[i] = z[i * stride];
+        }
+        x = masked_x_.data();
+        y = masked_y_.data();
+        z = masked_z_.data();
+        stride = 1;
+    }
+    valid_count_.assign(pool_.size(), 0);
+    if (organized) {
+        estimateOrganized(x, y, z, n, stride, scan_index, nx, ny, nz, out_stride, curvature);
+    } else {
+        estimateVoxel(x, y, z, n, stride, nx, ny, nz, out_stride, curvature);
+    }
+    size_t valid = 0;
+    for (size_t count : valid_count_) {
+        valid += count;
+    }
+    return valid;
+}
+
+void NormalEstimator::estimateOrganized(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                        const uint32_t* scan_index, float* nx, float* ny, float* nz,
+                                        size_t out_stride, float* curvature) {
+    const size_t rows = config_.scan_rows;
+    size_t grid_size = n;
+    if (scan_index) {
+        // 扫描位置 -> 点下标，被剔除的位置为空
+        grid_size = 0;
+        for (size_t i = 0; i < n; ++i) {
+            grid_size = std::max(grid_size, static_cast<size_t>(scan_index[i]) + 1);
+        }
+        slot_.assign(grid_size, kInvalidSlot);
+        for (size_t i = 0; i < n; ++i) {
+            slot_[scan_index[i]] = static_cast<uint32_t>(i);
+        }
+    }
+    const size_t cols = (grid_size + rows - 1) / rows;
+    const int64_t row_window = config_.row_window;
+    const int64_t col_window = config_.col_window;
+    const float radius2 = config_.radius * config_.radius;
+    const float min_neighbors = static_cast<float>(std::max<uint32_t>(config_.min_neighbors, 3));
+
+    pool_.parallelFor(n, kPointGrain, [&](size_t begin, size_t end, size_t worker) {
+        NormalBatch batch(nx, ny, nz, out_stride, curvature, config_.orient_to_sensor);
+        for (size_t i = begin; i < end; ++i) {
+            const float px = x[i * stride];
+            const float py = y[i * stride];
+            const float pz = z[i * stride];
+            if (!isFinitePoint(px, py, pz)) {
+                batch.reject(i);
+                continue;
+            }
+            const size_t pos = scan_index ? scan_index[i] : i;
+            const int64_t col = static_cast<int64_t>(pos / rows);
+            const int64_t row = static_cast<int64_t>(pos % rows);
+            const int64_t c0 = std::max<int64_t>(col - col_window, 0);
+            const int64_t c1 = std::min<int64_t>(col + col_window, static_cast<int64_t>(cols) - 1);
+            const int64_t r0 = std::max<int64_t>(row - row_window, 0);
+            const int64_t r1 = std::min<int64_t>(row + row_window, static_cast<int64_t>(rows) - 1);
+            Moments m = {};
+            for (int64_t c = c0; c <= c1; ++c) {
+                for (int64_t r = r0; r <= r1; ++r) {
+                    const size_t p = static_cast<size_t>(c) * rows + static_cast<size_t>(r);
+                    if (p >= grid_size) {
+                        continue;
+                    }
+                    const size_t j = scan_index ? slot_[p] : p;
+                    if (j == kInvalidSlot) {
+                        continue;
+                    }
+                    // 自身的偏移为0，同样计入；NaN邻点的距离比较为假，自然跳过
+                    const float dx = x[j * stride] - px;
+                    const float dy = y[j * stride] - py;
+                    const float dz = z[j * stride] - pz;
+                    if (dx * dx + dy * dy + dz * dz <= radius2) {
+                        addNeighbor(m, dx, dy, dz);
+                    }
+                }
+            }
+            if (m.w < min_neighbors) {
+                batch.reject(i);
+                continue;
+            }
+            batch.push(i, px, py, pz, m);
+        }
+        batch.flush();
+        valid_count_[worker] += batch.valid();
+    });
+}
+
+void NormalEstimator::estimateVoxel(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                    float* nx, float* ny, float* nz, size_t out_stride, float* curvature) {
+    const float radius = std::max(config_.radius, 1e-3f);
+    const float radius2 = radius * radius;
+    const float min_neighbors = static_cast<float>(std::max<uint32_t>(config_.min_neighbors, 3));
+    grid_.build(x, y, z, n, stride, radius);
+
+    // 无效点不在任何体素中，先统一写NaN
+    {
+        NormalBatch batch(nx, ny, nz, out_stride, curvature, false);
+        for (size_t i = 0; i < n; ++i) {
+            if (grid_.pointCell(i) == VoxelHashGrid::kInvalidCell) {
+                batch.reject(i);
+            }
+        }
+    }
+
+    // 第一步：按粗体素并行，体素内的点直接扫描27邻域；开启近似时稠密体素只做标记
+    dense_cell_.assign(grid_.numCells(), 0);
+    const float* sx = grid_.sortedX();
+    const float* sy = grid_.sortedY();
+    const float* sz = grid_.sortedZ();
+    const uint32_t* sorted_index = grid_.sortedIndex();
+    pool_.parallelFor(grid_.numCells(), kCellGrain, [&](size_t begin, size_t end, size_t worker) {
+        NormalBatch batch(nx, ny, nz, out_stride, curvature, config_.orient_to_sensor);
+        uint32_t neighbors[27];
+        for (size_t c = begin; c < end; ++c) {
+            const uint32_t cell = static_cast<uint32_t>(c);
+            const size_t num_neighbors = grid_.neighborCells(cell, neighbors);
+            uint32_t neighborhood = 0;
+            for (size_t k = 0; k < num_neighbors; ++k) {
+                neighborhood += grid_.cellEnd(neighbors[k]) - grid_.cellBegin(neighbors[k]);
+            }
+            if (config_.dense_neighbors > 0 && neighborhood > config_.dense_neighbors) {
+                dense_cell_[c] = 1;
+                continue;
+            }
+            for (uint32_t p = grid_.cellBegin(cell); p < grid_.cellEnd(cell); ++p) {
+                const float px = sx[p];
+                const float py = sy[p];
+                const float pz = sz[p];
+                Moments m = {};
+                for (size_t k = 0; k < num_neighbors; ++k) {
+                    accumulateRange(sx, sy, sz, grid_.cellBegin(neighbors[k]), grid_.cellEnd(neighbors[k]),
+                                    px, py, pz, radius2, m);
+                }
+                if (m.w < min_neighbors) {
+                    batch.reject(sorted_index[p]);
+                    continue;
+                }
+                batch.push(sorted_index[p], px, py, pz, m);
+            }
+        }
+        batch.flush();
+        valid_count_[worker] += batch.valid();
+    });
+    if (std::find(dense_cell_.begin(), dense_cell_.end(), 1) == dense_cell_.end()) {
+        return;
+    }
+
+    // 第二步（近似）：稠密区域改用细体素（边长 radius / kFineSteps）的聚合矩。先求每个细体素相对其角点的矩，
+    // 再把整格落在半径内的细体素的矩平移到同一参考点相加，同一细体素内的点共享这一邻域
+    const float fine_size = radius / static_cast<float>(kFineSteps);
+    fine_grid_.build(x, y, z, n, stride, fine_size);
+    const size_t num_fine = fine_grid_.numCells();
+    const float* fx = fine_grid_.sortedX();
+    const float* fy = fine_grid_.sortedY();
+    const float* fz = fine_grid_.sortedZ();
+    const uint32_t* fine_index = fine_grid_.sortedIndex();
+    fine_moments_.resize(num_fine * kMomentSize);
+    pool_.parallelFor(num_fine, kCellGrain, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; ++c) {
+            const uint32_t cell = static_cast<uint32_t>(c);
+            const int32_t* coord = fine_grid_.cellCoord(cell);
+            const float ox = static_cast<float>(coord[0]) * fine_size;
+            const float oy = static_cast<float>(coord[1]) * fine_size;
+            const float oz = static_cast<float>(coord[2]) * fine_size;
+            Moments m = {};
+            accumulateRange(fx, fy, fz, fine_grid_.cellBegin(cell), fine_grid_.cellEnd(cell), ox, oy, oz,
+                            std::numeric_limits<float>::infinity(), m);
+            storeMoments(&fine_moments_[c * kMomentSize], m);
+        }
+    });
+
+    const auto& offsets = interiorFineOffsets();
+    pool_.parallelFor(num_fine, kCellGrain, [&](size_t begin, size_t end, size_t worker) {
+        NormalBatch batch(nx, ny, nz, out_stride, curvature, config_.orient_to_sensor);
+        for (size_t c = begin; c < end; ++c) {
+            const uint32_t cell = static_cast<uint32_t>(c);
+            bool aggregated = false;
+            Moments m = {};
+            for (uint32_t p = fine_grid_.cellBegin(cell); p < fine_grid_.cellEnd(cell); ++p) {
+                const uint32_t self = fine_index[p];
+                if (!dense_cell_[grid_.pointCell(self)]) {
+                    continue;
+                }
+                if (!aggregated) {
+                    const int32_t* coord = fine_grid_.cellCoord(cell);
+                    for (const auto& d : offsets) {
+                        const uint32_t nc = fine_grid_.findCell(coord[0] + d[0], coord[1] + d[1], coord[2] + d[2]);
+                        if (nc != VoxelHashGrid::kInvalidCell) {
+                            addShiftedMoments(m, &fine_moments_[nc * kMomentSize],
+                                              static_cast<float>(d[0]) * fine_size,
+                                              static_cast<float>(d[1]) * fine_size,
+                                              static_cast<float>(d[2]) * fine_size);
+                        }
+                    }
+                    aggregated = true;
+                }
+                if (m.w < min_neighbors) {
+                    batch.reject(self);
+                    continue;
+                }
+                batch.push(self, fx[p], fy[p], fz[p], m);
+            }
+        }
+        batch.flush();
+        valid_count_[worker] += batch.valid();
+    });
+}
+
+size_t NormalEstimator::apply(PointCloudData& cloud) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!config_.enabled) {
+        return 0;
+    }
+    const size_t n = cloud.point_count;
+    const bool has_index = cloud.scan_index.size() == n;
+    // 未压缩的帧下标即扫描位置；压缩过的帧只有带原始下标时才能还原扫描顺序
+    const bool organized = config_.scan_rows > 0 && (has_index || n == cloud.stats.raw_count);
+    const uint8_t* exclude = nullptr;
+    if (cloud.inlier.size() == n) {
+        exclude_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            exclude_[i] = !cloud.inlier[i];
+        }
+        exclude = exclude_.data();
+    }
+    cloud.normal_x.resize(n);
+    cloud.normal_y.resize(n);
+    cloud.normal_z.resize(n);
+    cloud.curvature.resize(n);
+    return estimateLocked(cloud.x.data(), cloud.y.data(), cloud.z.data(), n, 1, organized,
+                          has_index ? cloud.scan_index.data() : nullptr, exclude,
+                          cloud.normal_x.data(), cloud.normal_y.data(), cloud.normal_z.data(), 1,
+                          cloud.curvature.data());
+}
+
+} // namespace rs_realtime
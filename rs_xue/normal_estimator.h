@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "point_cloud_data.h"
+#include "thread_pool.h"
+#include "voxel_grid.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 法向与曲率估计配置
+ */
+struct NormalEstimationConfig {
+    bool enabled = false;
+    float radius = 0.5f;            // 邻域半径（米），距离超过该值的邻点不参与拟合
+    uint32_t min_neighbors = 5;     // 邻域内（含自身）点数少于该值时法向与曲率输出NaN
+    uint32_t scan_rows = 0;         // 有序帧每列的点数（线数），0表示不使用扫描顺序邻域
+    uint32_t row_window = 1;        // 扫描顺序邻域上下各取的行数
+    uint32_t col_window = 2;        // 扫描顺序邻域左右各取的列数
+    bool orient_to_sensor = true;   // 法向翻转到朝向传感器原点的一侧
+    uint32_t dense_neighbors = 0;   // 体素邻域的近似阈值：27邻域点数超过该值的区域按细体素共享协方差，0表示不近似
+};
+
+/**
+ * @brief 并行的逐点法向与曲率估计
+ *
+ * 对每个点取邻域的协方差，最小特征值对应的特征向量为法向，
+ * 曲率取 λ0 / (λ0 + λ1 + λ2)（表面变化度，平面为0，各向同性为1/3）。
+ *
+ * 有序帧（驱动按列输出，每列 scan_rows 个点）使用扫描顺序邻域：
+ * 每个点取同列上下 row_window 行、左右 col_window 列的窗口，只做下标运算、不建索引；
+ * 点被剔除过时借助 scan_index 找回扫描位置。其余情况回退到体素邻域：
+ * 体素边长取 radius，每个点扫描相邻27个体素内 radius 范围的点。稠密处（近处地面等）
+ * 每个点要扫描上千个邻点，可设置 dense_neighbors 改用近似：27邻域点数超过该值的区域
+ * 建边长 radius/4 的细体素并求各细体素的一阶、二阶矩，同一细体素的点共享整格落在 radius 内的
+ * 细体素的聚合协方差，每个点只被累加一次。近似的邻域略小于 radius 球，且同一细体素的点法向相同。
+ *
+ * 协方差以待求点为参考点累加，凑满一批后用 eigenSymmetric3Batch 向量化求解；
+ * 按点（有序帧）或按体素（回退）分块在线程池上并行。
+ * NaN点、被排除的点与邻点不足的点，法向与曲率为NaN。
+ */
+class NormalEstimator {
+public:
+    explicit NormalEstimator(ThreadPool& pool = ThreadPool::global());
+
+    void setConfig(const NormalEstimationConfig& config) { config_ = config; }
+    const NormalEstimationConfig& config() const { return config_; }
+
+    /**
+     * @brief 估计法向与曲率
+     *
+     * scan_rows 大于0时按有序帧处理：第i个点位于扫描位置 scan_index[i]（未给出时为i），
+     * 位置 p 对应第 p / scan_rows 列、第 p % scan_rows 行；否则使用体素邻域。
+     *
+     * @param scan_index 可选，长度n，每个点在原始帧中的下标
+     * @param exclude 可选，长度n，非0的点既不参与邻域也不输出法向
+     * @param nx, ny, nz 输出法向分量，第i个点写在下标 i * out_stride 处
+     * @param curvature 可选输出，长度n
+     * @return 得到有效法向的点数
+     */
+    size_t estimate(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                    const uint32_t* scan_index, const uint8_t* exclude,
+                    float* nx, float* ny, float* nz, size_t out_stride, float* curvature);
+
+    /**
+     * @brief 对一帧点云估计法向，写入 cloud.normal_x/y/z 与 cloud.curvature
+     *
+     * 离群点（掩码模式）不参与邻域。scan_rows 大于0、且帧未被压缩（点数等于原始点数）
+     * 或带有 scan_index 时使用扫描顺序邻域，否则回退到体素邻域。
+     *
+     * @return 得到有效法向的点数，未启用时返回0
+     */
+    size_t apply(PointCloudData& cloud);
+
+private:
+    size_t estimateLocked(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                          bool organized, const uint32_t* scan_index, const uint8_t* exclude,
+                          float* nx, float* ny, float* nz, size_t out_stride, float* curvature);
+    void estimateOrganized(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                           const uint32_t* scan_index, float* nx, float* ny, float* nz, size_t out_stride,
+                           float* curvature);
+    void estimateVoxel(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                       float* nx, float* ny, float* nz, size_t out_stride, float* curvature);
+
+    NormalEstimationConfig config_;
+    ThreadPool& pool_;
+    std::mutex mutex_;                  // 保护跨帧复用的缓冲
+
+    VoxelHashGrid grid_;
+    VoxelHashGrid fine_grid_;           // 稠密区域的细体素
+    std::vector<uint8_t> dense_cell_;   // 粗体素是否属于稠密区域
+    std::vector<float> fine_moments_;   // 各细体素相对其角点的矩
+    std::vector<uint32_t> slot_;        // 扫描位置 -> 点下标，按 scan_index 剔除过点时使用
+    std::vector<size_t> valid_count_;   // 每个工作线程的有效法向计数
+    std::vector<float> masked_x_;       // 有排除点时的坐标副本，被排除的点置为NaN
+    std::vector<float> masked_y_;
+    std::vector<float> masked_z_;
+    std::vector<uint8_t> exclude_;
+};
+
+} // namespace rs_realtime
@@ -0,0 +1,682 @@
+#include "npy_writer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define RS_XUE_IO_URING 1
+#endif
+
+#include "frame_allocator.h"
+
+namespace rs_realtime {
+
+namespace {
+
+constexpr size_t kDirectAlignment = 4096;         // O_DIRECT 要求缓冲地址、文件偏移与长度按块对齐
+constexpr size_t kBufferGranularity = 64u << 10;  // 缓冲容量按64KB取整，帧间大小略有波动时仍能复用
+
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::string errnoMessage(const char* what, const std::string& path, int err) {
+    return std::string(what) + " " + path + ": " + std::strerror(err);
+}
+
+std::string parentDir(const std::string& path) {
+    const size_t slash = path.rfind('/');
+    if (slash == std::string::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+int openFlags(bool direct) {
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+#ifdef O_DIRECT
+    if (direct) {
+        flags |= O_DIRECT;
+    }
+#else
+    (void)direct;
+#endif
+    return flags;
+}
+
+} // namespace
+
+#ifdef RS_XUE_IO_URING
+
+/**
+ * @brief 最小的io_uring封装：只支持本文件用到的 openat / write / close，由单个线程使用
+ */
+class NpyWriter::Ring {
+public:
+    ~Ring() {
+        if (sqes_) {
+            ::munmap(sqes_, sqes_len_);
+        }
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_) {
+            ::munmap(cq_ptr_, cq_len_);
+        }
+        if (sq_ptr_) {
+            ::munmap(sq_ptr_, sq_len_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    /**
+     * @brief 建环，内核不支持、被seccomp禁用或版本过旧时返回false
+     */
+    bool init(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            return false;
+        }
+        // openat/close 操作随5.6内核加入，以同版本加入的 RW_CUR_POS 特性判断
+        if (!(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_RW_CUR_POS)) {
+            return false;
+        }
+        sq_len_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_len_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+        }
+        sq_ptr_ = map(sq_len_, IORING_OFF_SQ_RING);
+        cq_ptr_ = single_mmap ? sq_ptr_ : map(cq_len_, IORING_OFF_CQ_RING);
+        sqes_len_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_len_, IORING_OFF_SQES));
+        if (!sq_ptr_ || !cq_ptr_ || !sqes_) {
+            return false;
+        }
+        char* sq = static_cast<char*>(sq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_entries_ = params.sq_entries;
+        char* cq = static_cast<char*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqe_tail_ = *sq_tail_;
+        return true;
+    }
+
+    void openat(uint64_t user_data, const char* path, int flags) {
+        io_uring_sqe* sqe = next(IORING_OP_OPENAT, user_data);
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(path);
+        sqe->len = 0644;
+        sqe->open_flags = static_cast<uint32_t>(flags);
+    }
+
+    void write(uint64_t user_data, int fd, const char* data, size_t length, size_t offset) {
+        io_uring_sqe* sqe = next(IORING_OP_WRITE, user_data);
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(data);
+        sqe->len = static_cast<uint32_t>(std::min<size_t>(length, 1u << 30));
+        sqe->off = offset;
+    }
+
+    void close(uint64_t user_data, int fd) {
+        io_uring_sqe* sqe = next(IORING_OP_CLOSE, user_data);
+        sqe->fd = fd;
+    }
+
+    /**
+     * @brief 提交已准备的请求并等待至少 wait 个完成，返回提交数或 -errno
+     */
+    int submitAndWait(unsigned wait) {
+        __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+        while (true) {
+            const unsigned to_submit = sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+            const long ret = ::syscall(__NR_io_uring_enter, fd_, to_submit, wait,
+                                       wait > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (ret >= 0) {
+                return static_cast<int>(ret);
+            }
+            if (errno != EINTR) {
+                return -errno;
+            }
+        }
+    }
+
+    /**
+     * @brief 依次处理已到达的完成事件，fn(user_data, res)，fn 中可以继续准备新请求
+     */
+    template <typename Fn>
+    void reap(Fn&& fn) {
+        unsigned head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            fn(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    void* map(size_t length, off_t offset) {
+        void* ptr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    // 每个文件同一时刻只有一个请求在途，在途请求数不超过建环时的队列深度，提交队列不会满
+    io_uring_sqe* next(uint8_t opcode, uint64_t user_data) {
+        const unsigned index = sqe_tail_ & sq_mask_;
+        sq_array_[index] = index;
+        ++sqe_tail_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->user_data = user_data;
+        return sqe;
+    }
+
+    int fd_ = -1;
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    size_t sq_len_ = 0;
+    size_t cq_len_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_len_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sqe_tail_ = 0;             // 已准备、尚未发布给内核的队尾
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+/**
+ * @brief io_uring后端中一个在途文件的状态
+ */
+struct NpyWriter::Slot {
+    enum class Stage { OPEN, WRITE, CLOSE };
+
+    Job job;
+    bool busy = false;                  // 槽位上有在途文件
+    Stage stage = Stage::OPEN;
+    bool direct = false;
+    int fd = -1;
+    size_t write_size = 0;              // 写入长度，O_DIRECT 时对齐到4KB
+    size_t written = 0;
+    std::string error;
+};
+
+#else
+
+class NpyWriter::Ring {
+public:
+    bool init(unsigned) { return false; }
+};
+
+struct NpyWriter::Slot {};
+
+#endif
+
+std::string npyHeader(const char* descr, const std::vector<size_t>& shape) {
+    std::ostringstream dict;
+    dict << "{'descr': '" << descr << "', 'fortran_order': False, 'shape': (";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        dict << shape[i] << (shape.size() == 1 ? "," : (i + 1 < shape.size() ? ", " : ""));
+    }
+    dict << "), }";
+    // 魔数(6) + 版本(2) + 头部长度(2) + 字典，字典以空格补齐、换行结尾，使数据从64字节对齐处开始
+    std::string text = dict.str();
+    constexpr size_t kPreamble = 10;
+    text.append(63 - (kPreamble + text.size()) % 64, ' ');
+    text.push_back('\n');
+    std::string header("\x93NUMPY\x01\x00", 8);
+    header.push_back(static_cast<char>(text.size() & 0xff));
+    header.push_back(static_cast<char>(text.size() >> 8));
+    return header + text;
+}
+
+NpyWriter::NpyWriter(const NpyWriterConfig& config)
+    : config_(config), backend_(config.backend) {
+    config_.queue_depth = std::max(config_.queue_depth, 1u);
+    config_.threads = std::max(config_.threads, 1u);
+    if (backend_ == WriterBackend::AUTO || backend_ == WriterBackend::IO_URING) {
+        ring_.reset(new Ring());
+        if (ring_->init(config_.queue_depth)) {
+            backend_ = WriterBackend::IO_URING;
+            threads_.emplace_back(&NpyWriter::ringLoop, this);
+        } else {
+            ring_.reset();
+            backend_ = WriterBackend::THREADS;
+        }
+    }
+    if (backend_ == WriterBackend::THREADS) {
+        for (uint32_t i = 0; i < config_.threads; ++i) {
+            threads_.emplace_back(&NpyWriter::threadLoop, this);
+        }
+    }
+}
+
+NpyWriter::~NpyWriter() {
+    try {
+        flush();
+    } catch (...) {
+        // 析构时无法再上报写入错误
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    for (const Buffer& buffer : free_) {
+        detail::frameDeallocate(buffer.block);
+    }
+}
+
+NpyWriter::Buffer NpyWriter::takeBuffer(size_t bytes) {
+    const size_t capacity = roundUp(bytes, kBufferGranularity);
+    Buffer buffer;
+    void* undersized = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // 背压：排队的缓冲超过上限时等待，但至少允许一个任务在途
+        done_cv_.wait(lock, [&] {
+            return outstanding_ == 0 || pending_bytes_ + capacity <= config_.max_pending_bytes;
+        });
+        // 取容量足够的最小空闲缓冲
+        auto best = free_.end();
+        for (auto it = free_.begin(); it != free_.end(); ++it) {
+            if (it->capacity >= capacity && (best == free_.end() || it->capacity < best->capacity)) {
+                best = it;
+            }
+        }
+        if (best != free_.end()) {
+            buffer = *best;
+            *best = free_.back();
+            free_.pop_back();
+            return buffer;
+        }
+        // 没有够大的缓冲时换掉一块偏小的，空闲缓冲的数量不随文件大小的增长而累积
+        if (!free_.empty()) {
+            undersized = free_.back().block;
+            free_.pop_back();
+        }
+        ++stats_.buffer_allocations;
+    }
+    detail::frameDeallocate(undersized);
+    buffer.block = detail::frameAllocate(capacity + kDirectAlignment);
+    buffer.data = reinterpret_cast<char*>(roundUp(reinterpret_cast<uintptr_t>(buffer.block), kDirectAlignment));
+    buffer.capacity = capacity;
+    return buffer;
+}
+
+void* NpyWriter::prepare(const std::string& path, const char* descr, const std::vector<size_t>& shape,
+                         size_t itemsize) {
+    throwIfFailed();
+    if (prepared_) {
+        throw std::runtime_error("NpyWriter::prepare called again before submit");
+    }
+    size_t count = 1;
+    for (size_t dim : shape) {
+        count *= dim;
+    }
+    const std::string header = npyHeader(descr, shape);
+    const size_t size = header.size() + count * itemsize;
+    current_.buffer = takeBuffer(size);
+    current_.path = path;
+    current_.size = size;
+    std::memcpy(current_.buffer.data, header.data(), header.size());
+    prepared_ = true;
+
+    if (config_.durability != Durability::NONE) {
+        std::string dir = parentDir(path);
+        if (std::find(unsynced_dirs_.begin(), unsynced_dirs_.end(), dir) == unsynced_dirs_.end()) {
+            unsynced_dirs_.push_back(std::move(dir));
+        }
+    }
+    return current_.buffer.data + header.size();
+}
+
+void NpyWriter::submit() {
+    if (!prepared_) {
+        return;
+    }
+    prepared_ = false;
+    if (config_.direct_io) {
+        // O_DIRECT 写入对齐后的整块，尾部补零，写完再截断
+        std::memset(current_.buffer.data + current_.size, 0, roundUp(current_.size, kDirectAlignment) - current_.size);
+    }
+    enqueue(std::move(current_));
+    current_ = Job();
+}
+
+void NpyWriter::endFrame() {
+    ++frames_;
+    if (config_.durability == Durability::EVERY_N_FRAMES && config_.sync_every > 0 &&
+        frames_ % config_.sync_every == 0) {
+        enqueueSync();
+    }
+}
+
+void NpyWriter::flush() {
+    submit();
+    if (config_.durability != Durability::NONE) {
+        enqueueSync();
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [&] { return outstanding_ == 0; });
+    }
+    throwIfFailed();
+}
+
+NpyWriterStats NpyWriter::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void NpyWriter::enqueue(Job job) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++outstanding_;
+    pending_bytes_ += job.buffer.capacity;
+    if (backend_ == WriterBackend::SYNC) {
+        lock.unlock();
+        const std::string error = job.sync ? syncDirs(job.sync_dirs) : writeFile(job);
+        lock.lock();
+        finishJob(job, error);
+        return;
+    }
+    queue_.push_back(std::move(job));
+    // 线程池中可能有线程等在刷盘标记上，全部唤醒
+    work_cv_.notify_all();
+}
+
+void NpyWriter::enqueueSync() {
+    if (unsynced_dirs_.empty()) {
+        return;
+    }
+    Job job;
+    job.sync = true;
+    job.sync_dirs.swap(unsynced_dirs_);
+    enqueue(std::move(job));
+}
+
+void NpyWriter::finishJob(Job& job, const std::string& error) {
+    // 调用时持有 mutex_
+    if (!error.empty()) {
+        if (error_.empty()) {
+            error_ = error;
+        }
+    } else if (job.sync) {
+        ++stats_.syncs;
+    } else {
+        ++stats_.files;
+        stats_.bytes += job.size;
+    }
+    if (job.buffer.block) {
+        pending_bytes_ -= job.buffer.capacity;
+        free_.push_back(job.buffer);
+        job.buffer = Buffer();
+    }
+    --outstanding_;
+    done_cv_.notify_all();
+}
+
+void NpyWriter::countDirectFallback() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.direct_fallbacks;
+}
+
+void NpyWriter::throwIfFailed() {
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error.swap(error_);
+    }
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+}
+
+std::string NpyWriter::writeFile(const Job& job) {
+    bool direct = config_.direct_io;
+    int fd = ::open(job.path.c_str(), openFlags(direct), 0644);
+    if (fd < 0 && direct && errno == EINVAL) {
+        // 文件系统不支持 O_DIRECT
+        countDirectFallback();
+        direct = false;
+        fd = ::open(job.path.c_str(), openFlags(false), 0644);
+    }
+    if (fd < 0) {
+        return errnoMessage("cannot open", job.path, errno);
+    }
+    const size_t write_size = direct ? roundUp(job.size, kDirectAlignment) : job.size;
+    std::string error;
+    size_t written = 0;
+    while (written < write_size) {
+        const ssize_t ret = ::pwrite(fd, job.buffer.data + written, write_size - written, static_cast<off_t>(written));
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            error = errnoMessage("cannot write", job.path, ret < 0 ? errno : EIO);
+            break;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    if (error.empty() && write_size != job.size && ::ftruncate(fd, static_cast<off_t>(job.size)) != 0) {
+        error = errnoMessage("cannot truncate", job.path, errno);
+    }
+    if (::close(fd) != 0 && error.empty()) {
+        error = errnoMessage("cannot close", job.path, errno);
+    }
+    return error;
+}
+
+std::string NpyWriter::syncDirs(const std::vector<std::string>& dirs) {
+    // syncfs 刷写目录所在的整个文件系统，包括新建文件的目录项；
+    // 目录不存在时其中的文件都没能创建，错误已在写入时记录
+    std::string error;
+    for (const std::string& dir : dirs) {
+        const int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno != ENOENT && error.empty()) {
+                error = errnoMessage("cannot open", dir, errno);
+            }
+            continue;
+        }
+        if (::syncfs(fd) != 0 && error.empty()) {
+            error = errnoMessage("cannot sync", dir, errno);
+        }
+        ::close(fd);
+    }
+    return error;
+}
+
+void NpyWriter::threadLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        // 刷盘标记要等它之前的文件全部写完，期间其他线程也不越过它
+        work_cv_.wait(lock, [&] { return stop_ || (!queue_.empty() && !(queue_.front().sync && active_ > 0)); });
+        if (queue_.empty()) {
+            return;
+        }
+        Job job = std::move(queue_.front());
+        queue_.pop_front();
+        ++active_;
+        lock.unlock();
+        const std::string error = job.sync ? syncDirs(job.sync_dirs) : writeFile(job);
+        lock.lock();
+        --active_;
+        finishJob(job, error);
+        work_cv_.notify_all();
+    }
+}
+
+void NpyWriter::ringLoop() {
+#ifdef RS_XUE_IO_URING
+    std::vector<Slot> slots(config_.queue_depth);
+    std::vector<uint32_t> free_slots;
+    for (uint32_t i = config_.queue_depth; i > 0; --i) {
+        free_slots.push_back(i - 1);
+    }
+    size_t in_flight = 0;
+
+    auto submitWrite = [&](Slot& slot, uint64_t index) {
+        ring_->write(index, slot.fd, slot.job.buffer.data + slot.written, slot.write_size - slot.written, slot.written);
+    };
+    // 处理一个完成事件并准备该文件的下一个请求，返回true表示该文件已关闭
+    auto advance = [&](Slot& slot, uint64_t index, int res) {
+        switch (slot.stage) {
+        case Slot::Stage::OPEN:
+            if (res == -EINVAL && slot.direct) {
+                // 文件系统不支持 O_DIRECT
+                countDirectFallback();
+                slot.direct = false;
+                ring_->openat(index, slot.job.path.c_str(), openFlags(false));
+                return false;
+            }
+            if (res < 0) {
+                slot.error = errnoMessage("cannot open", slot.job.path, -res);
+                return true;
+            }
+            slot.fd = res;
+            slot.stage = Slot::Stage::WRITE;
+            slot.write_size = slot.direct ? roundUp(slot.job.size, kDirectAlignment) : slot.job.size;
+            slot.written = 0;
+            submitWrite(slot, index);
+            return false;
+        case Slot::Stage::WRITE:
+            if (res == -EINTR || res == -EAGAIN) {
+                submitWrite(slot, index);
+                return false;
+            }
+            if (res <= 0) {
+                slot.error = errnoMessage("cannot write", slot.job.path, res < 0 ? -res : EIO);
+            } else {
+                slot.written += static_cast<size_t>(res);
+                if (slot.written < slot.write_size) {
+                    submitWrite(slot, index);
+                    return false;
+                }
+                // 截断没有对应的io_uring操作（6.9以前），直接同步调用，只改元数据
+                if (slot.write_size != slot.job.size && ::ftruncate(slot.fd, static_cast<off_t>(slot.job.size)) != 0) {
+                    slot.error = errnoMessage("cannot truncate", slot.job.path, errno);
+                }
+            }
+            slot.stage = Slot::Stage::CLOSE;
+            ring_->close(index, slot.fd);
+            return false;
+        case Slot::Stage::CLOSE:
+            if (res < 0 && slot.error.empty()) {
+                slot.error = errnoMessage("cannot close", slot.job.path, -res);
+            }
+            return true;
+        }
+        return true;
+    };
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (in_flight == 0) {
+                work_cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+            }
+            // 取新任务直到槽位用完；刷盘标记要等在途的文件全部写完
+            while (!queue_.empty() && !free_slots.empty()) {
+                if (queue_.front().sync) {
+                    if (in_flight > 0) {
+                        break;
+                    }
+                    Job job = std::move(queue_.front());
+                    queue_.pop_front();
+                    lock.unlock();
+                    const std::string error = syncDirs(job.sync_dirs);
+                    lock.lock();
+                    finishJob(job, error);
+                    continue;
+                }
+                const uint32_t index = free_slots.back();
+                free_slots.pop_back();
+                Slot& slot = slots[index];
+                slot.job = std::move(queue_.front());
+                queue_.pop_front();
+                slot.busy = true;
+                slot.stage = Slot::Stage::OPEN;
+                slot.direct = config_.direct_io;
+                slot.fd = -1;
+                slot.error.clear();
+                ring_->openat(index, slot.job.path.c_str(), openFlags(slot.direct));
+                ++in_flight;
+            }
+        }
+        if (in_flight == 0) {
+            continue;
+        }
+        // 本轮新文件的openat与上一轮完成事件引出的write/close在同一次系统调用中提交
+        const int ret = ring_->submitAndWait(1);
+        if (ret < 0 && ret != -EAGAIN && ret != -EBUSY) {
+            // 环已不可用，在途请求不会再有完成事件：关闭已打开的文件，在途与排队的任务都以该错误结束，
+            // 之后本线程按线程池的方式同步写后续文件，flush 不会一直等待
+            const std::string error = std::string("io_uring_enter: ") + std::strerror(-ret);
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Slot& slot : slots) {
+                if (!slot.busy) {
+                    continue;
+                }
+                if (slot.fd >= 0) {
+                    ::close(slot.fd);
+                    slot.fd = -1;
+                }
+                finishJob(slot.job, error);
+                slot.job = Job();
+                slot.busy = false;
+            }
+            while (!queue_.empty()) {
+                finishJob(queue_.front(), error);
+                queue_.pop_front();
+            }
+            break;
+        }
+        ring_->reap([&](uint64_t index, int res) {
+            Slot& slot = slots[index];
+            if (!advance(slot, index, res)) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            finishJob(slot.job, slot.error);
+            slot.job = Job();
+            slot.busy = false;
+            free_slots.push_back(static_cast<uint32_t>(index));
+            --in_flight;
+        });
+    }
+    ring_.reset();
+    threadLoop();
+#endif
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rs_realtime {
+
+/**
+ * @brief npy文件的写入后端
+ */
+enum class WriterBackend {
+    SYNC,       // 在调用线程中逐个 open/write/close
+    AUTO,       // 优先io_uring，内核不支持或被禁用时退回线程池
+    IO_URING,   // 后台线程通过io_uring批量提交 openat/write/close（同AUTO，不可用时退回线程池）
+    THREADS     // 后台线程池 open/pwrite/close
+};
+
+/**
+ * @brief 刷盘策略
+ */
+enum class Durability {
+    NONE,           // 不主动刷盘，由内核回写
+    EVERY_N_FRAMES, // 每 sync_every 帧，等此前的文件写完后对输出所在的文件系统做一次 syncfs
+    END             // flush 时做一次 syncfs
+};
+
+/**
+ * @brief npy写入配置
+ */
+struct NpyWriterConfig {
+    WriterBackend backend = WriterBackend::SYNC;
+    bool direct_io = false;             // O_DIRECT：按4KB对齐写入后截断到实际长度，文件系统不支持时退回普通写
+    Durability durability = Durability::NONE;
+    uint32_t sync_every = 100;          // EVERY_N_FRAMES 的间隔帧数
+    uint32_t queue_depth = 64;          // io_uring 同时在途的文件数
+    uint32_t threads = 4;               // THREADS 后端的写线程数
+    size_t max_pending_bytes = 256u << 20; // 排队与在途的缓冲总量上限，超出时 prepare 阻塞
+};
+
+/**
+ * @brief npy写入计数
+ */
+struct NpyWriterStats {
+    uint64_t files = 0;                 // 写完的文件数
+    uint64_t bytes = 0;                 // 写入的字节数（含npy头部，不含O_DIRECT的对齐填充）
+    uint64_t syncs = 0;                 // syncfs 次数
+    uint64_t direct_fallbacks = 0;      // O_DIRECT 打开失败、退回普通写的文件数
+    uint64_t buffer_allocations = 0;    // 新分配的写缓冲数，稳态下不再增长
+};
+
+/**
+ * @brief 元素类型对应的npy类型描述（小端）
+ */
+template <typename T> inline const char* npyDescr();
+template <> inline const char* npyDescr<float>() { return "<f4"; }
+template <> inline const char* npyDescr<uint16_t>() { return "<u2"; }
+template <> inline const char* npyDescr<uint32_t>() { return "<u4"; }
+template <> inline const char* npyDescr<int32_t>() { return "<i4"; }
+template <> inline const char* npyDescr<uint8_t>() { return "|u1"; }
+
+/**
+ * @brief npy 1.0 格式的文件头：魔数、版本、头部长度与头部字典，补齐到64字节的整数倍
+ */
+std::string npyHeader(const char* descr, const std::vector<size_t>& shape);
+
+/**
+ * @brief 批量写npy文件
+ *
+ * prepare 从缓冲池取一块4KB对齐的缓冲并写好npy头部，调用方把数据直接填入返回的数据区后 submit，
+ * 省去一次拷贝。异步后端由后台线程完成 open/write/close，写完的缓冲回到池中复用，
+ * 缓冲经 FrameAllocator 分配（大块缓冲按 HugePageMode 使用大页），稳态下不再分配内存。
+ * io_uring 后端用原始系统调用建环（不依赖liburing），每个文件依次经过 openat -> write -> close，
+ * 各文件的请求在同一次 io_uring_enter 中批量提交。
+ * io_uring_enter 出现不可恢复的错误时，在途与排队的文件都以该错误结束，之后的文件由后台线程同步写入。
+ *
+ * prepare / submit / write / endFrame / flush 只能由一个线程调用。
+ * 写入失败时记录第一个错误，由随后的 prepare 或 flush 抛出 std::runtime_error。
+ */
+class NpyWriter {
+public:
+    explicit NpyWriter(const NpyWriterConfig& config = NpyWriterConfig());
+
+    /**
+     * @brief 等待全部文件写完（按刷盘策略刷盘），不抛出异常
+     */
+    ~NpyWriter();
+
+    NpyWriter(const NpyWriter&) = delete;
+    NpyWriter& operator=(const NpyWriter&) = delete;
+
+    /**
+     * @brief 实际使用的后端（io_uring不可用时为 THREADS）
+     */
+    WriterBackend backend() const { return backend_; }
+
+    /**
+     * @brief 准备一个文件，返回长度为 prod(shape) * itemsize 的数据区
+     *
+     * 排队的缓冲超过 max_pending_bytes 时阻塞到有文件写完。
+     */
+    void* prepare(const std::string& path, const char* descr, const std::vector<size_t>& shape, size_t itemsize);
+
+    /**
+     * @brief 提交 prepare 的文件
+     */
+    void submit();
+
+    /**
+     * @brief prepare + 拷贝 + submit
+     */
+    template <typename T>
+    void write(const std::string& path, const T* data, const std::vector<size_t>& shape) {
+        size_t count = 1;
+        for (size_t dim : shape) {
+            count *= dim;
+        }
+        void* payload = prepare(path, npyDescr<T>(), shape, sizeof(T));
+        std::copy(data, data + count, static_cast<T*>(payload));
+        submit();
+    }
+
+    /**
+     * @brief 标记一帧的文件已全部提交，EVERY_N_FRAMES 按此计数
+     */
+    void endFrame();
+
+    /**
+     * @brief 等待全部文件写完，按刷盘策略刷盘，有写入失败时抛出 std::runtime_error
+     */
+    void flush();
+
+    NpyWriterStats stats() const;
+
+private:
+    struct Buffer {
+        void* block = nullptr;          // FrameAllocator 返回的原始指针
+        char* data = nullptr;           // 4KB对齐的起点
+        size_t capacity = 0;
+    };
+
+    struct Job {
+        std::string path;
+        Buffer buffer;
+        size_t size = 0;                // 文件的实际长度
+        bool sync = false;              // 刷盘标记：等此前的文件写完后对 sync_dirs 做 syncfs
+        std::vector<std::string> sync_dirs;
+    };
+
+    struct Slot;
+    class Ring;
+
+    Buffer takeBuffer(size_t bytes);
+    void enqueue(Job job);
+    void enqueueSync();
+    void finishJob(Job& job, const std::string& error);
+    void countDirectFallback();
+    void throwIfFailed();
+    std::string writeFile(const Job& job);
+    std::string syncDirs(const std::vector<std::string>& dirs);
+    void ringLoop();
+    void threadLoop();
+
+    NpyWriterConfig config_;
+    WriterBackend backend_;
+    std::unique_ptr<Ring> ring_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;   // 后台线程等待新任务
+    std::condition_variable done_cv_;   // 调用方等待缓冲释放或全部完成
+    std::deque<Job> queue_;
+    std::vector<Buffer> free_;          // 空闲的写缓冲
+    size_t pending_bytes_ = 0;          // 排队与在途任务持有的缓冲总量
+    size_t outstanding_ = 0;            // 排队与在途的任务数
+    size_t active_ = 0;                 // 线程池中正在执行的任务数
+    bool stop_ = false;
+    std::string error_;
+    NpyWriterStats stats_;
+    std::vector<std::thread> threads_;
+
+    // 调用线程独占
+    Job current_;
+    bool prepared_ = false;
+    std::vector<std::string> unsynced_dirs_; // 上次刷盘以来写过文件的目录
+    uint64_t frames_ = 0;
+};
+
+} // namespace rs_realtime
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include "point_cloud_data.h"
+#include "pose.h"
+#include "reduced_precision.h"
+
+namespace py = pybind11;
+
+namespace rs_realtime {
+
+/**
+ * @brief 获取可写入的输出数组
+ *
+ * out为None时按shape新建；否则要求是dtype匹配、C连续、形状一致的可写数组，
+ * 直接复用其内存（不拷贝），不满足时抛出 ValueError。
+ */
+template <typename T>
+py::array_t<T, py::array::c_style> ensureOutputArray(const py::object& out,
+                                                     const std::vector<py::ssize_t>& shape) {
+    if (out.is_none()) {
+        return py::array_t<T, py::array::c_style>(shape);
+    }
+    if (!py::isinstance<py::array_t<T, py::array::c_style>>(out)) {
+        throw py::value_error("out must be a C-contiguous array of dtype " +
+                              std::string(py::str(py::dtype::of<T>())));
+    }
+    auto arr = py::reinterpret_borrow<py::array_t<T, py::array::c_style>>(out);
+    bool same_shape = arr.ndim() == static_cast<py::ssize_t>(shape.size());
+    for (size_t i = 0; same_shape && i < shape.size(); ++i) {
+        same_shape = arr.shape(static_cast<py::ssize_t>(i)) == shape[i];
+    }
+    if (!same_shape) {
+        throw py::value_error("out has an unexpected shape");
+    }
+    if (!arr.writeable()) {
+        throw py::value_error("out must be writeable");
+    }
+    return arr;
+}
+
+/**
+ * @brief 获取一组可写入的输出数组（各数组形状可不同）
+ *
+ * out为None时逐个新建；否则要求是长度一致的序列，每个元素按 ensureOutputArray 检查。
+ */
+template <typename T>
+std::vector<py::array_t<T, py::array::c_style>> ensureOutputList(
+    const py::object& out, const std::vector<std::vector<py::ssize_t>>& shapes) {
+    std::vector<py::array_t<T, py::array::c_style>> result;
+    result.reserve(shapes.size());
+    if (out.is_none()) {
+        for (const auto& shape : shapes) {
+            result.push_back(ensureOutputArray<T>(out, shape));
+        }
+        return result;
+    }
+    if (!py::isinstance<py::sequence>(out) || py::len(out) != shapes.size()) {
+        throw py::value_error("out must be a sequence of " + std::to_string(shapes.size()) + " arrays");
+    }
+    auto seq = py::reinterpret_borrow<py::sequence>(out);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        result.push_back(ensureOutputArray<T>(seq[i], shapes[i]));
+    }
+    return result;
+}
+
+/**
+ * @brief 新建 (n, 3) 坐标数组：float32 / float16，bfloat16 用 uint16 承载位模式
+ */
+inline py::array newPointArray(py::ssize_t n, OutputDType dtype) {
+    const char* format = dtype == OutputDType::FLOAT32 ? "float32"
+                         : dtype == OutputDType::FLOAT16 ? "float16"
+                                                         : "uint16";
+    return py::array(py::dtype(format), std::vector<py::ssize_t>{n, 3});
+}
+
+/**
+ * @brief 检查 (N, C) 点数组至少包含 min_cols 列，返回点数
+ */
+inline size_t checkPointArray(const py::array_t<float, py::array::c_style | py::array::forcecast>& points,
+                              py::ssize_t min_cols) {
+    if (points.ndim() != 2 || points.shape(1) < min_cols) {
+        throw py::value_error("points must have shape (N, " + std::to_string(min_cols) + "+)");
+    }
+    return static_cast<size_t>(points.shape(0));
+}
+
+/**
+ * @brief 由 R (3x3) 与 t (3,) 数组构造刚体变换
+ */
+inline RigidTransform toRigidTransform(const py::array_t<float, py::array::c_style | py::array::forcecast>& R,
+                                       const py::array_t<float, py::array::c_style | py::array::forcecast>& t) {
+    if (R.size() != 9 || t.size() != 3) {
+        throw py::value_error("R must have 9 elements and t must have 3 elements");
+    }
+    RigidTransform T;
+    std::copy(R.data(), R.data() + 9, T.R.begin());
+    std::copy(t.data(), t.data() + 3, T.t.begin());
+    return T;
+}
+
+/**
+ * @brief 聚类汇总转为dict: count (K,), centroid (K,3), min (K,3), max (K,3)
+ */
+inline py::dict clustersToDict(const FrameClusters& clusters) {
+    const auto k = static_cast<py::ssize_t>(clusters.size());
+    py::dict result;
+    result["count"] = py::array_t<uint32_t>(k, clusters.count.data());
+    result["centroid"] = py::array_t<float>({k, static_cast<py::ssize_t>(3)}, clusters.centroid.data());
+    result["min"] = py::array_t<float>({k, static_cast<py::ssize_t>(3)}, clusters.min.data());
+    result["max"] = py::array_t<float>({k, static_cast<py::ssize_t>(3)}, clusters.max.data());
+    return result;
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,253 @@
+#include "outlier_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rs_realtime {
+
+namespace {
+
+// 每个任务块处理的体素数
+constexpr size_t kCellGrain = 256;
+// 统计过滤的稠密区域使用边长为搜索半径 1/kShellSteps 的细体素，由内向外逐层扩展搜索
+constexpr int32_t kShellSteps = 3;
+// 粗体素27邻域内点数超过该值时视为稠密区域
+constexpr uint32_t kDenseNeighborhood = 256;
+
+// 点到体素 (cx, cy, cz) 包围盒的最小距离平方
+inline float cellDistance2(int32_t cx, int32_t cy, int32_t cz, float size, float px, float py, float pz) {
+    auto axis = [size](int32_t c, float p) {
+        const float lo = static_cast<float>(c) * size;
+        const float d = p < lo ? lo - p : (p > lo + size ? p - lo - size : 0.f);
+        return d * d;
+    };
+    return axis(cx, px) + axis(cy, py) + axis(cz, pz);
+}
+
+} // namespace
+
+OutlierFilter::OutlierFilter(ThreadPool& pool)
+    : pool_(pool) {
+}
+
+size_t OutlierFilter::computeMask(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                  uint8_t* keep) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return computeMaskLocked(x, y, z, n, stride, keep);
+}
+
+size_t OutlierFilter::computeMaskLocked(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                                        uint8_t* keep) {
+    if (config_.method == OutlierMethod::NONE) {
+        // 未启用时只剔除NaN点
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            keep[i] = std::isfinite(x[i * stride]) && std::isfinite(y[i * stride]) && std::isfinite(z[i * stride]);
+            count += keep[i];
+        }
+        return count;
+    }
+
+    std::fill(keep, keep + n, 0);
+    if (config_.method == OutlierMethod::RADIUS) {
+        grid_.build(x, y, z, n, stride, std::max(config_.radius, 1e-3f));
+        radiusMask(keep);
+    } else {
+        const float search_radius = std::max(config_.search_radius, 1e-3f);
+        grid_.build(x, y, z, n, stride, search_radius);
+        fine_grid_.build(x, y, z, n, stride, search_radius / static_cast<float>(kShellSteps));
+        statisticalMask(n, keep);
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += keep[i];
+    }
+    return count;
+}
+
+void OutlierFilter::radiusMask(uint8_t* keep) {
+    const float r2 = config_.radius * config_.radius;
+    // 自身距离为0，也会被计入
+    const uint32_t need = config_.min_neighbors + 1;
+    const float* sx = grid_.sortedX();
+    const float* sy = grid_.sortedY();
+    const float* sz = grid_.sortedZ();
+    const uint32_t* sorted_index = grid_.sortedIndex();
+
+    pool_.parallelFor(grid_.numCells(), kCellGrain, [&](size_t begin, size_t end, size_t) {
+        uint32_t neighbors[27];
+        for (size_t c = begin; c < end; ++c) {
+            const uint32_t cell = static_cast<uint32_t>(c);
+            const size_t num_neighbors = grid_.neighborCells(cell, neighbors);
+            for (uint32_t pos = grid_.cellBegin(cell); pos < grid_.cellEnd(cell); ++pos) {
+                const float px = sx[pos];
+                const float py = sy[pos];
+                const float pz = sz[pos];
+                uint32_t count = 0;
+                for (size_t k = 0; k < num_neighbors && count < need; ++k) {
+                    const uint32_t q_end = grid_.cellEnd(neighbors[k]);
+                    for (uint32_t q = grid_.cellBegin(neighbors[k]); q < q_end; ++q) {
+                        const float dx = sx[q] - px;
+                        const float dy = sy[q] - py;
+                        const float dz = sz[q] - pz;
+                        if (dx * dx + dy * dy + dz * dz <= r2 && ++count >= need) {
+                            break;
+                        }
+                    }
+                }
+                keep[sorted_index[pos]] = count >= need ? 1 : 0;
+            }
+        }
+    });
+}
+
+void OutlierFilter::statisticalMask(size_t n, uint8_t* keep) {
+    const uint32_t k = std::max<uint32_t>(1, std::min(config_.k, kMaxK));
+    const float search_radius = grid_.cellSize();
+    const float r2 = search_radius * search_radius;
+    const float fine_size = fine_grid_.cellSize();
+
+    mean_distance_.resize(n);
+    partial_sum_.assign(pool_.size(), 0.0);
+    partial_sq_sum_.assign(pool_.size(), 0.0);
+    partial_count_.assign(pool_.size(), 0);
+
+    // 第一步：每个点的k近邻平均距离，同时按线程累加全局统计量。
+    // 按粗体素（边长=搜索半径）并行：稀疏区域直接扫描粗体素27邻域；
+    // 稠密区域改用细体素逐层外扩，第r层覆盖到距离 r*fine_size，第k近邻已在覆盖范围内时停止。
+    pool_.parallelFor(grid_.numCells(), kCellGrain, [&](size_t begin, size_t end, size_t worker) {
+        uint32_t neighbors[27];
+        float best[kMaxK];
+        double sum = 0.0;
+        double sq_sum = 0.0;
+        size_t count = 0;
+
+        auto scan = [&](const VoxelHashGrid& grid, uint32_t cell, uint32_t self,
+                        float px, float py, float pz, uint32_t& found) {
+            const float* sx = grid.sortedX();
+            const float* sy = grid.sortedY();
+            const float* sz = grid.sortedZ();
+            const uint32_t* sorted_index = grid.sortedIndex();
+            const uint32_t q_end = grid.cellEnd(cell);
+            for (uint32_t q = grid.cellBegin(cell); q < q_end; ++q) {
+                const float dx = sx[q] - px;
+                const float dy = sy[q] - py;
+                const float dz = sz[q] - pz;
+                const float d2 = dx * dx + dy * dy + dz * dz;
+                if (d2 > r2 || (found == k && d2 >= best[k - 1]) || sorted_index[q] == self) {
+                    continue;
+                }
+                // 插入有序的k近邻表
+                uint32_t slot = found < k ? found++ : k - 1;
+                while (slot > 0 && best[slot - 1] > d2) {
+                    best[slot] = best[slot - 1];
+                    --slot;
+                }
+                best[slot] = d2;
+            }
+        };
+
+        for (size_t c = begin; c < end; ++c) {
+            const uint32_t cell = static_cast<uint32_t>(c);
+            const size_t num_neighbors = grid_.neighborCells(cell, neighbors);
+            uint32_t neighborhood = 0;
+            for (size_t j = 0; j < num_neighbors; ++j) {
+                neighborhood += grid_.cellEnd(neighbors[j]) - grid_.cellBegin(neighbors[j]);
+            }
+            const bool dense = neighborhood > kDenseNeighborhood;
+
+            for (uint32_t pos = grid_.cellBegin(cell); pos < grid_.cellEnd(cell); ++pos) {
+                const uint32_t self = grid_.sortedIndex()[pos];
+                const float px = grid_.sortedX()[pos];
+                const float py = grid_.sortedY()[pos];
+                const float pz = grid_.sortedZ()[pos];
+                uint32_t found = 0;
+                if (!dense) {
+                    for (size_t j = 0; j < num_neighbors; ++j) {
+                        scan(grid_, neighbors[j], self, px, py, pz, found);
+                    }
+                } else {
+                    const int32_t* coord = fine_grid_.cellCoord(fine_grid_.pointCell(self));
+                    for (int32_t ring = 0; ring <= kShellSteps; ++ring) {
+                        for (int32_t dx = -ring; dx <= ring; ++dx) {
+                            for (int32_t dy = -ring; dy <= ring; ++dy) {
+                                // 只遍历第ring层壳上的体素
+                                const bool on_face = dx == -ring || dx == ring || dy == -ring || dy == ring;
+                                const int32_t dz_step = on_face ? 1 : std::max(1, 2 * ring);
+                                for (int32_t dz = -ring; dz <= ring; dz += dz_step) {
+                                    // 体素到点的最小距离已超过当前第k近邻时跳过
+                                    if (found == k && cellDistance2(coord[0] + dx, coord[1] + dy, coord[2] + dz,
+                                                                    fine_size, px, py, pz) >= best[k - 1]) {
+                                        continue;
+                                    }
+                                    const uint32_t nc = fine_grid_.findCell(coord[0] + dx, coord[1] + dy, coord[2] + dz);
+                                    if (nc != VoxelHashGrid::kInvalidCell) {
+                                        scan(fine_grid_, nc, self, px, py, pz, found);
+                                    }
+                                }
+                            }
+                        }
+                        const float covered = static_cast<float>(ring) * fine_size;
+                        if (found == k && best[k - 1] <= covered * covered) {
+                            break;
+                        }
+                    }
+                }
+
+                float total = static_cast<float>(k - found) * search_radius;
+                for (uint32_t j = 0; j < found; ++j) {
+                    total += std::sqrt(best[j]);
+                }
+                const float mean = total / static_cast<float>(k);
+                mean_distance_[self] = mean;
+                sum += mean;
+                sq_sum += static_cast<double>(mean) * mean;
+                ++count;
+            }
+        }
+        partial_sum_[worker] += sum;
+        partial_sq_sum_[worker] += sq_sum;
+        partial_count_[worker] += count;
+    });
+
+    double sum = 0.0;
+    double sq_sum = 0.0;
+    size_t count = 0;
+    for (size_t w = 0; w < partial_sum_.size(); ++w) {
+        sum += partial_sum_[w];
+        sq_sum += partial_sq_sum_[w];
+        count += partial_count_[w];
+    }
+    if (count == 0) {
+        return;
+    }
+    const double mean = sum / static_cast<double>(count);
+    const double variance = std::max(0.0, sq_sum / static_cast<double>(count) - mean * mean);
+    const float threshold = static_cast<float>(mean + config_.std_ratio * std::sqrt(variance));
+
+    // 第二步：按阈值判定，NaN点不在索引中，保持为0
+    for (size_t i = 0; i < n; ++i) {
+        if (grid_.pointCell(i) != VoxelHashGrid::kInvalidCell) {
+            keep[i] = mean_distance_[i] <= threshold ? 1 : 0;
+        }
+    }
+}
+
+size_t OutlierFilter::apply(PointCloudData& cloud) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (config_.method == OutlierMethod::NONE) {
+        return cloud.point_count;
+    }
+    const size_t n = cloud.point_count;
+    mask_.resize(n);
+    const size_t inliers = computeMaskLocked(cloud.x.data(), cloud.y.data(), cloud.z.data(), n, 1, mask_.data());
+    if (config_.return_mask) {
+        cloud.inlier.assign(mask_.begin(), mask_.end());
+    } else {
+        cloud.compact(mask_.data());
+    }
+    return inliers;
+}
+
+} // namespace rs_realtime
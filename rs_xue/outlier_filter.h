@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "point_cloud_data.h"
+#include "thread_pool.h"
+#include "voxel_grid.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 离群点过滤方法
+ */
+enum class OutlierMethod {
+    NONE,           // 不过滤
+    RADIUS,         // 半径过滤：radius内邻居数不足 min_neighbors 的点为离群点
+    STATISTICAL     // 统计过滤：k近邻平均距离超过 全局均值 + std_ratio*标准差 的点为离群点
+};
+
+/**
+ * @brief 离群点过滤配置
+ */
+struct OutlierFilterConfig {
+    OutlierMethod method = OutlierMethod::NONE;
+    float radius = 0.5f;            // 半径过滤的邻域半径（米）
+    uint32_t min_neighbors = 2;     // 半径过滤所需的最少邻居数（不含自身）
+    uint32_t k = 8;                 // 统计过滤的近邻数，上限为 kMaxK
+    float std_ratio = 1.0f;         // 统计过滤的标准差倍数
+    float search_radius = 1.0f;     // 统计过滤的近邻搜索半径，范围内不足k个邻居时缺失部分按该半径计
+    bool return_mask = false;       // true 只输出内点掩码，false 压缩掉离群点
+};
+
+/**
+ * @brief 并行的半径/统计离群点过滤
+ *
+ * 近邻搜索基于体素分桶：体素边长取搜索半径，每个点只需扫描相邻27个体素。
+ * 按体素并行，同一体素内的点共享一次相邻体素查找；统计过滤在稠密区域改用细体素
+ * 由内向外搜索，避免扫描大量远处的点。NaN点一律视为离群点。
+ */
+class OutlierFilter {
+public:
+    static constexpr uint32_t kMaxK = 32;
+
+    explicit OutlierFilter(ThreadPool& pool = ThreadPool::global());
+
+    void setConfig(const OutlierFilterConfig& config) { config_ = config; }
+    const OutlierFilterConfig& config() const { return config_; }
+
+    /**
+     * @brief 计算内点掩码
+     *
+     * @param keep 输出，长度n，内点为1
+     * @return 内点数量
+     */
+    size_t computeMask(const float* x, const float* y, const float* z, size_t n, size_t stride, uint8_t* keep);
+
+    /**
+     * @brief 对一帧点云执行过滤：按配置压缩离群点，或把掩码写入 cloud.inlier
+     *
+     * @return 内点数量
+     */
+    size_t apply(PointCloudData& cloud);
+
+private:
+    size_t computeMaskLocked(const float* x, const float* y, const float* z, size_t n, size_t stride, uint8_t* keep);
+    void radiusMask(uint8_t* keep);
+    void statisticalMask(size_t n, uint8_t* keep);
+
+    OutlierFilterConfig config_;
+    ThreadPool& pool_;
+    std::mutex mutex_;              // 保护跨帧复用的缓冲
+
+    VoxelHashGrid grid_;            // 边长为搜索半径的体素
+    VoxelHashGrid fine_grid_;       // 统计过滤稠密区域使用的细体素
+    std::vector<float> mean_distance_;
+    std::vector<uint8_t> mask_;
+    std::vector<double> partial_sum_;
+    std::vector<double> partial_sq_sum_;
+    std::vector<size_t> partial_count_;
+};
+
+} // namespace rs_realtime
@@ -34,6 +34,33 @@ void exceptionCallback(const Error& code)
   exit(1);
 }
 
+void ConvertStreamState::onException(const Error& code)
+{
+  // 与 PcapFrameSource 相同：文件读完或出错时结束，由处理线程收尾，不退出进程
+  if (code.error_code != ERRCODE_PCAPEXIT)
+  {
+    RS_WARNING << code.toString() << RS_REND;
+  }
+  if (code.error_code == ERRCODE_PCAPEXIT || code.error_code_type == ErrCodeType::ERROR_CODE)
+  {
+    if (code.error_code != ERRCODE_PCAPEXIT)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (error_.empty())
+      {
+        error_ = code.toString();
+      }
+    }
+    ended_.store(true);
+  }
+}
+
+std::string ConvertStreamState::error() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
+
 void saveNpy(const std::string& path,
              const float* data,
              const std::vector<size_t>& shape)
@@ -41,81 +68,310 @@ void saveNpy(const std::string& path,
     cnpy::npy_save(path, data, shape, "w");   // "w" = 覆盖写
 }
 
-void processCloud(const std::string& output_dir, int num_frames)
+void writeNpyPoints(rs_realtime::NpyWriter& writer,
+                    const std::string& path,
+                    const float* x,
+                    const float* y,
+                    const float* z,
+                    size_t n,
+                    rs_realtime::OutputDType dtype)
+{
+    // 交错与降精度转换在同一遍完成，直接写进写入缓冲；bfloat16 以 uint16 位模式保存（npy没有对应的类型）
+    const char* descr = dtype == rs_realtime::OutputDType::FLOAT32 ? "<f4"
+                        : dtype == rs_realtime::OutputDType::FLOAT16 ? "<f2" : "<u2";
+    void* payload = writer.prepare(path, descr, {n, 3}, rs_realtime::dtypeSize(dtype));
+    rs_realtime::packPoints(x, y, z, n, dtype, payload);
+    writer.submit();
+}
+
+void processCloud(const std::string& output_dir, int num_frames, const ConvertOptions& options,
+                  const ConvertStreamState* stream)
 {
+    // 不做标定，坐标按列取出后写入；列缓冲跨帧复用，写入后端与 convert_pcap_with_calib 相同
+    std::vector<float> x, y, z;
+    rs_realtime::NpyWriter writer(options.writer);
     while (true) {
-        std::shared_ptr<PointCloudMsg> msg = stuffed_cloud_queue.popWait();
-        if (!msg) continue;
+        // 结束标记在驱动送出最后一帧之后才置位，取到结束标记后队列为空即已取完
+        const bool ended = stream && stream->ended();
+        std::shared_ptr<PointCloudMsg> msg = ended ? stuffed_cloud_queue.pop() : stuffed_cloud_queue.popWait();
+        if (!msg) {
+            if (ended) break;
+            continue;
+        }
         const size_t N = msg->points.size();
         RS_MSG << "msg: " << msg->seq << " point cloud size: " << msg->points.size() << RS_REND; 
-        std::vector<float> buf(N * 3);
+        x.resize(N);
+        y.resize(N);
+        z.resize(N);
         for (size_t i = 0; i < N; ++i) {
-            buf[i*3+0] = msg->points[i].x;
-            buf[i*3+1] = msg->points[i].y;
-            buf[i*3+2] = msg->points[i].z;
+            x[i] = msg->points[i].x;
+            y[i] = msg->points[i].y;
+            z[i] = msg->points[i].z;
         }
         std::ostringstream oss;
         oss << output_dir << "/cloud_"
             << std::setw(6) << std::setfill('0') << msg->seq << "_"
             << std::fixed << std::setprecision(6) << msg->points.front().timestamp
             << ".npy";
-        saveNpy(oss.str(), buf.data(), {N, 3});
+        writeNpyPoints(writer, oss.str(), x.data(), y.data(), z.data(), N, options.dtype);
+        writer.endFrame();
         free_cloud_queue.push(msg);
         if(msg->seq > num_frames) break;
     }
+    // 等待全部文件写完并按刷盘策略刷盘，写入失败时抛出
+    writer.flush();
 }
 
-void processCloudWithCalib(const std::string& output_dir,
-                           const float* R,
-                           const float* t,
-                           const float* ranges,
-                           int num_frames)
+CalibFrameProcessor::CalibFrameProcessor(const float* R, const float* t, const float* ranges,
+                                         const ConvertOptions& options, uint32_t fields)
+    : fields_(fields)
 {
-    float x_min = ranges[0];
-    float x_max = ranges[1];
-    float y_min = ranges[2];
-    float y_max = ranges[3];
-    float z_min = ranges[4];
-    float z_max = ranges[5];
+    std::copy(R, R + 9, calib_.R.begin());
+    std::copy(t, t + 3, calib_.t.begin());
+    std::copy(ranges, ranges + 6, ranges_.begin());
 
-    while (true)
+    // 运动补偿：位姿整体从文件加载
+    if (!options.pose_file.empty())
+    {
+        size_t loaded = poses_.loadFromFile(options.pose_file);
+        RS_MSG << "loaded " << loaded << " poses from " << options.pose_file << RS_REND;
+        rs_realtime::DeskewConfig config;
+        config.enabled = loaded > 0;
+        config.bucket_us = options.deskew_bucket_us;
+        deskewer_.setConfig(config);
+        if (config.enabled)
+        {
+            fields_ |= rs_realtime::FIELD_TIMESTAMP;
+        }
+    }
+    if (options.drop_invalid)
+    {
+        fields_ |= rs_realtime::CONVERT_DROP_INVALID;
+    }
+    if (options.scan_index)
+    {
+        fields_ |= rs_realtime::FIELD_SCAN_INDEX;
+    }
+    outlier_filter_.setConfig(options.outlier);
+    ground_segmenter_.setConfig(options.ground);
+    normal_estimator_.setConfig(options.normals);
+    clusterer_.setConfig(options.clustering);
+    change_detector_.setConfig(options.change);
+}
+
+void CalibFrameProcessor::process(const PointCloudMsg& msg, rs_realtime::PointCloudData& cloud)
+{
+    const size_t N = msg.points.size();
+    // 按标定类别与字段组合分派到特化内核，剔除无效点时输出点数可能少于N
+    rs_realtime::convertPoints<PointT>(msg.points.data(), N, calib_, fields_, cloud);
+    const size_t M = cloud.point_count;
+    cloud.inlier.clear();
+    cloud.ground.clear();
+    cloud.normal_x.clear();
+    cloud.normal_y.clear();
+    cloud.normal_z.clear();
+    cloud.curvature.clear();
+    cloud.cluster.clear();
+    cloud.clusters.clear();
+    cloud.change.clear();
+    cloud.frame_id = msg.seq;
+    cloud.frame_timestamp = msg.timestamp;
+
+    // 运动补偿在范围过滤之前进行
+    deskewer_.apply(poses_, cloud);
+
+    // 范围过滤：原地压缩，后续阶段只处理范围内的点
+    const float x_min = ranges_[0];
+    const float x_max = ranges_[1];
+    const float y_min = ranges_[2];
+    const float y_max = ranges_[3];
+    const float z_min = ranges_[4];
+    const float z_max = ranges_[5];
+    keep_.resize(M);
+    for (size_t i = 0; i < M; ++i)
     {
-        std::shared_ptr<PointCloudMsg> msg = stuffed_cloud_queue.popWait();
+        float x_new = cloud.x[i];
+        float y_new = cloud.y[i];
+        float z_new = cloud.z[i];
 
-        const size_t N = msg->points.size();
-        RS_MSG << "msg: " << msg->seq << " point cloud size: " << msg->points.size() << RS_REND;
+        keep_[i] = x_new >= x_min && x_new <= x_max &&
+                   y_new >= y_min && y_new <= y_max &&
+                   z_new >= z_min && z_new <= z_max;
+    }
+    cloud.compact(keep_.data());
 
-        std::vector<float> buf;
-        buf.reserve(N * 3);
+    outlier_filter_.apply(cloud);
+    ground_segmenter_.apply(cloud);
+    normal_estimator_.apply(cloud);
+    clusterer_.apply(cloud);
+    change_detector_.apply(poses_, cloud);
+}
 
-        for (size_t i = 0; i < N; ++i)
+PcapFrameSource::PcapFrameSource(const std::string& pcap_path, const float* R, const float* t,
+                                 const float* ranges, int num_frames, const ConvertOptions& options)
+    : processor_(R, t, ranges, options, rs_realtime::FIELD_ALL),
+      finished_(false),
+      stopping_(false),
+      started_(false),
+      num_frames_(num_frames),
+      emitted_(0)
+{
+    RSDriverParam param;
+    param.input_type = InputType::PCAP_FILE;
+    param.input_param.pcap_path = pcap_path;
+    param.input_param.msop_port = 6699;
+    param.input_param.pcap_repeat = false;
+    param.input_param.difop_port = 7788;
+    param.lidar_type = LidarType::RSEM4;
+    driver_.regPointCloudCallback(
+        [this]() {
+            std::shared_ptr<PointCloudMsg> msg = free_queue_.pop();
+            return msg ? msg : std::make_shared<PointCloudMsg>();
+        },
+        [this](std::shared_ptr<PointCloudMsg> msg) {
+            // 背压：队列满时让驱动的解析线程等待消费方取帧
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return stopping_ || stuffed_queue_.size() < kMaxQueuedFrames; });
+            if (stopping_)
+            {
+                return;
+            }
+            stuffed_queue_.push_back(std::move(msg));
+            queue_cv_.notify_all();
+        });
+    driver_.regExceptionCallback([this](const Error& code) {
+        // 文件读完或出错时结束流，不退出进程；错误在已到达的帧取完后由 next 抛出
+        if (code.error_code != ERRCODE_PCAPEXIT)
         {
-            float x = msg->points[i].x;
-            float y = msg->points[i].y;
-            float z = msg->points[i].z;
+            RS_WARNING << code.toString() << RS_REND;
+        }
+        if (code.error_code == ERRCODE_PCAPEXIT || code.error_code_type == ErrCodeType::ERROR_CODE)
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (code.error_code != ERRCODE_PCAPEXIT && error_.empty())
+            {
+                error_ = code.toString();
+            }
+            finished_ = true;
+            queue_cv_.notify_all();
+        }
+    });
+    if (!driver_.init(param))
+    {
+        throw std::runtime_error("Driver Initialize Error: " + pcap_path);
+    }
+}
 
-            float x_new = R[0] * x + R[1] * y + R[2] * z + t[0];
-            float y_new = R[3] * x + R[4] * y + R[5] * z + t[1];
-            float z_new = R[6] * x + R[7] * y + R[8] * z + t[2];
+PcapFrameSource::~PcapFrameSource()
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    driver_.stop();
+}
 
-            if (x_new >= x_min && x_new <= x_max &&
-                y_new >= y_min && y_new <= y_max &&
-                z_new >= z_min && z_new <= z_max)
+bool PcapFrameSource::next(rs_realtime::PointCloudData& cloud)
+{
+    if (num_frames_ > 0 && emitted_ >= num_frames_)
+    {
+        return false;
+    }
+    if (!started_)
+    {
+        driver_.start();
+        started_ = true;
+    }
+    std::shared_ptr<PointCloudMsg> msg;
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        queue_cv_.wait(lock, [this] { return !stuffed_queue_.empty() || finished_; });
+        if (stuffed_queue_.empty())
+        {
+            if (!error_.empty())
             {
-                buf.push_back(x_new);
-                buf.push_back(y_new);
-                buf.push_back(z_new);
+                throw std::runtime_error("pcap stream failed: " + error_);
             }
+            return false;
         }
+        msg = std::move(stuffed_queue_.front());
+        stuffed_queue_.pop_front();
+        queue_cv_.notify_all();
+    }
+    processor_.process(*msg, cloud);
+    free_queue_.push(msg);
+    ++emitted_;
+    return true;
+}
 
-        if (!buf.empty())
+void processCloudWithCalib(const std::string& output_dir,
+                           const float* R,
+                           const float* t,
+                           const float* ranges,
+                           int num_frames,
+                           const ConvertOptions& options,
+                           const ConvertStreamState* stream)
+{
+    // 文件只保存坐标，不解码强度
+    CalibFrameProcessor processor(R, t, ranges, options, 0);
+
+    // 跨帧复用的标定结果；写入缓冲由 writer 复用，异步后端在后台线程中落盘
+    rs_realtime::PointCloudData cloud;
+    rs_realtime::NpyWriter writer(options.writer);
+
+    while (true)
+    {
+        // 结束标记在驱动送出最后一帧之后才置位，取到结束标记后队列为空即已取完
+        const bool ended = stream && stream->ended();
+        std::shared_ptr<PointCloudMsg> msg = ended ? stuffed_cloud_queue.pop() : stuffed_cloud_queue.popWait();
+        if (!msg)
+        {
+            if (ended)
+                break;
+            continue;
+        }
+
+        RS_MSG << "msg: " << msg->seq << " point cloud size: " << msg->points.size() << RS_REND;
+
+        processor.process(*msg, cloud);
+
+        const size_t M = cloud.point_count;
+        if (M > 0)
         {
             std::ostringstream oss;
             oss << output_dir << "/cloud_"
                 << std::setw(6) << std::setfill('0') << msg->seq << "_"
-                << std::fixed << std::setprecision(6) << msg->points.front().timestamp
-                << ".npy";
-            saveNpy(oss.str(), buf.data(), {buf.size() / 3, 3});
+                << std::fixed << std::setprecision(6) << msg->points.front().timestamp;
+            const std::string base = oss.str();
+            writeNpyPoints(writer, base + ".npy", cloud.x.data(), cloud.y.data(), cloud.z.data(), M, options.dtype);
+            if (cloud.inlier.size() == M)
+            {
+                writer.write(base + "_inlier.npy", cloud.inlier.data(), {M});
+            }
+            if (cloud.ground.size() == M)
+            {
+                writer.write(base + "_ground.npy", cloud.ground.data(), {M});
+            }
+            if (cloud.scan_index.size() == M)
+            {
+                writer.write(base + "_index.npy", cloud.scan_index.data(), {M});
+            }
+            if (cloud.normal_x.size() == M)
+            {
+                writeNpyPoints(writer, base + "_normal.npy", cloud.normal_x.data(), cloud.normal_y.data(),
+                               cloud.normal_z.data(), M, options.dtype);
+                writer.write(base + "_curvature.npy", cloud.curvature.data(), {M});
+            }
+            if (cloud.cluster.size() == M)
+            {
+                writer.write(base + "_cluster.npy", cloud.cluster.data(), {M});
+            }
+            if (cloud.change.size() == M)
+            {
+                writer.write(base + "_change.npy", cloud.change.data(), {M});
+            }
+            writer.endFrame();
         }else{
             RS_MSG << "msg: empty buffer" << RS_REND;
         }
@@ -124,9 +380,12 @@ void processCloudWithCalib(const std::string& output_dir,
         if (msg->seq > num_frames)
             break;
     }
+    // 等待全部文件写完并按刷盘策略刷盘，写入失败时抛出
+    writer.flush();
 }
 
-int convert_pcap(const std::string& from_name, const std::string& to_name, int num_frames) {
+int convert_pcap(const std::string& from_name, const std::string& to_name, int num_frames,
+                 const ConvertOptions& options) {
   RS_TITLE << "------------------------------------------------------" << RS_REND;
   RS_TITLE << "            RS_Driver Core Version: v" << getDriverVersion() << RS_REND;
   RS_TITLE << "------------------------------------------------------" << RS_REND;
@@ -143,19 +402,41 @@ int convert_pcap(const std::string& from_name, const std::string& to_name, int n
   driver.regPointCloudCallback(driverGetPointCloudFromCallerCallback,
                                driverReturnPointCloudToCallerCallback);  ///< Register the point cloud callback
                                                                          ///< functions
-  driver.regExceptionCallback(exceptionCallback);                        ///< Register the exception callback function
+  ConvertStreamState stream;
+  driver.regExceptionCallback([&stream](const Error& code) { stream.onException(code); });  ///< Register the exception
+                                                                                             ///< callback function
   if (!driver.init(param))                                               ///< Call the init function
   {
     RS_ERROR << "Driver Initialize Error..." << RS_REND;
     return -1;
   }
-  std::thread cloud_handle_thread = std::thread(processCloud, to_name, num_frames);
+  // 处理线程中的写入错误带回调用线程再抛出
+  std::exception_ptr error;
+  std::thread cloud_handle_thread = std::thread([&]() {
+    try
+    {
+      processCloud(to_name, num_frames, options, &stream);
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+  });
 
   driver.start();  ///< The driver thread will start
 
   RS_DEBUG << "RoboSense Lidar-Driver Linux pcap demo start......" << RS_REND;
   cloud_handle_thread.join();
   driver.stop();
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+  const std::string driver_error = stream.error();
+  if (!driver_error.empty())
+  {
+    throw std::runtime_error("pcap conversion failed: " + driver_error);
+  }
   return 0;
 }
 
@@ -164,7 +445,8 @@ int convert_pcap_with_calib(const std::string& from_name,
                             const py::array_t<float>& R,
                             const py::array_t<float>& t,
                             const py::array_t<float>& ranges,
-                            int num_frames)
+                            int num_frames,
+                            const ConvertOptions& options)
 {
     const float* R_data = static_cast<const float*>(R.request().ptr);
     const float* t_data = static_cast<const float*>(t.request().ptr);
@@ -184,16 +466,56 @@ int convert_pcap_with_calib(const std::string& from_name,
     param.print();
     LidarDriver<PointCloudMsg> driver;
     driver.regPointCloudCallback(driverGetPointCloudFromCallerCallback, driverReturnPointCloudToCallerCallback);
-    driver.regExceptionCallback(exceptionCallback);
+    // 文件读完时只结束处理循环，让异步写入的文件写完并刷盘
+    ConvertStreamState stream;
+    driver.regExceptionCallback([&stream](const Error& code) { stream.onException(code); });
     if (!driver.init(param))
     {
         RS_ERROR << "Driver Initialize Error..." << RS_REND;
         return -1;
     }
-    std::thread cloud_handle_thread = std::thread(processCloudWithCalib, to_name, R_data, t_data, ranges_data, num_frames);
+    // 处理线程中的写入错误带回调用线程再抛出
+    std::exception_ptr error;
+    std::thread cloud_handle_thread = std::thread([&]() {
+        try
+        {
+            processCloudWithCalib(to_name, R_data, t_data, ranges_data, num_frames, options, &stream);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    });
     driver.start();
     RS_DEBUG << "RoboSense Lidar-Driver Linux pcap demo start......" << RS_REND;
     cloud_handle_thread.join();
     driver.stop();
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    const std::string driver_error = stream.error();
+    if (!driver_error.empty())
+    {
+        throw std::runtime_error("pcap conversion failed: " + driver_error);
+    }
     return 0;
-}
\ No newline at end of file
+}
+rs_realtime::ArrowStreamHandle pcap_arrow_stream(const std::string& from_name,
+                                                 const py::array_t<float>& R,
+                                                 const py::array_t<float>& t,
+                                                 const py::array_t<float>& ranges,
+                                                 int num_frames,
+                                                 const ConvertOptions& options)
+{
+    if (R.size() != 9 || t.size() != 3 || ranges.size() != 6)
+    {
+        throw py::value_error("R must have 9 elements, t 3 elements and ranges 6 elements");
+    }
+    // 标定参数在构造时拷贝，帧源由流独占，流释放时停止驱动
+    auto source = std::make_shared<PcapFrameSource>(from_name, R.data(), t.data(), ranges.data(), num_frames, options);
+    return rs_realtime::makeArrowStream([source]() {
+        auto cloud = std::make_shared<rs_realtime::PointCloudData>();
+        return source->next(*cloud) ? cloud : nullptr;
+    });
+}
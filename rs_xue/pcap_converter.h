@@ -1,7 +1,13 @@
 #ifndef PCAP_CONVERTER_H
 #define PCAP_CONVERTER_H
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <iostream>
+#include <stdexcept>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -10,20 +16,145 @@
 #include <thread>
 #include <iomanip>
 #include <sstream>
-#include <rs_driver/api/lidar_driver.hpp>
+#include "lidar_point.h"
 #include "cnpy.h"
+#include "point_cloud_data.h"
+#include "point_conversion.h"
+#include "pose.h"
+#include "deskew.h"
+#include "outlier_filter.h"
+#include "ground_segmenter.h"
+#include "euclidean_clusterer.h"
+#include "normal_estimator.h"
+#include "change_detector.h"
+#include "reduced_precision.h"
+#include "npy_writer.h"
+#include "arrow_export.h"
+#include "arrow_python.h"
 
-#ifdef ENABLE_PCL_POINTCLOUD
-#include <rs_driver/msg/pcl_point_cloud_msg.hpp>
-#else
-#include <rs_driver/msg/point_cloud_msg.hpp>
-#endif
-
-typedef PointXYZIT PointT;
-typedef PointCloudT<PointT> PointCloudMsg;
 using namespace robosense::lidar;
 namespace py = pybind11;
 
+/**
+ * @brief PCAP转换的可选处理阶段配置
+ *
+ * convert_pcap 不做标定与后处理，只使用其中的坐标精度与写入配置。
+ */
+struct ConvertOptions {
+    std::string pose_file;            // 位姿文件（TUM格式），非空时启用运动补偿
+    double deskew_bucket_us = 1000.0; // 运动补偿时间桶长度（微秒）
+    rs_realtime::OutlierFilterConfig outlier; // 离群点过滤，掩码模式下另存 *_inlier.npy
+    rs_realtime::GroundSegmentationConfig ground; // 地面分割，标签模式下另存 *_ground.npy
+    rs_realtime::NormalEstimationConfig normals; // 法向估计，另存 *_normal.npy 与 *_curvature.npy
+    rs_realtime::ClusteringConfig clustering; // 欧氏聚类，标签另存 *_cluster.npy
+    rs_realtime::ChangeDetectionConfig change; // 帧间变化检测（按帧顺序与前几帧比较），标签另存 *_change.npy
+    bool drop_invalid = false;        // 转换时丢弃坐标含NaN/Inf的点
+    bool scan_index = false;          // 输出每个点在原始帧中的下标，另存 *_index.npy
+    rs_realtime::OutputDType dtype = rs_realtime::OutputDType::FLOAT32; // 坐标与法向文件的保存精度
+    rs_realtime::NpyWriterConfig writer; // 输出文件的写入后端、O_DIRECT 与刷盘策略
+};
+
+/**
+ * @brief PCAP帧的标定与后处理：标定、运动补偿、范围过滤、离群点过滤、地面分割、法向估计、聚类、变化检测
+ *
+ * 各阶段的中间缓冲跨帧复用，文件转换与Arrow流共用同一条处理链。
+ * 只解码输出与后续阶段需要的字段（运动补偿启用时自动加上时间戳）。
+ */
+class CalibFrameProcessor {
+public:
+    /**
+     * @param fields 需要输出的 rs_realtime::PointField 组合，x/y/z 总是输出
+     */
+    CalibFrameProcessor(const float* R, const float* t, const float* ranges, const ConvertOptions& options,
+                        uint32_t fields);
+
+    /**
+     * @brief 处理一帧，结果写入cloud（复用其内存）
+     */
+    void process(const PointCloudMsg& msg, rs_realtime::PointCloudData& cloud);
+
+private:
+    rs_realtime::RigidTransform calib_;
+    std::array<float, 6> ranges_;    // x_min, x_max, y_min, y_max, z_min, z_max
+    uint32_t fields_;
+    rs_realtime::PoseBuffer poses_;
+    rs_realtime::Deskewer deskewer_;
+    rs_realtime::OutlierFilter outlier_filter_;
+    rs_realtime::GroundSegmenter ground_segmenter_;
+    rs_realtime::NormalEstimator normal_estimator_;
+    rs_realtime::EuclideanClusterer clusterer_;
+    rs_realtime::ChangeDetector change_detector_;
+    std::vector<uint8_t> keep_;
+};
+
+/**
+ * @brief 按需拉取的PCAP帧源
+ *
+ * 拥有独立的驱动与队列（不使用全局队列），读到文件末尾时结束而不是退出进程，
+ * 供Arrow流按消费方的节奏逐帧读取。待取的帧最多 kMaxQueuedFrames 帧，
+ * 消费方跟不上时驱动的解析线程在回调中等待，不会无限制地读到前面。
+ */
+class PcapFrameSource {
+public:
+    static constexpr size_t kMaxQueuedFrames = 4;
+
+    /**
+     * @param num_frames 最多输出的帧数，0表示读完整个文件
+     * @throws std::runtime_error 驱动初始化失败
+     */
+    PcapFrameSource(const std::string& pcap_path, const float* R, const float* t, const float* ranges,
+                    int num_frames, const ConvertOptions& options);
+    ~PcapFrameSource();
+
+    /**
+     * @brief 读取并处理下一帧，文件结束或达到帧数上限时返回false
+     * @throws std::runtime_error 驱动报告了错误（之前已到达的帧仍会先输出）
+     */
+    bool next(rs_realtime::PointCloudData& cloud);
+
+private:
+    LidarDriver<PointCloudMsg> driver_;
+    SyncQueue<std::shared_ptr<PointCloudMsg>> free_queue_;
+    CalibFrameProcessor processor_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;      // 有新帧、队列有空位或结束时通知
+    std::deque<std::shared_ptr<PointCloudMsg>> stuffed_queue_;
+    bool finished_;                         // 文件读完或驱动出错
+    bool stopping_;                         // 析构中，放行阻塞在回调里的驱动线程
+    std::string error_;                     // 驱动报告的错误，队列取空后由 next 抛出
+
+    bool started_;
+    int num_frames_;
+    int emitted_;
+};
+
+/**
+ * @brief 文件转换中驱动的结束状态
+ *
+ * 异常回调在读到文件末尾或驱动报告错误时置位，处理线程取完已到达的帧后退出并完成写入与刷盘，
+ * 不像 exceptionCallback 那样直接退出进程（异步写入中的文件会随之丢失）。
+ */
+class ConvertStreamState {
+public:
+    /**
+     * @brief 驱动的异常回调，在驱动线程中调用
+     */
+    void onException(const Error& code);
+
+    bool ended() const { return ended_.load(); }
+
+    /**
+     * @brief 驱动报告的第一个错误，没有时为空
+     */
+    std::string error() const;
+
+private:
+    std::atomic<bool> ended_ {false};
+    mutable std::mutex mutex_;
+    std::string error_;
+};
+
 // 全局队列声明
 extern SyncQueue<std::shared_ptr<PointCloudMsg>> free_cloud_queue;
 extern SyncQueue<std::shared_ptr<PointCloudMsg>> stuffed_cloud_queue;
@@ -35,11 +166,14 @@ void exceptionCallback(const Error& code);
 
 // 工具函数声明
 void saveNpy(const std::string& path, const float* data, const std::vector<size_t>& shape);
-void processCloud(const std::string& output_dir, int num_frames);
-void processCloudWithCalib(const std::string& output_dir, const float* R, const float* t, const float* ranges, int num_frames);
+void writeNpyPoints(rs_realtime::NpyWriter& writer, const std::string& path, const float* x, const float* y,
+                    const float* z, size_t n, rs_realtime::OutputDType dtype);
+void processCloud(const std::string& output_dir, int num_frames, const ConvertOptions& options = ConvertOptions(), const ConvertStreamState* stream = nullptr);
+void processCloudWithCalib(const std::string& output_dir, const float* R, const float* t, const float* ranges, int num_frames, const ConvertOptions& options, const ConvertStreamState* stream = nullptr);
 
 // 主要转换函数声明
-int convert_pcap(const std::string& from_name, const std::string& to_name, int num_frames);
-int convert_pcap_with_calib(const std::string& from_name, const std::string& to_name, const py::array_t<float>& R, const py::array_t<float>& t, const py::array_t<float>& ranges, int num_frames);
+int convert_pcap(const std::string& from_name, const std::string& to_name, int num_frames, const ConvertOptions& options = ConvertOptions());
+int convert_pcap_with_calib(const std::string& from_name, const std::string& to_name, const py::array_t<float>& R, const py::array_t<float>& t, const py::array_t<float>& ranges, int num_frames, const ConvertOptions& options = ConvertOptions());
+rs_realtime::ArrowStreamHandle pcap_arrow_stream(const std::string& from_name, const py::array_t<float>& R, const py::array_t<float>& t, const py::array_t<float>& ranges, int num_frames = 0, const ConvertOptions& options = ConvertOptions());
 
 #endif // PCAP_CONVERTER_H
\ No newline at end of file
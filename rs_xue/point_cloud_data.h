@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "frame_allocator.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 帧内的一列逐点数据，分配经过 FrameAllocator（计数、可选大页）
+ */
+template <typename T>
+using FrameColumn = std::vector<T, FrameAllocator<T>>;
+
+namespace detail {
+
+// 按掩码原地压缩一列，未填充的列（长度不足）保持为空
+template <typename Column>
+void compactColumn(Column& column, const uint8_t* keep, size_t n) {
+    if (column.size() < n) {
+        column.clear();
+        return;
+    }
+    size_t j = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (keep[i]) {
+            column[j++] = column[i];
+        }
+    }
+    column.resize(j);
+}
+
+// 预留容量并写一遍，让页面在预热阶段而不是首帧中缺页
+template <typename Column>
+void prefault(Column& column, size_t n) {
+    if (column.capacity() >= n) {
+        return;
+    }
+    const size_t size = column.size();
+    column.resize(n);
+    column.resize(size);
+}
+
+} // namespace detail
+
+/**
+ * @brief 转换时在同一遍扫描中顺带得到的帧统计
+ *
+ * 包围盒只统计坐标有限的点，且为标定后、后续处理阶段之前的结果；
+ * 没有有效点时 min 为 +inf、max 为 -inf。
+ */
+struct FrameStats {
+    uint32_t raw_count = 0;         // 驱动输出的点数（含无效点）
+    uint32_t valid_count = 0;       // 坐标均为有限值的点数
+    uint32_t nan_count = 0;         // 坐标含NaN/Inf的点数
+    bool dense = false;             // 无效点是否已在转换时丢弃
+    float min[3] = {std::numeric_limits<float>::infinity(),
+                    std::numeric_limits<float>::infinity(),
+                    std::numeric_limits<float>::infinity()};
+    float max[3] = {-std::numeric_limits<float>::infinity(),
+                    -std::numeric_limits<float>::infinity(),
+                    -std::numeric_limits<float>::infinity()};
+};
+
+/**
+ * @brief 一帧的聚类汇总，第k项对应聚类标签k
+ */
+struct FrameClusters {
+    FrameColumn<uint32_t> count;    // 簇内点数
+    FrameColumn<float> centroid;    // 质心 (K, 3)
+    FrameColumn<float> min;         // 包围盒下界 (K, 3)
+    FrameColumn<float> max;         // 包围盒上界 (K, 3)
+
+    size_t size() const { return count.size(); }
+
+    void clear() {
+        count.clear();
+        centroid.clear();
+        min.clear();
+        max.clear();
+    }
+};
+
+/**
+ * @brief 点云数据结构，用于Python接口
+ *
+ * 以列存储（SoA）方式保存一帧点云，实时客户端与PCAP转换共用，
+ * 各处理阶段（运动补偿等）直接在这些列上原地计算。
+ */
+struct PointCloudData {
+    FrameColumn<float> x;           // X坐标数组
+    FrameColumn<float> y;           // Y坐标数组
+    FrameColumn<float> z;           // Z坐标数组
+    FrameColumn<float> intensity;   // 强度数组
+    FrameColumn<double> timestamp;  // 时间戳数组
+    FrameColumn<uint8_t> inlier;    // 离群点过滤的内点掩码（仅掩码输出模式下填充）
+    FrameColumn<uint8_t> ground;    // 地面标签，1为地面（仅标签输出模式下填充）
+    FrameColumn<uint32_t> scan_index; // 每个点在驱动原始帧中的下标（仅请求时填充）
+    FrameColumn<int32_t> cluster;   // 聚类标签，-1为噪声或未参与聚类（仅启用聚类时填充）
+    FrameColumn<float> normal_x;    // 法向X分量，无法估计的点为NaN（仅启用法向估计时填充）
+    FrameColumn<float> normal_y;    // 法向Y分量
+    FrameColumn<float> normal_z;    // 法向Z分量
+    FrameColumn<float> curvature;   // 曲率（表面变化度）
+    FrameColumn<uint8_t> change;    // 帧间变化标签，取值见 ChangeLabel（仅启用变化检测时填充）
+    FrameClusters clusters;         // 各簇的点数、质心与包围盒（仅启用聚类时填充）
+    FrameStats stats;               // 转换时的帧统计
+    uint32_t frame_id;              // 帧ID
+    size_t point_count;             // 点数量
+    double frame_timestamp;         // 帧时间戳（运动补偿的参考时刻）
+    double receive_time;            // 主机收到整帧的时刻（单调时钟，秒），0表示未知
+    double ready_time;              // 各处理阶段完成的时刻（单调时钟，秒），0表示未知
+
+    PointCloudData() : frame_id(0), point_count(0), frame_timestamp(0.0), receive_time(0.0), ready_time(0.0) {}
+
+    void clear() {
+        x.clear();
+        y.clear();
+        z.clear();
+        intensity.clear();
+        timestamp.clear();
+        inlier.clear();
+        ground.clear();
+        scan_index.clear();
+        cluster.clear();
+        normal_x.clear();
+        normal_y.clear();
+        normal_z.clear();
+        curvature.clear();
+        change.clear();
+        clusters.clear();
+        stats = FrameStats();
+        frame_id = 0;
+        point_count = 0;
+        frame_timestamp = 0.0;
+        receive_time = 0.0;
+        ready_time = 0.0;
+    }
+
+    /**
+     * @brief 为所有逐点列预留 max_points 的容量并预先触碰内存，之后不超过该点数的帧不再分配或缺页
+     */
+    void reserve(size_t max_points) {
+        detail::prefault(x, max_points);
+        detail::prefault(y, max_points);
+        detail::prefault(z, max_points);
+        detail::prefault(intensity, max_points);
+        detail::prefault(timestamp, max_points);
+        detail::prefault(inlier, max_points);
+        detail::prefault(ground, max_points);
+        detail::prefault(scan_index, max_points);
+        detail::prefault(cluster, max_points);
+        detail::prefault(normal_x, max_points);
+        detail::prefault(normal_y, max_points);
+        detail::prefault(normal_z, max_points);
+        detail::prefault(curvature, max_points);
+        detail::prefault(change, max_points);
+    }
+
+    /**
+     * @brief 按掩码原地压缩所有逐点列，keep[i]非0的点保留
+     *
+     * @return 保留的点数
+     */
+    size_t compact(const uint8_t* keep) {
+        const size_t n = point_count;
+        detail::compactColumn(x, keep, n);
+        detail::compactColumn(y, keep, n);
+        detail::compactColumn(z, keep, n);
+        detail::compactColumn(intensity, keep, n);
+        detail::compactColumn(timestamp, keep, n);
+        detail::compactColumn(inlier, keep, n);
+        detail::compactColumn(ground, keep, n);
+        detail::compactColumn(scan_index, keep, n);
+        detail::compactColumn(cluster, keep, n);
+        detail::compactColumn(normal_x, keep, n);
+        detail::compactColumn(normal_y, keep, n);
+        detail::compactColumn(normal_z, keep, n);
+        detail::compactColumn(curvature, keep, n);
+        detail::compactColumn(change, keep, n);
+        point_count = x.size();
+        return point_count;
+    }
+};
+
+} // namespace rs_realtime
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "point_cloud_data.h"
+#include "pose.h"
+
+namespace rs_realtime {
+
+/**
+ * @brief 可选的输出字段（x, y, z 总是输出）与转换选项，可按位组合
+ */
+enum PointField : uint32_t {
+    FIELD_INTENSITY = 1u << 0,
+    FIELD_TIMESTAMP = 1u << 1,
+    FIELD_SCAN_INDEX = 1u << 2,         // 输出每个点在原始帧中的下标（uint32）
+    FIELD_ALL = FIELD_INTENSITY | FIELD_TIMESTAMP,
+
+    // 转换选项
+    CONVERT_DROP_INVALID = 1u << 16     // 丢弃坐标含NaN/Inf的点，其余点保持扫描顺序
+};
+
+/**
+ * @brief 标定变换的类别，决定使用哪个特化内核
+ */
+enum class TransformKind {
+    IDENTITY,       // 直接拷贝
+    TRANSLATION,    // 只有平移
+    RIGID           // 完整的 R*p + t
+};
+
+/**
+ * @brief 按变换内容分类；只有精确的单位阵/零平移才走简化路径
+ */
+inline TransformKind classifyTransform(const RigidTransform& T) {
+    const bool identity_r = T.R[0] == 1.f && T.R[1] == 0.f && T.R[2] == 0.f &&
+                            T.R[3] == 0.f && T.R[4] == 1.f && T.R[5] == 0.f &&
+                            T.R[6] == 0.f && T.R[7] == 0.f && T.R[8] == 1.f;
+    const bool zero_t = T.t[0] == 0.f && T.t[1] == 0.f && T.t[2] == 0.f;
+    if (!identity_r) {
+        return TransformKind::RIGID;
+    }
+    return zero_t ? TransformKind::IDENTITY : TransformKind::TRANSLATION;
+}
+
+// 点类型的字段探测：驱动的点类型（PointXYZI / PointXYZIT / PointXYZIRT ...）按成员是否存在区分
+template <typename P, typename = void>
+struct HasIntensity : std::false_type {};
+template <typename P>
+struct HasIntensity<P, std::void_t<decltype(std::declval<P>().intensity)>> : std::true_type {};
+
+template <typename P, typename = void>
+struct HasTimestamp : std::false_type {};
+template <typename P>
+struct HasTimestamp<P, std::void_t<decltype(std::declval<P>().timestamp)>> : std::true_type {};
+
+/**
+ * @brief 坐标轴策略：保持驱动坐标系
+ */
+struct AxisIdentity {
+    template <typename P>
+    static void load(const P& p, float& x, float& y, float& z) {
+        x = p.x;
+        y = p.y;
+        z = p.z;
+    }
+};
+
+/**
+ * @brief 坐标轴策略：绕z轴旋转90度（x' = -y, y' = x），实时客户端的安装朝向
+ */
+struct AxisRotateZ90 {
+    template <typename P>
+    static void load(const P& p, float& x, float& y, float& z) {
+        x = -p.y;
+        y = p.x;
+        z = p.z;
+    }
+};
+
+namespace detail {
+
+// 把运行期的bool转换为编译期常量后调用f
+template <typename F>
+void dispatchBool(bool value, F&& f) {
+    if (value) {
+        f(std::true_type{});
+    } else {
+        f(std::false_type{});
+    }
+}
+
+struct ConvertColumns {
+    float* x;
+    float* y;
+    float* z;
+    float* intensity;
+    double* timestamp;
+    uint32_t* scan_index;
+};
+
+// 转换分块的点数，每块写出后立即在L1中统计
+constexpr size_t kConvertBlock = 256;
+
+/**
+ * @brief 包围盒与有效点数的分组累加器，每组内各通道独立比较以便向量化
+ */
+class BoundsAccumulator {
+public:
+    static constexpr size_t kLanes = 8;
+
+    BoundsAccumulator() {
+        for (size_t l = 0; l < kLanes; ++l) {
+            for (int a = 0; a < 3; ++a) {
+                min_[a][l] = std::numeric_limits<float>::infinity();
+                max_[a][l] = -std::numeric_limits<float>::infinity();
+            }
+            valid_[l] = 0;
+        }
+    }
+
+    void add(const float* __restrict x, const float* __restrict y, const float* __restrict z, size_t n) {
+        size_t i = 0;
+        for (; i + kLanes <= n; i += kLanes) {
+            for (size_t l = 0; l < kLanes; ++l) {
+                accumulate(l, x[i + l], y[i + l], z[i + l]);
+            }
+        }
+        for (; i < n; ++i) {
+            accumulate(0, x[i], y[i], z[i]);
+        }
+    }
+
+    void finish(size_t raw_count, FrameStats& stats) const {
+        size_t valid = 0;
+        for (size_t l = 0; l < kLanes; ++l) {
+            valid += valid_[l];
+            for (int a = 0; a < 3; ++a) {
+                stats.min[a] = min_[a][l] < stats.min[a] ? min_[a][l] : stats.min[a];
+                stats.max[a] = max_[a][l] > stats.max[a] ? max_[a][l] : stats.max[a];
+            }
+        }
+        stats.raw_count = static_cast<uint32_t>(raw_count);
+        stats.valid_count = static_cast<uint32_t>(valid);
+        stats.nan_count = static_cast<uint32_t>(raw_count - valid);
+    }
+
+private:
+    void accumulate(size_t l, float x, float y, float z) {
+        // v - v == 0 对NaN/Inf为假；无效点的坐标换成NaN，比较恒为假，不影响包围盒
+        const bool valid = (x - x == 0.f) & (y - y == 0.f) & (z - z == 0.f);
+        constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+        const float bx = valid ? x : kNaN;
+        const float by = valid ? y : kNaN;
+        const float bz = valid ? z : kNaN;
+        min_[0][l] = bx < min_[0][l] ? bx : min_[0][l];
+        min_[1][l] = by < min_[1][l] ? by : min_[1][l];
+        min_[2][l] = bz < min_[2][l] ? bz : min_[2][l];
+        max_[0][l] = bx > max_[0][l] ? bx : max_[0][l];
+        max_[1][l] = by > max_[1][l] ? by : max_[1][l];
+        max_[2][l] = bz > max_[2][l] ? bz : max_[2][l];
+        valid_[l] += valid;
+    }
+
+    float min_[3][kLanes];
+    float max_[3][kLanes];
+    uint32_t valid_[kLanes];
+};
+
+/**
+ * @brief 单遍转换内核：变换、字段拷贝、无效点剔除与帧统计融合在同一遍扫描里
+ *
+ * 按块处理：先把一块AoS点转换为SoA列（剔除模式下每个点都写到游标 j 处、
+ * 再按有效性前移游标，无效点随后被覆盖），再趁刚写出的列还在L1中统计包围盒，
+ * 统计在连续的SoA列上进行，可以向量化，不需要再扫一遍整帧。
+ *
+ * @return 输出的点数
+ */
+template <typename PointT, typename Axis, TransformKind Kind,
+          bool WithIntensity, bool WithTimestamp, bool WithIndex, bool DropInvalid>
+size_t convertPointsKernel(const PointT* __restrict points, size_t n, const RigidTransform& T,
+                           const ConvertColumns& columns, FrameStats& stats) {
+    float* __restrict out_x = columns.x;
+    float* __restrict out_y = columns.y;
+    float* __restrict out_z = columns.z;
+    float* __restrict out_intensity = columns.intensity;
+    double* __restrict out_timestamp = columns.timestamp;
+    uint32_t* __restrict out_index = columns.scan_index;
+    // 拷贝到局部变量，避免与输出数组的别名分析
+    const float r0 = T.R[0], r1 = T.R[1], r2 = T.R[2];
+    const float r3 = T.R[3], r4 = T.R[4], r5 = T.R[5];
+    const float r6 = T.R[6], r7 = T.R[7], r8 = T.R[8];
+    const float tx = T.t[0], ty = T.t[1], tz = T.t[2];
+    BoundsAccumulator bounds;
+    size_t j = 0;
+    for (size_t begin = 0; begin < n; begin += kConvertBlock) {
+        const size_t end = begin + kConvertBlock < n ? begin + kConvertBlock : n;
+        const size_t block_out = DropInvalid ? j : begin;
+        for (size_t i = begin; i < end; ++i) {
+            float x, y, z;
+            Axis::load(points[i], x, y, z);
+            float ox, oy, oz;
+            if constexpr (Kind == TransformKind::RIGID) {
+                ox = r0 * x + r1 * y + r2 * z + tx;
+                oy = r3 * x + r4 * y + r5 * z + ty;
+                oz = r6 * x + r7 * y + r8 * z + tz;
+            } else if constexpr (Kind == TransformKind::TRANSLATION) {
+                ox = x + tx;
+                oy = y + ty;
+                oz = z + tz;
+            } else {
+                ox = x;
+                oy = y;
+                oz = z;
+            }
+            const size_t dst = DropInvalid ? j : i;
+            out_x[dst] = ox;
+            out_y[dst] = oy;
+            out_z[dst] = oz;
+            if constexpr (WithIntensity) {
+                out_intensity[dst] = static_cast<float>(points[i].intensity);
+            }
+            if constexpr (WithTimestamp) {
+                out_timestamp[dst] = static_cast<double>(points[i].timestamp);
+            }
+            if constexpr (WithIndex) {
+                out_index[dst] = static_cast<uint32_t>(i);
+            }
+            if constexpr (DropInvalid) {
+                j += (ox - ox == 0.f) & (oy - oy == 0.f) & (oz - oz == 0.f);
+            }
+        }
+        const size_t block_end = DropInvalid ? j : end;
+        bounds.add(out_x + block_out, out_y + block_out, out_z + block_out, block_end - block_out);
+    }
+    bounds.finish(n, stats);
+    stats.dense = DropInvalid;
+    return DropInvalid ? j : n;
+}
+
+template <typename Column>
+void resizeColumn(Column& column, bool wanted, size_t n) {
+    // 未请求或点类型不具备的字段保持为空列
+    if (wanted) {
+        column.resize(n);
+    } else {
+        column.clear();
+    }
+}
+
+template <typename PointT, typename Axis, TransformKind Kind>
+void dispatchFields(const PointT* points, size_t n, const RigidTransform& T, uint32_t fields, PointCloudData& out) {
+    constexpr bool kHasIntensity = HasIntensity<PointT>::value;
+    constexpr bool kHasTimestamp = HasTimestamp<PointT>::value;
+    const bool want_intensity = kHasIntensity && (fields & FIELD_INTENSITY);
+    const bool want_timestamp = kHasTimestamp && (fields & FIELD_TIMESTAMP);
+    const bool want_index = (fields & FIELD_SCAN_INDEX) != 0;
+    const bool drop_invalid = (fields & CONVERT_DROP_INVALID) != 0;
+
+    resizeColumn(out.intensity, want_intensity, n);
+    resizeColumn(out.timestamp, want_timestamp, n);
+    resizeColumn(out.scan_index, want_index, n);
+    const ConvertColumns columns = {
+        out.x.data(), out.y.data(), out.z.data(),
+        out.intensity.data(), out.timestamp.data(), out.scan_index.data()
+    };
+
+    // 四个开关各展开一次，逐点循环中没有运行时分支
+    size_t count = 0;
+    dispatchBool(want_intensity, [&](auto with_intensity) {
+        dispatchBool(want_timestamp, [&](auto with_timestamp) {
+            dispatchBool(want_index, [&](auto with_index) {
+                dispatchBool(drop_invalid, [&](auto drop) {
+                    count = convertPointsKernel<PointT, Axis, Kind,
+                                                kHasIntensity && decltype(with_intensity)::value,
+                                                kHasTimestamp && decltype(with_timestamp)::value,
+                                                decltype(with_index)::value,
+                                                decltype(drop)::value>(points, n, T, columns, out.stats);
+                });
+            });
+        });
+    });
+
+    if (count != n) {
+        out.x.resize(count);
+        out.y.resize(count);
+        out.z.resize(count);
+        resizeColumn(out.intensity, want_intensity, count);
+        resizeColumn(out.timestamp, want_timestamp, count);
+        resizeColumn(out.scan_index, want_index, count);
+    }
+    out.point_count = count;
+}
+
+} // namespace detail
+
+/**
+ * @brief 把驱动输出的点（AoS）转换为SoA列并施加标定变换
+ *
+ * 点类型、坐标轴策略在编译期确定；变换类别与字段组合在每帧入口处分派一次，
+ * 之后的逐点循环中没有任何运行时分支。未请求的字段不读取也不写入。
+ * 同一遍扫描顺带填写 out.stats（有效点数、无效点数、包围盒），
+ * 带 CONVERT_DROP_INVALID 时直接输出稠密点云，FIELD_SCAN_INDEX 给出回到原始下标的映射。
+ *
+ * @param fields PointField 的组合，x/y/z 总是输出
+ */
+template <typename PointT, typename Axis = AxisIdentity>
+void convertPoints(const PointT* points, size_t n, const RigidTransform& T, uint32_t fields, PointCloudData& out) {
+    out.x.resize(n);
+    out.y.resize(n);
+    out.z.resize(n);
+    out.stats = FrameStats();
+    switch (classifyTransform(T)) {
+    case TransformKind::IDENTITY:
+        detail::dispatchFields<PointT, Axis, TransformKind::IDENTITY>(points, n, T, fields, out);
+        break;
+    case TransformKind::TRANSLATION:
+        detail::dispatchFields<PointT, Axis, TransformKind::TRANSLATION>(points, n, T, fields, out);
+        break;
+    case TransformKind::RIGID:
+        detail::dispatchFields<PointT, Axis, TransformKind::RIGID>(points, n, T, fields, out);
+        break;
+    }
+}
+
+} // namespace rs_realtime
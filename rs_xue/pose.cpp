@@ -0,0 +1,218 @@
+#include "pose.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace rs_realtime {
+
+namespace {
+
+// 四元数(x, y, z, w)转行主序旋转矩阵
+void quatToMatrix(const std::array<double, 4>& q, std::array<float, 9>& R) {
+    double x = q[0], y = q[1], z = q[2], w = q[3];
+    const double norm = std::sqrt(x * x + y * y + z * z + w * w);
+    if (norm > 0.0) {
+        x /= norm; y /= norm; z /= norm; w /= norm;
+    } else {
+        x = y = z = 0.0; w = 1.0;
+    }
+    R[0] = static_cast<float>(1.0 - 2.0 * (y * y + z * z));
+    R[1] = static_cast<float>(2.0 * (x * y - z * w));
+    R[2] = static_cast<float>(2.0 * (x * z + y * w));
+    R[3] = static_cast<float>(2.0 * (x * y + z * w));
+    R[4] = static_cast<float>(1.0 - 2.0 * (x * x + z * z));
+    R[5] = static_cast<float>(2.0 * (y * z - x * w));
+    R[6] = static_cast<float>(2.0 * (x * z - y * w));
+    R[7] = static_cast<float>(2.0 * (y * z + x * w));
+    R[8] = static_cast<float>(1.0 - 2.0 * (x * x + y * y));
+}
+
+// 四元数球面插值，s∈[0,1]
+std::array<double, 4> slerp(const std::array<double, 4>& a, std::array<double, 4> b, double s) {
+    double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    if (dot < 0.0) {
+        // 走短弧
+        for (auto& v : b) v = -v;
+        dot = -dot;
+    }
+    double wa, wb;
+    if (dot > 0.9995) {
+        // 夹角很小时退化为线性插值，避免除零
+        wa = 1.0 - s;
+        wb = s;
+    } else {
+        const double theta = std::acos(dot);
+        const double sin_theta = std::sin(theta);
+        wa = std::sin((1.0 - s) * theta) / sin_theta;
+        wb = std::sin(s * theta) / sin_theta;
+    }
+    return {wa * a[0] + wb * b[0], wa * a[1] + wb * b[1],
+            wa * a[2] + wb * b[2], wa * a[3] + wb * b[3]};
+}
+
+RigidTransform poseToTransform(const Pose& pose) {
+    RigidTransform T;
+    quatToMatrix(pose.q, T.R);
+    T.t = {static_cast<float>(pose.t[0]), static_cast<float>(pose.t[1]), static_cast<float>(pose.t[2])};
+    return T;
+}
+
+} // namespace
+
+RigidTransform RigidTransform::inverse() const {
+    RigidTransform inv;
+    // R^T
+    inv.R = {R[0], R[3], R[6], R[1], R[4], R[7], R[2], R[5], R[8]};
+    // -R^T * t
+    inv.t[0] = -(inv.R[0] * t[0] + inv.R[1] * t[1] + inv.R[2] * t[2]);
+    inv.t[1] = -(inv.R[3] * t[0] + inv.R[4] * t[1] + inv.R[5] * t[2]);
+    inv.t[2] = -(inv.R[6] * t[0] + inv.R[7] * t[1] + inv.R[8] * t[2]);
+    return inv;
+}
+
+RigidTransform RigidTransform::operator*(const RigidTransform& rhs) const {
+    RigidTransform out;
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            out.R[r * 3 + c] = R[r * 3 + 0] * rhs.R[0 * 3 + c] +
+                               R[r * 3 + 1] * rhs.R[1 * 3 + c] +
+                               R[r * 3 + 2] * rhs.R[2 * 3 + c];
+        }
+        out.t[r] = R[r * 3 + 0] * rhs.t[0] + R[r * 3 + 1] * rhs.t[1] + R[r * 3 + 2] * rhs.t[2] + t[r];
+    }
+    return out;
+}
+
+void transformPoints(const RigidTransform& T, float* __restrict x, float* __restrict y,
+                     float* __restrict z, size_t n) {
+    const float r0 = T.R[0], r1 = T.R[1], r2 = T.R[2];
+    const float r3 = T.R[3], r4 = T.R[4], r5 = T.R[5];
+    const float r6 = T.R[6], r7 = T.R[7], r8 = T.R[8];
+    const float t0 = T.t[0], t1 = T.t[1], t2 = T.t[2];
+    for (size_t i = 0; i < n; ++i) {
+        const float px = x[i];
+        const float py = y[i];
+        const float pz = z[i];
+        x[i] = r0 * px + r1 * py + r2 * pz + t0;
+        y[i] = r3 * px + r4 * py + r5 * pz + t1;
+        z[i] = r6 * px + r7 * py + r8 * pz + t2;
+    }
+}
+
+PoseBuffer::PoseBuffer(size_t capacity)
+    : capacity_(capacity),
+      version_(0) {
+}
+
+void PoseBuffer::push(const Pose& pose) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (poses_.empty() || pose.timestamp > poses_.back().timestamp) {
+        poses_.push_back(pose);
+    } else {
+        // 乱序到达的位姿按时间戳插入，相同时间戳直接覆盖
+        auto it = std::lower_bound(poses_.begin(), poses_.end(), pose.timestamp,
+                                   [](const Pose& p, double ts) { return p.timestamp < ts; });
+        if (it != poses_.end() && it->timestamp == pose.timestamp) {
+            *it = pose;
+        } else {
+            poses_.insert(it, pose);
+        }
+    }
+    if (capacity_ > 0) {
+        while (poses_.size() > capacity_) {
+            poses_.pop_front();
+        }
+    }
+    ++version_;
+}
+
+size_t PoseBuffer::loadFromFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return 0;
+    }
+    size_t loaded = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream iss(line);
+        Pose pose;
+        if (iss >> pose.timestamp >> pose.t[0] >> pose.t[1] >> pose.t[2]
+                >> pose.q[0] >> pose.q[1] >> pose.q[2] >> pose.q[3]) {
+            push(pose);
+            ++loaded;
+        }
+    }
+    return loaded;
+}
+
+bool PoseBuffer::interpolateLocked(double timestamp, RigidTransform& out) const {
+    if (timestamp <= poses_.front().timestamp) {
+        out = poseToTransform(poses_.front());
+        return timestamp == poses_.front().timestamp;
+    }
+    if (timestamp >= poses_.back().timestamp) {
+        out = poseToTransform(poses_.back());
+        return timestamp == poses_.back().timestamp;
+    }
+    auto hi = std::upper_bound(poses_.begin(), poses_.end(), timestamp,
+                               [](double ts, const Pose& p) { return ts < p.timestamp; });
+    auto lo = hi - 1;
+    const double s = (timestamp - lo->timestamp) / (hi->timestamp - lo->timestamp);
+
+    Pose pose;
+    pose.timestamp = timestamp;
+    for (int k = 0; k < 3; ++k) {
+        pose.t[k] = lo->t[k] + s * (hi->t[k] - lo->t[k]);
+    }
+    pose.q = slerp(lo->q, hi->q, s);
+    out = poseToTransform(pose);
+    return true;
+}
+
+size_t PoseBuffer::interpolate(const double* timestamps, size_t n, RigidTransform* out,
+                               uint8_t* in_range) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (poses_.empty()) {
+        std::fill(out, out + n, RigidTransform());
+        if (in_range) {
+            std::fill(in_range, in_range + n, 0);
+        }
+        return 0;
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const bool inside = interpolateLocked(timestamps[i], out[i]);
+        if (in_range) {
+            in_range[i] = inside ? 1 : 0;
+        }
+        count += inside ? 1 : 0;
+    }
+    return count;
+}
+
+bool PoseBuffer::interpolate(double timestamp, RigidTransform& out) const {
+    return interpolate(&timestamp, 1, &out) == 1;
+}
+
+size_t PoseBuffer::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return poses_.size();
+}
+
+void PoseBuffer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    poses_.clear();
+    ++version_;
+}
+
+uint64_t PoseBuffer::version() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return version_;
+}
+
+} // namespace rs_realtime
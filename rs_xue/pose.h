@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace rs_realtime {
+
+/**
+ * @brief 刚体变换 p' = R * p + t，R按行主序存储
+ */
+struct RigidTransform {
+    std::array<float, 9> R {1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f};
+    std::array<float, 3> t {0.f, 0.f, 0.f};
+
+    /**
+     * @brief 求逆变换
+     */
+    RigidTransform inverse() const;
+
+    /**
+     * @brief 变换复合，结果等价于先作用 rhs 再作用 *this
+     */
+    RigidTransform operator*(const RigidTransform& rhs) const;
+};
+
+/**
+ * @brief 对SoA坐标数组原地施加刚体变换
+ *
+ * 三个数组互不重叠，循环体无分支，编译器可以直接向量化。
+ */
+void transformPoints(const RigidTransform& T, float* x, float* y, float* z, size_t n);
+
+/**
+ * @brief 带时间戳的位姿：载体坐标系在世界系下的位姿
+ *
+ * 四元数按 x, y, z, w 顺序存储，与TUM轨迹格式及scipy一致。
+ */
+struct Pose {
+    double timestamp = 0.0;
+    std::array<double, 3> t {0.0, 0.0, 0.0};
+    std::array<double, 4> q {0.0, 0.0, 0.0, 1.0};
+};
+
+/**
+ * @brief 线程安全的位姿缓冲区
+ *
+ * 位姿可以由Python逐条推送，也可以从文件整体加载；按时间戳有序保存，
+ * 查询时对平移线性插值、对旋转球面插值（SE(3)插值）。
+ */
+class PoseBuffer {
+public:
+    /**
+     * @param capacity 最多保留的位姿数量，0表示不限制
+     */
+    explicit PoseBuffer(size_t capacity = 0);
+
+    /**
+     * @brief 推送一条位姿，超出容量时丢弃最旧的位姿
+     */
+    void push(const Pose& pose);
+
+    /**
+     * @brief 从TUM格式文件加载位姿（每行: timestamp tx ty tz qx qy qz qw，#开头为注释）
+     *
+     * @return 成功加载的位姿数量
+     */
+    size_t loadFromFile(const std::string& path);
+
+    /**
+     * @brief 批量插值：一次加锁完成n个时刻的位姿查询
+     *
+     * 超出位姿覆盖范围的时刻取最近端点的位姿。
+     *
+     * @param in_range 可选输出，逐个标记时刻是否落在覆盖范围内
+     * @return 落在覆盖范围内的时刻数量；缓冲区为空时输出单位变换并返回0
+     */
+    size_t interpolate(const double* timestamps, size_t n, RigidTransform* out,
+                       uint8_t* in_range = nullptr) const;
+
+    /**
+     * @brief 单个时刻的插值查询
+     *
+     * @return true 时刻落在覆盖范围内
+     */
+    bool interpolate(double timestamp, RigidTransform& out) const;
+
+    size_t size() const;
+    void clear();
+
+    /**
+     * @brief 每次内容变化都会递增的版本号，用于判断缓存的变换是否过期
+     */
+    uint64_t version() const;
+
+private:
+    bool interpolateLocked(double timestamp, RigidTransform& out) const;
+
+    mutable std::mutex mutex_;
+    std::deque<Pose> poses_;
+    size_t capacity_;
+    uint64_t version_;
+};
+
+} // namespace rs_realtime
@@ -1,4 +1,6 @@
 #include "realtime_lidar_client.h"
+#include "numpy_utils.h"
+#include "arrow_python.h"
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <cstring>
@@ -13,9 +15,19 @@ namespace py = pybind11;
 
 namespace rs_realtime {
 
+namespace {
+
+// 与Python的 time.monotonic() 同一时钟（Linux下均为 CLOCK_MONOTONIC）
+double monotonicSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 // 构造函数
 RealtimeLidarClient::RealtimeLidarClient() 
     : driver_(std::make_unique<LidarDriver<PointCloudMsg>>()),
+      frame_pool_(FramePool::create()),
       initialized_(false),
       running_(false), 
       connected_(false),
@@ -25,26 +37,50 @@ RealtimeLidarClient::RealtimeLidarClient()
 
 void RealtimeLidarClient::processCloudThread() {
     while (!should_stop_processing_) {
-        std::shared_ptr<PointCloudMsg> msg = stuffed_cloud_queue_.popWait();
+        StampedCloudMsg stamped = stuffed_cloud_queue_.popWait();
+        std::shared_ptr<PointCloudMsg> msg = stamped.msg;
         if (!msg) {
             continue;
         }
         
-        // 添加与demo_online.cpp相同的调试打印，检查xyz三个坐标
-        size_t N = msg->points.size();
-       
-        
-        // 转换点云数据
-        PointCloudData cloud_data;
+        // 转换点云数据，写入从帧池取出的帧（复用其容量）
+        FramePool::Handle frame = frame_pool_->acquire();
+        PointCloudData& cloud_data = *frame;
         convertPointCloudMsg(msg, cloud_data);
+        cloud_data.receive_time = stamped.receive_time;
+
+        // 运动补偿等后处理阶段
+        {
+            std::lock_guard<std::mutex> lock(pipeline_mutex_);
+            deskewer_.apply(pose_buffer_, cloud_data);
+            outlier_filter_.apply(cloud_data);
+            ground_segmenter_.apply(cloud_data);
+            normal_estimator_.apply(cloud_data);
+            clusterer_.apply(cloud_data);
+            change_detector_.apply(pose_buffer_, cloud_data);
+        }
+        {
+            std::lock_guard<std::mutex> lock(accumulator_mutex_);
+            if (accumulator_.config().enabled) {
+                accumulator_.add(pose_buffer_, cloud_data);
+                ++accumulator_seq_;
+            }
+        }
+        accumulator_cv_.notify_all();  // 通知等待的 get_accumulated
+        cloud_data.ready_time = monotonicSeconds();
+        frames_processed_.fetch_add(1, std::memory_order_relaxed);
         
-        // 更新最新数据（加锁保护）
+        // 更新最新数据（加锁保护），被覆盖的旧帧换到 frame 中，在锁外回到帧池
         {
             std::lock_guard<std::mutex> lock(cloud_data_mutex_);
-            latest_cloud_data_ = std::move(cloud_data);
+            if (has_new_data_) {
+                frames_overwritten_.fetch_add(1, std::memory_order_relaxed);
+            }
+            std::swap(latest_frame_, frame);
             has_new_data_ = true;
         }
         cloud_data_cv_.notify_one();  // 通知等待的get函数
+        frame.reset();
         
         // 回收消息到空闲队列
         free_cloud_queue_.push(msg);
@@ -52,6 +88,16 @@ void RealtimeLidarClient::processCloudThread() {
 }
 
 bool RealtimeLidarClient::get(PointCloudData& point_cloud) {
+    FramePool::Handle frame;
+    if (!get(frame)) {
+        return false;
+    }
+    // 复制而不是移动，池中的帧保留其容量
+    point_cloud = *frame;
+    return true;
+}
+
+bool RealtimeLidarClient::get(FramePool::Handle& frame) {
     if (!running_) {
         set_error("Client is not running");
         return false; 
@@ -67,9 +113,9 @@ bool RealtimeLidarClient::get(PointCloudData& point_cloud) {
     }
     
     if (has_new_data_) {
-        point_cloud = std::move(latest_cloud_data_);
-        latest_cloud_data_.clear();  // 清空已移动的数据
+        frame = std::move(latest_frame_);
         has_new_data_ = false;
+        frames_delivered_.fetch_add(1, std::memory_order_relaxed);
         return true;
     }
     
@@ -84,6 +130,11 @@ void RealtimeLidarClient::stop() {
     // 停止处理线程
     should_stop_processing_ = true;
     cloud_data_cv_.notify_all();  // 唤醒所有等待的线程
+    {
+        // 置位后加锁一次，get_accumulated 在检查停止标志与进入等待之间不会漏掉通知
+        std::lock_guard<std::mutex> lock(accumulator_mutex_);
+    }
+    accumulator_cv_.notify_all();
     
     if (processing_thread_.joinable()) {
         processing_thread_.join();
@@ -158,6 +209,9 @@ bool RealtimeLidarClient::initialize(const std::string& lidar_ip,
             return false;
         }
         
+        // 预热帧池与驱动消息池，首批帧不再分配内存、触发缺页
+        prewarm();
+
         initialized_ = true;
         connected_ = true;
         
@@ -232,12 +286,15 @@ std::string RealtimeLidarClient::get_last_error() const {
 std::shared_ptr<PointCloudMsg> RealtimeLidarClient::getPointCloudCallback() {
     // 从空闲队列获取点云消息
     std::shared_ptr<PointCloudMsg> msg = free_cloud_queue_.pop();
-    if (msg.get() != nullptr) {
-        return msg;
+    if (msg.get() == nullptr) {
+        // 如果没有空闲消息，创建新的
+        msg = std::make_shared<PointCloudMsg>();
+        msg->points.reserve(message_reserve_.load(std::memory_order_relaxed));
+        message_allocations_.fetch_add(1, std::memory_order_relaxed);
     }
-    
-    // 如果没有空闲消息，创建新的
-    return std::make_shared<PointCloudMsg>();
+    // 驱动按顺序取出、填充、交回消息，归还时容量变化即说明点缓冲重新分配过
+    handed_capacity_.store(msg->points.capacity(), std::memory_order_relaxed);
+    return msg;
 }
 
 void RealtimeLidarClient::returnPointCloudCallback(std::shared_ptr<PointCloudMsg> msg) {
@@ -251,8 +308,87 @@ void RealtimeLidarClient::returnPointCloudCallback(std::shared_ptr<PointCloudMsg
     //     free_cloud_queue_.push(old_msg);
     // }
     
-    // 将新的点云消息放入队列
-    stuffed_cloud_queue_.push(msg);
+    frames_received_.fetch_add(1, std::memory_order_relaxed);
+    points_received_.fetch_add(msg->points.size(), std::memory_order_relaxed);
+    if (msg->points.capacity() != handed_capacity_.load(std::memory_order_relaxed)) {
+        message_growths_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 将新的点云消息连同到达时刻放入队列
+    const uint64_t depth = stuffed_cloud_queue_.push(StampedCloudMsg{msg, monotonicSeconds()});
+    uint64_t max_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    while (depth > max_depth &&
+           !max_queue_depth_.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed)) {
+    }
+}
+
+ClientStats RealtimeLidarClient::get_stats() const {
+    ClientStats stats;
+    stats.frames_received = frames_received_.load(std::memory_order_relaxed);
+    stats.frames_processed = frames_processed_.load(std::memory_order_relaxed);
+    stats.frames_delivered = frames_delivered_.load(std::memory_order_relaxed);
+    stats.frames_overwritten = frames_overwritten_.load(std::memory_order_relaxed);
+    stats.points_received = points_received_.load(std::memory_order_relaxed);
+    stats.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    stats.message_allocations = message_allocations_.load(std::memory_order_relaxed);
+    stats.message_growths = message_growths_.load(std::memory_order_relaxed);
+    stats.frame_pool_misses = frame_pool_->stats().pool_misses - pool_base_.pool_misses;
+    const FrameAllocationCounters allocations = frameAllocationCounters();
+    stats.column_allocations = allocations.allocations - allocation_base_.allocations;
+    stats.huge_page_allocations = allocations.huge_page_allocations - allocation_base_.huge_page_allocations;
+    return stats;
+}
+
+void RealtimeLidarClient::reset_stats() {
+    frames_received_ = 0;
+    frames_processed_ = 0;
+    frames_delivered_ = 0;
+    frames_overwritten_ = 0;
+    points_received_ = 0;
+    max_queue_depth_ = 0;
+    message_allocations_ = 0;
+    message_growths_ = 0;
+    pool_base_ = frame_pool_->stats();
+    allocation_base_ = frameAllocationCounters();
+}
+
+void RealtimeLidarClient::set_frame_pool(const FramePoolConfig& config) {
+    pool_config_ = config;
+    if (initialized_) {
+        prewarm();
+    }
+}
+
+void RealtimeLidarClient::prewarm() {
+    frame_pool_->configure(pool_config_);
+    message_reserve_.store(pool_config_.max_points, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(accumulator_mutex_);
+        if (accumulator_.config().enabled) {
+            accumulator_.reserve(pool_config_.max_points);
+        }
+    }
+
+    // 补足空闲消息并预留点缓冲；已在空闲队列中的消息先取出再放回
+    std::vector<std::shared_ptr<PointCloudMsg>> messages;
+    while (true) {
+        auto msg = free_cloud_queue_.pop();
+        if (!msg) break;
+        messages.push_back(msg);
+    }
+    while (messages.size() < pool_config_.frames) {
+        messages.push_back(std::make_shared<PointCloudMsg>());
+    }
+    for (auto& msg : messages) {
+        if (msg->points.capacity() < pool_config_.max_points) {
+            // 驱动消息不经过FrameAllocator，只能对其点缓冲建议透明大页；再写一遍让页面在预热阶段缺页
+            msg->points.reserve(pool_config_.max_points);
+            adviseHugePages(msg->points.data(), msg->points.capacity() * sizeof(PointT));
+            msg->points.resize(pool_config_.max_points);
+            msg->points.clear();
+        }
+        free_cloud_queue_.push(msg);
+    }
 }
 
 void RealtimeLidarClient::exceptionCallback(const Error& code) {
@@ -276,31 +412,13 @@ void RealtimeLidarClient::convertPointCloudMsg(const std::shared_ptr<PointCloudM
         return;
     }
     
-    // 预分配内存
-    point_cloud.x.resize(N);
-    point_cloud.y.resize(N);
-    point_cloud.z.resize(N);
-    point_cloud.intensity.resize(N);
-    point_cloud.timestamp.resize(N);
-    
-    for (size_t i = 0; i < N; ++i) {
-        const auto& point = msg->points[i];
-        float x = -point.y;
-        float y = point.x;
-        float z = point.z;
-
-        float x_new =  calib_R_[0] * x + calib_R_[1] * y + calib_R_[2] * z + calib_t_[0];
-        float y_new =  calib_R_[3] * x + calib_R_[4] * y + calib_R_[5] * z + calib_t_[1];
-        float z_new =  calib_R_[6] * x + calib_R_[7] * y + calib_R_[8] * z + calib_t_[2];
-        point_cloud.x[i] = x_new;
-        point_cloud.y[i] = y_new;
-        point_cloud.z[i] = z_new;
-        point_cloud.intensity[i] = point.intensity;
-        point_cloud.timestamp[i] = point.timestamp;
-    }
+    // 驱动坐标系先绕z轴旋转90度（x' = -y, y' = x）再施加标定，按标定类别分派到特化内核
+    // 同一遍扫描中按需剔除无效点并统计包围盒
+    const uint32_t fields = FIELD_ALL | convert_flags_.load(std::memory_order_relaxed);
+    convertPoints<PointT, AxisRotateZ90>(msg->points.data(), N, calib_, fields, point_cloud);
     
     point_cloud.frame_id = msg->seq;
-    point_cloud.point_count = N;
+    point_cloud.frame_timestamp = msg->timestamp;
     
 }
 
@@ -312,58 +430,387 @@ void RealtimeLidarClient::set_error(const std::string& error) {
 }
 
 void RealtimeLidarClient::cleanup() {
-    // 清空队列 - 使用pop()直到返回nullptr
+    // 未处理的消息放回空闲队列，池中的消息与帧保留下来供重新初始化后使用
     while (true) {
-        auto msg = free_cloud_queue_.pop();
-        if (!msg) break;
+        auto stamped = stuffed_cloud_queue_.pop();
+        if (!stamped.msg) break;
+        free_cloud_queue_.push(stamped.msg);
     }
-    while (true) {
-        auto msg = stuffed_cloud_queue_.pop();
-        if (!msg) break;
+    {
+        std::lock_guard<std::mutex> lock(cloud_data_mutex_);
+        latest_frame_.reset();
+        has_new_data_ = false;
     }
     
     initialized_ = false;
     connected_ = false;
 }
 
+void RealtimeLidarClient::set_drop_invalid(bool enable, bool scan_index) {
+    uint32_t flags = 0;
+    if (enable) {
+        flags |= CONVERT_DROP_INVALID;
+    }
+    if (scan_index) {
+        flags |= FIELD_SCAN_INDEX;
+    }
+    convert_flags_.store(flags, std::memory_order_relaxed);
+}
+
+void RealtimeLidarClient::set_output_dtype(OutputDType dtype, bool intensity_uint8) {
+    output_dtype_.store(dtype, std::memory_order_relaxed);
+    intensity_uint8_.store(intensity_uint8, std::memory_order_relaxed);
+}
+
+bool RealtimeLidarClient::get_numpy_data(float** data_ptr, size_t& point_count, bool& has_nan) {
+    FramePool::Handle frame;
+    if (!get(frame)) {
+        return false;
+    }
+    const PointCloudData& cloud_data = *frame;
+
+    const size_t n = cloud_data.point_count;
+    numpy_buffer_.resize(n * 3);
+    for (size_t i = 0; i < n; ++i) {
+        numpy_buffer_[i * 3 + 0] = cloud_data.x[i];
+        numpy_buffer_[i * 3 + 1] = cloud_data.y[i];
+        numpy_buffer_[i * 3 + 2] = cloud_data.z[i];
+    }
+    *data_ptr = numpy_buffer_.data();
+    point_count = n;
+    has_nan = !cloud_data.stats.dense && cloud_data.stats.nan_count > 0;
+    return true;
+}
+
 // 将get_numpy方法移到namespace内部
 py::object RealtimeLidarClient::get_numpy() {
-    PointCloudData cloud_data;
-    if (!get(cloud_data)) {
+    FramePool::Handle frame;
+    if (!get(frame)) {
         return py::none();
     }
+    const PointCloudData& cloud_data = *frame;
     
     size_t point_count = cloud_data.point_count;
     if (point_count == 0) {
         return py::none();
     }
     
-    // 直接创建NumPy数组，避免不必要的检查
-    auto result = py::array_t<float>({
-        static_cast<py::ssize_t>(point_count), 
-        static_cast<py::ssize_t>(3)
-    });
-    
-    auto buf = result.request();
-    float* ptr = static_cast<float*>(buf.ptr);
+    // 交错拷贝与降精度转换在同一遍完成
+    const OutputDType dtype = output_dtype_.load(std::memory_order_relaxed);
+    py::array result = newPointArray(static_cast<py::ssize_t>(point_count), dtype);
+    packPoints(cloud_data.x.data(), cloud_data.y.data(), cloud_data.z.data(), point_count, dtype,
+               result.mutable_data());
     
-    // 高效的内存拷贝，避免逐个元素赋值
-    for (size_t i = 0; i < point_count; ++i) {
-        ptr[i * 3 + 0] = cloud_data.x[i];
-        ptr[i * 3 + 1] = cloud_data.y[i];
-        ptr[i * 3 + 2] = cloud_data.z[i];
+    return result;
+}
+
+py::object RealtimeLidarClient::get_frame() {
+    FramePool::Handle frame_data;
+    bool ok = false;
+    {
+        py::gil_scoped_release release;
+        ok = get(frame_data);
+    }
+    if (!ok) {
+        return py::none();
+    }
+    const PointCloudData& cloud_data = *frame_data;
+
+    const size_t n = cloud_data.point_count;
+    const auto count = static_cast<py::ssize_t>(n);
+    const OutputDType dtype = output_dtype_.load(std::memory_order_relaxed);
+    py::array points = newPointArray(count, dtype);
+    packPoints(cloud_data.x.data(), cloud_data.y.data(), cloud_data.z.data(), n, dtype, points.mutable_data());
+
+    py::dict frame;
+    frame["points"] = points;
+    // 点类型不含的字段不输出
+    if (cloud_data.intensity.size() == n) {
+        if (intensity_uint8_.load(std::memory_order_relaxed)) {
+            py::array_t<uint8_t> intensity(count);
+            packIntensity(cloud_data.intensity.data(), n, intensity.mutable_data());
+            frame["intensity"] = intensity;
+        } else {
+            frame["intensity"] = py::array_t<float>(count, cloud_data.intensity.data());
+        }
+    }
+    if (cloud_data.timestamp.size() == n) {
+        frame["timestamp"] = py::array_t<double>(count, cloud_data.timestamp.data());
+    }
+    if (cloud_data.inlier.size() == n) {
+        frame["inlier"] = py::array_t<uint8_t>(count, cloud_data.inlier.data());
+    }
+    if (cloud_data.ground.size() == n) {
+        frame["ground"] = py::array_t<uint8_t>(count, cloud_data.ground.data());
+    }
+    if (cloud_data.scan_index.size() == n) {
+        frame["scan_index"] = py::array_t<uint32_t>(count, cloud_data.scan_index.data());
+    }
+    if (cloud_data.normal_x.size() == n) {
+        auto normals = py::array_t<float>({count, static_cast<py::ssize_t>(3)});
+        float* normal_ptr = normals.mutable_data();
+        for (size_t i = 0; i < n; ++i) {
+            normal_ptr[i * 3 + 0] = cloud_data.normal_x[i];
+            normal_ptr[i * 3 + 1] = cloud_data.normal_y[i];
+            normal_ptr[i * 3 + 2] = cloud_data.normal_z[i];
+        }
+        frame["normals"] = normals;
+        frame["curvature"] = py::array_t<float>(count, cloud_data.curvature.data());
+    }
+    if (cloud_data.cluster.size() == n) {
+        frame["cluster"] = py::array_t<int32_t>(count, cloud_data.cluster.data());
+        frame["clusters"] = clustersToDict(cloud_data.clusters);
+    }
+    if (cloud_data.change.size() == n) {
+        frame["change"] = py::array_t<uint8_t>(count, cloud_data.change.data());
+    }
+    const FrameStats& stats = cloud_data.stats;
+    py::dict frame_stats;
+    frame_stats["raw_count"] = stats.raw_count;
+    frame_stats["valid_count"] = stats.valid_count;
+    frame_stats["nan_count"] = stats.nan_count;
+    frame_stats["min"] = py::array_t<float>(3, stats.min);
+    frame_stats["max"] = py::array_t<float>(3, stats.max);
+    frame["stats"] = frame_stats;
+    frame["frame_id"] = cloud_data.frame_id;
+    frame["receive_time"] = cloud_data.receive_time;
+    frame["ready_time"] = cloud_data.ready_time;
+    return frame;
+}
+
+py::object RealtimeLidarClient::get_accumulated() {
+    // 持有GIL时不取 accumulator_mutex_：等待数据、刷新位姿与导出都在释放GIL后进行，
+    // 导出到成员缓冲后放开累积锁，重新取得GIL再建数组。
+    // accumulated_mutex_ 保护导出缓冲，也只在释放GIL时加锁，持有它去取GIL不会死锁
+    std::unique_lock<std::mutex> scratch_lock(accumulated_mutex_, std::defer_lock);
+    const bool running = running_;
+    bool enabled = false;
+    bool ok = false;
+    size_t count = 0;
+    uint32_t frame_id = 0;
+    double timestamp = 0.0;
+    size_t num_frames = 0;
+    if (running) {
+        py::gil_scoped_release release;
+        {
+            // 等累积窗口加入下一帧，不从 get 系列的最新帧槽位取帧
+            std::unique_lock<std::mutex> lock(accumulator_mutex_);
+            enabled = accumulator_.config().enabled;
+            if (enabled) {
+                const uint64_t seen = accumulator_seq_;
+                accumulator_cv_.wait(lock, [&] {
+                    return accumulator_seq_ != seen || should_stop_processing_ || !accumulator_.config().enabled;
+                });
+                enabled = accumulator_.config().enabled;
+                ok = enabled && accumulator_seq_ != seen;
+            }
+        }
+        if (ok) {
+            scratch_lock.lock();
+            std::lock_guard<std::mutex> lock(accumulator_mutex_);
+            accumulator_.refreshPoses(pose_buffer_);
+            count = accumulator_.size();
+            accumulated_points_.resize(count * 3);
+            accumulated_intensity_.resize(count);
+            accumulated_age_.resize(count);
+            accumulator_.exportPoints(accumulated_points_.data(), 3, accumulated_intensity_.data(),
+                                      accumulated_age_.data());
+            frame_id = accumulator_.latestFrameId();
+            timestamp = accumulator_.latestTimestamp();
+            num_frames = accumulator_.numFrames();
+        }
+    }
+    if (!running) {
+        set_error("Client is not running");
+        return py::none();
+    }
+    if (!enabled) {
+        set_error("Accumulation is not enabled");
+        return py::none();
+    }
+    if (!ok) {
+        return py::none();
+    }
+
+    const auto n = static_cast<py::ssize_t>(count);
+    auto points = py::array_t<float>({n, static_cast<py::ssize_t>(3)});
+    auto intensity = py::array_t<float>(n);
+    auto age = py::array_t<float>(n);
+    std::memcpy(points.mutable_data(), accumulated_points_.data(), count * 3 * sizeof(float));
+    std::memcpy(intensity.mutable_data(), accumulated_intensity_.data(), count * sizeof(float));
+    std::memcpy(age.mutable_data(), accumulated_age_.data(), count * sizeof(float));
+    scratch_lock.unlock();
+
+    py::dict result;
+    result["points"] = points;
+    result["intensity"] = intensity;
+    result["age"] = age;
+    result["frame_id"] = frame_id;
+    result["timestamp"] = timestamp;
+    result["num_frames"] = num_frames;
+    return result;
+}
+
+py::object RealtimeLidarClient::get_bev(BevRasterizer& rasterizer, const py::object& out) {
+    auto result = ensureOutputArray<float>(out, {
+        static_cast<py::ssize_t>(rasterizer.numChannels()),
+        static_cast<py::ssize_t>(rasterizer.height()),
+        static_cast<py::ssize_t>(rasterizer.width())
+    });
+    float* ptr = result.mutable_data();
+
+    // 等待数据与栅格化期间释放GIL
+    bool ok = false;
+    {
+        py::gil_scoped_release release;
+        FramePool::Handle frame;
+        ok = get(frame);
+        if (ok) {
+            // 点已在标定后的坐标系下，无需再融合变换
+            rasterizer.rasterize(*frame, nullptr, ptr);
+        }
+    }
+    if (!ok) {
+        return py::none();
+    }
+    return result;
+}
+
+py::object RealtimeLidarClient::get_depth(CameraProjector& projector, const py::object& out) {
+    std::vector<std::vector<py::ssize_t>> shapes;
+    for (size_t c = 0; c < projector.numCameras(); ++c) {
+        shapes.push_back({static_cast<py::ssize_t>(projector.camera(c).height),
+                          static_cast<py::ssize_t>(projector.camera(c).width)});
+    }
+    auto images = ensureOutputList<float>(out, shapes);
+    std::vector<float*> ptrs;
+    for (auto& image : images) {
+        ptrs.push_back(image.mutable_data());
+    }
+
+    // 等待数据与投影期间释放GIL
+    bool ok = false;
+    {
+        py::gil_scoped_release release;
+        FramePool::Handle frame;
+        ok = get(frame);
+        if (ok) {
+            projector.projectDepth(*frame, ptrs.data());
+        }
+    }
+    if (!ok) {
+        return py::none();
+    }
+    py::list result;
+    for (auto& image : images) {
+        result.append(image);
     }
-    
     return result;
 }
 
+py::object RealtimeLidarClient::get_arrow() {
+    FramePool::Handle frame;
+    bool ok = false;
+    {
+        py::gil_scoped_release release;
+        ok = get(frame);
+    }
+    if (!ok) {
+        return py::none();
+    }
+    // 导出的帧在所有Arrow结构释放后回到帧池
+    return py::cast(ArrowFrameHandle{makeArrowFrame(std::shared_ptr<PointCloudData>(std::move(frame)))});
+}
+
+FrameSource RealtimeLidarClient::frame_source(int max_frames) {
+    int emitted = 0;
+    // 与 get_arrow 相同，直接交出帧池中的帧，不拷贝；帧在记录批释放后回到帧池
+    return [this, max_frames, emitted]() mutable -> std::shared_ptr<PointCloudData> {
+        if (max_frames > 0 && emitted >= max_frames) {
+            return nullptr;
+        }
+        FramePool::Handle frame;
+        if (!get(frame)) {
+            return nullptr;
+        }
+        ++emitted;
+        return std::shared_ptr<PointCloudData>(std::move(frame));
+    };
+}
+
 void RealtimeLidarClient::set_calib(const py::array_t<float>& R,
                             const py::array_t<float>& t) {
     const float* R_data = static_cast<const float*>(R.request().ptr);
     const float* t_data = static_cast<const float*>(t.request().ptr);
-    calib_R_ = {R_data[0], R_data[1], R_data[2], R_data[3], R_data[4], R_data[5], R_data[6], R_data[7], R_data[8]};
-    calib_t_ = {t_data[0], t_data[1], t_data[2]};
+    calib_.R = {R_data[0], R_data[1], R_data[2], R_data[3], R_data[4], R_data[5], R_data[6], R_data[7], R_data[8]};
+    calib_.t = {t_data[0], t_data[1], t_data[2]};
+
+}
+
+void RealtimeLidarClient::push_pose(double timestamp,
+                                    const py::array_t<double>& t,
+                                    const py::array_t<double>& q) {
+    const double* t_data = static_cast<const double*>(t.request().ptr);
+    const double* q_data = static_cast<const double*>(q.request().ptr);
+    Pose pose;
+    pose.timestamp = timestamp;
+    pose.t = {t_data[0], t_data[1], t_data[2]};
+    pose.q = {q_data[0], q_data[1], q_data[2], q_data[3]};
+    pose_buffer_.push(pose);
+}
+
+size_t RealtimeLidarClient::load_poses(const std::string& path) {
+    size_t loaded = pose_buffer_.loadFromFile(path);
+    if (loaded == 0) {
+        set_error("No pose loaded from " + path);
+    }
+    return loaded;
+}
+
+void RealtimeLidarClient::set_outlier_filter(const OutlierFilterConfig& config) {
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    outlier_filter_.setConfig(config);
+}
+
+void RealtimeLidarClient::set_ground_segmentation(const GroundSegmentationConfig& config) {
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    ground_segmenter_.setConfig(config);
+}
+
+void RealtimeLidarClient::set_accumulation(const AccumulatorConfig& config) {
+    // 持有GIL时不取 accumulator_mutex_（见 get_accumulated）
+    py::gil_scoped_release release;
+    {
+        std::lock_guard<std::mutex> lock(accumulator_mutex_);
+        accumulator_.setConfig(config);
+        if (config.enabled) {
+            accumulator_.reserve(pool_config_.max_points);
+        }
+    }
+    accumulator_cv_.notify_all();  // 关闭累积时唤醒等待的 get_accumulated
+}
+
+void RealtimeLidarClient::set_clustering(const ClusteringConfig& config) {
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    clusterer_.setConfig(config);
+}
+
+void RealtimeLidarClient::set_normals(const NormalEstimationConfig& config) {
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    normal_estimator_.setConfig(config);
+}
+
+void RealtimeLidarClient::set_change_detection(const ChangeDetectionConfig& config) {
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    change_detector_.setConfig(config);
+}
 
+void RealtimeLidarClient::set_deskew(bool enable, double bucket_us) {
+    DeskewConfig config;
+    config.enabled = enable;
+    config.bucket_us = bucket_us;
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    deskewer_.setConfig(config);
 }
 
 } // namespace rs_realtime
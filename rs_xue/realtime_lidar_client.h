@@ -14,44 +14,52 @@
 #include <pybind11/pybind11.h>
 
 // RoboSense SDK includes
-#include <rs_driver/api/lidar_driver.hpp>
+#include "lidar_point.h"
 
-#ifdef ENABLE_PCL_POINTCLOUD
-#include <rs_driver/msg/pcl_point_cloud_msg.hpp>
-#else
-#include <rs_driver/msg/point_cloud_msg.hpp>
-#endif
+#include "point_cloud_data.h"
+#include "point_conversion.h"
+#include "pose.h"
+#include "deskew.h"
+#include "bev_rasterizer.h"
+#include "camera_projector.h"
+#include "arrow_export.h"
+#include "outlier_filter.h"
+#include "ground_segmenter.h"
+#include "euclidean_clusterer.h"
+#include "normal_estimator.h"
+#include "change_detector.h"
+#include "reduced_precision.h"
+#include "frame_pool.h"
+#include "frame_accumulator.h"
 
 using namespace robosense::lidar;
 namespace py = pybind11;
-typedef PointXYZIT PointT;
-typedef PointCloudT<PointT> PointCloudMsg;
 
 namespace rs_realtime {
 
 /**
- * @brief 点云数据结构，用于Python接口
+ * @brief 客户端运行计数，用于长时间运行（soak）测试中统计丢帧与积压
  */
-struct PointCloudData {
-    std::vector<float> x;           // X坐标数组
-    std::vector<float> y;           // Y坐标数组  
-    std::vector<float> z;           // Z坐标数组
-    std::vector<float> intensity;   // 强度数组
-    std::vector<double> timestamp;  // 时间戳数组
-    uint32_t frame_id;              // 帧ID
-    size_t point_count;             // 点数量
-    
-    PointCloudData() : frame_id(0), point_count(0) {}
-    
-    void clear() {
-        x.clear();
-        y.clear();
-        z.clear();
-        intensity.clear();
-        timestamp.clear();
-        frame_id = 0;
-        point_count = 0;
-    }
+struct ClientStats {
+    uint64_t frames_received = 0;       // 驱动组帧完成的帧数
+    uint64_t frames_processed = 0;      // 处理线程完成的帧数
+    uint64_t frames_delivered = 0;      // 被 get 系列接口取走的帧数
+    uint64_t frames_overwritten = 0;    // 未被取走就被更新的帧覆盖的帧数
+    uint64_t points_received = 0;       // 驱动输出的总点数
+    uint64_t max_queue_depth = 0;       // 待处理队列出现过的最大深度
+    uint64_t message_allocations = 0;   // 驱动消息池为空时新建的消息数
+    uint64_t message_growths = 0;       // 驱动消息的点缓冲超出预留容量而重新分配的次数
+    uint64_t frame_pool_misses = 0;     // 帧池为空时新建的帧数
+    uint64_t column_allocations = 0;    // 帧列缓冲的分配次数（进程内全局计数）
+    uint64_t huge_page_allocations = 0; // 其中使用大页的分配次数
+};
+
+/**
+ * @brief 驱动输出的一帧及其到达时刻
+ */
+struct StampedCloudMsg {
+    std::shared_ptr<PointCloudMsg> msg;
+    double receive_time = 0.0;          // 单调时钟，秒
 };
 
 /**
@@ -100,9 +108,22 @@ public:
                    const std::string& host_ip);
     
     /**
-     * @brief 获取最新一帧点云数据
+     * @brief 获取最新一帧点云数据（复制到point_cloud，复用其已有容量）
      */
     bool get(PointCloudData& point_cloud);
+
+    /**
+     * @brief 获取最新一帧点云数据，句柄析构时帧回到帧池，稳态下不分配内存
+     */
+    bool get(FramePool::Handle& frame);
+
+    /**
+     * @brief 设置帧池：帧数、每帧预留点数与大页策略
+     *
+     * 在 initialize() 之前调用时于初始化阶段预热，之后调用时立即预热。
+     * 驱动消息池按同样的帧数与点数预热。
+     */
+    void set_frame_pool(const FramePoolConfig& config);
  
     /**
      * @brief 获取点云数据作为NumPy数组
@@ -113,12 +134,44 @@ public:
     /**
      * @brief 获取点云数据并转换为适合Python的格式
      * 
-     * @param data_ptr 输出参数，指向数据缓冲区的指针
+     * @param data_ptr 输出参数，指向 (N, 3) 交错缓冲区的指针，有效期到下一次调用为止
      * @param point_count 输出参数，点的数量
-     * @param has_nan 输出参数，是否检测到NaN值
+     * @param has_nan 输出参数，帧中是否含有未被剔除的NaN/Inf点（取自转换时的帧统计）
      * @return true 成功获取数据，false 失败
      */
     bool get_numpy_data(float** data_ptr, size_t& point_count, bool& has_nan);
+
+    /**
+     * @brief 获取最新一帧并栅格化为BEV张量
+     *
+     * @param rasterizer BEV栅格化器
+     * @param out 可选的预分配 (C, H, W) float32 数组，传入时原地写入并返回
+     * @return pybind11::object BEV数组或None
+     */
+    pybind11::object get_bev(BevRasterizer& rasterizer, const pybind11::object& out);
+
+    /**
+     * @brief 获取最新一帧并投影为各相机的稀疏深度图
+     *
+     * @param projector 多相机投影器
+     * @param out 可选的预分配深度图序列，每个为 (H, W) float32，传入时原地写入
+     * @return pybind11::object 深度图列表或None
+     */
+    pybind11::object get_depth(CameraProjector& projector, const pybind11::object& out);
+
+    /**
+     * @brief 获取最新一帧，包装为可零拷贝导出的Arrow记录批
+     *
+     * @return pybind11::object ArrowFrame（实现 __arrow_c_array__）或None
+     */
+    pybind11::object get_arrow();
+
+    /**
+     * @brief 逐帧拉取的帧源，供Arrow流导出；客户端停止时结束
+     *
+     * @param max_frames 最多输出的帧数，0表示不限制
+     */
+    FrameSource frame_source(int max_frames);
     
  
     
@@ -156,20 +209,131 @@ public:
     void set_calib(const py::array_t<float>& R,
                             const py::array_t<float>& t);
 
+    /**
+     * @brief 推送一条位姿（标定后坐标系在世界系下的位姿），用于运动补偿
+     *
+     * @param timestamp 位姿时间戳，与点的时间戳同一时钟（秒）
+     * @param t 平移 (3,)
+     * @param q 四元数 (4,)，顺序为 x, y, z, w
+     */
+    void push_pose(double timestamp,
+                   const py::array_t<double>& t,
+                   const py::array_t<double>& q);
+
+    /**
+     * @brief 从TUM格式文件加载位姿
+     *
+     * @return 加载的位姿数量
+     */
+    size_t load_poses(const std::string& path);
+
+    /**
+     * @brief 启用/关闭运动补偿
+     *
+     * @param enable 是否启用
+     * @param bucket_us 时间桶长度（微秒），同一桶内的点共用一次位姿插值
+     */
+    void set_deskew(bool enable, double bucket_us);
+
+    /**
+     * @brief 设置无效点剔除：转换时直接丢弃坐标含NaN/Inf的点
+     *
+     * @param enable 是否剔除
+     * @param scan_index 是否输出每个点在驱动原始帧中的下标（uint32）
+     */
+    void set_drop_invalid(bool enable, bool scan_index);
+
+    /**
+     * @brief 设置 get_numpy / get_frame 输出的坐标精度，以及强度是否输出为uint8
+     *
+     * 处理阶段仍在float32列上计算，降精度只发生在交错输出的那一遍拷贝中。
+     * bfloat16 以 uint16 位模式输出（numpy没有bfloat16类型）。
+     */
+    void set_output_dtype(OutputDType dtype, bool intensity_uint8);
+
+    /**
+     * @brief 设置离群点过滤（method为NONE时关闭）
+     */
+    void set_outlier_filter(const OutlierFilterConfig& config);
+
+    /**
+     * @brief 设置地面分割（enabled为false时关闭）
+     */
+    void set_ground_segmentation(const GroundSegmentationConfig& config);
+
+    /**
+     * @brief 设置欧氏聚类（enabled为false时关闭）
+     */
+    void set_clustering(const ClusteringConfig& config);
+
+    /**
+     * @brief 设置法向与曲率估计（enabled为false时关闭）
+     */
+    void set_normals(const NormalEstimationConfig& config);
+
+    /**
+     * @brief 设置帧间变化检测（enabled为false时关闭），重新设置时清空历史
+     */
+    void set_change_detection(const ChangeDetectionConfig& config);
+
+    /**
+     * @brief 设置多帧累积（enabled为false时关闭），重新设置时清空窗口
+     */
+    void set_accumulation(const AccumulatorConfig& config);
+
+    /**
+     * @brief 等待下一帧加入累积窗口，返回窗口内的点
+     *
+     * 不从最新帧槽位取帧，不影响 get / get_frame / get_bev / get_arrow，也不计入 frames_delivered。
+     *
+     * @return dict: points (N,3), intensity (N,), age (N,)（点所在帧早于最新帧的时长，秒），
+     *         frame_id / timestamp（窗口内最新帧），num_frames；未启用或无数据时返回None
+     */
+    pybind11::object get_accumulated();
+
+    /**
+     * @brief 获取最新一帧的全部字段
+     *
+     * @return dict: points (N,3)（精度见 set_output_dtype）, intensity (N,), timestamp (N,), frame_id，
+     *         receive_time / ready_time（整帧到达与处理完成的单调时钟时刻，秒），
+     *         stats（转换时的帧统计：raw_count, valid_count, nan_count, min (3,), max (3,)），
+     *         请求了原始下标时额外包含 scan_index (N,) uint32，
+     *         离群点过滤处于掩码模式时额外包含 inlier (N,) uint8，
+     *         地面分割处于标签模式时额外包含 ground (N,) uint8，
+     *         启用法向估计时额外包含 normals (N,3) 与 curvature (N,)，
+     *         启用聚类时额外包含 cluster (N,) int32 与 clusters（count, centroid, min, max），
+     *         启用变化检测时额外包含 change (N,) uint8（取值见 ChangeLabel）；无数据时返回None
+     */
+    pybind11::object get_frame();
+
+    /**
+     * @brief 获取运行计数的快照
+     */
+    ClientStats get_stats() const;
+
+    /**
+     * @brief 清零运行计数
+     */
+    void reset_stats();
+
 private:
     std::unique_ptr<LidarDriver<PointCloudMsg>> driver_;       // RoboSense驱动
     RSDriverParam param_;                                      // 驱动参数
     
     // 队列管理
     SyncQueue<std::shared_ptr<PointCloudMsg>> free_cloud_queue_;    // 空闲点云队列
-    SyncQueue<std::shared_ptr<PointCloudMsg>> stuffed_cloud_queue_; // 填充点云队列
+    SyncQueue<StampedCloudMsg> stuffed_cloud_queue_;                // 填充点云队列（附带到达时刻）
     
     // 新增：后台处理线程和数据缓冲
     std::thread processing_thread_;                            // 后台处理线程
     std::atomic<bool> should_stop_processing_;                 // 处理线程停止标志
     
     // 最新点云数据存储（替换队列）
-    PointCloudData latest_cloud_data_;                         // 最新的点云数据
+    std::shared_ptr<FramePool> frame_pool_;                    // 帧池，处理线程取帧、使用方用完归还
+    FramePoolConfig pool_config_;                              // 帧池与消息池的预热配置
+    std::atomic<size_t> message_reserve_ {0};                  // 新建驱动消息时预留的点数
+    std::atomic<size_t> handed_capacity_ {0};                  // 最近交给驱动的消息的点缓冲容量
+    FramePool::Handle latest_frame_;                           // 最新的点云数据
     std::mutex cloud_data_mutex_;                              // 保护点云数据的互斥锁
     std::condition_variable cloud_data_cv_;                    // 条件变量，用于通知新数据到达
     bool has_new_data_;                                        // 标记是否有新数据
@@ -179,8 +343,43 @@ private:
     std::atomic<bool> running_;                                // 运行状态
     std::atomic<bool> connected_;                              // 连接状态
                                                                //
-    std::array<float, 9> calib_R_ {1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f};
-    std::array<float, 3> calib_t_ {0.f, 0.f, 0.f};
+    RigidTransform calib_;                                     // 标定变换，默认单位变换
+    std::atomic<uint32_t> convert_flags_ {0};                  // 附加的转换选项（无效点剔除、原始下标）
+    std::atomic<OutputDType> output_dtype_ {OutputDType::FLOAT32}; // get_numpy / get_frame 的坐标精度
+    std::atomic<bool> intensity_uint8_ {false};                // get_frame 的强度输出为uint8
+    std::vector<float> numpy_buffer_;                          // get_numpy_data 的交错输出缓冲
+
+    // 处理阶段（运动补偿等），由 pipeline_mutex_ 保护配置与处理线程之间的并发
+    std::mutex pipeline_mutex_;
+    PoseBuffer pose_buffer_ {4096};                            // 位姿缓冲（内部自带锁）
+    Deskewer deskewer_;                                        // 运动补偿
+    OutlierFilter outlier_filter_;                             // 离群点过滤
+    GroundSegmenter ground_segmenter_;                         // 地面分割
+    NormalEstimator normal_estimator_;                         // 法向与曲率估计
+    EuclideanClusterer clusterer_;                             // 欧氏聚类
+    ChangeDetector change_detector_;                           // 帧间变化检测
+
+    // 多帧累积，处理线程写入、get_accumulated 读取
+    std::mutex accumulator_mutex_;
+    FrameAccumulator accumulator_;
+    uint64_t accumulator_seq_ = 0;                             // 加入窗口的帧数，由 accumulator_mutex_ 保护
+    std::condition_variable accumulator_cv_;                   // 窗口加入新帧、关闭累积或停止时通知
+    std::mutex accumulated_mutex_;                             // 保护 get_accumulated 的导出缓冲，只在释放GIL时加锁
+    std::vector<float> accumulated_points_;                    // get_accumulated 的导出缓冲 (N, 3)
+    std::vector<float> accumulated_intensity_;
+    std::vector<float> accumulated_age_;
+
+    // 运行计数（驱动回调、处理线程与get分别更新）
+    std::atomic<uint64_t> frames_received_ {0};
+    std::atomic<uint64_t> frames_processed_ {0};
+    std::atomic<uint64_t> frames_delivered_ {0};
+    std::atomic<uint64_t> frames_overwritten_ {0};
+    std::atomic<uint64_t> points_received_ {0};
+    std::atomic<uint64_t> max_queue_depth_ {0};
+    std::atomic<uint64_t> message_allocations_ {0};
+    std::atomic<uint64_t> message_growths_ {0};
+    FrameAllocationCounters allocation_base_;                  // reset_stats 时的全局分配计数
+    FramePoolStats pool_base_;                                 // reset_stats 时的帧池计数
     
     // 错误处理
     mutable std::mutex error_mutex_;                           // 错误信息互斥锁
@@ -199,6 +398,7 @@ private:
                              PointCloudData& point_cloud);
     
     // 工具函数
+    void prewarm();
     void set_error(const std::string& error);
     void cleanup();
 };
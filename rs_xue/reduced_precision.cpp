@@ -0,0 +1,240 @@
+#include "reduced_precision.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RS_XUE_X86 1
+#endif
+
+namespace rs_realtime {
+
+namespace {
+
+inline uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bitsFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void packScalar(const float* x, const float* y, const float* z, size_t begin, size_t n, OutputDType dtype,
+                uint16_t* out) {
+    auto convert = dtype == OutputDType::FLOAT16 ? floatToHalf : floatToBFloat16;
+    for (size_t i = begin; i < n; ++i) {
+        out[i * 3 + 0] = convert(x[i]);
+        out[i * 3 + 1] = convert(y[i]);
+        out[i * 3 + 2] = convert(z[i]);
+    }
+}
+
+#ifdef RS_XUE_X86
+
+// 8个x、8个y、8个z（各一个寄存器的16位值）交错为24个值：输出寄存器r的第w个值是全局第 j = 8r + w 个，
+// 取自第 j % 3 个输入的第 j / 3 个lane；每个输出寄存器由三次 pshufb 相或得到
+struct InterleaveMasks {
+    int8_t bytes[3][3][16];
+};
+
+constexpr InterleaveMasks makeInterleaveMasks() {
+    InterleaveMasks masks {};
+    for (int r = 0; r < 3; ++r) {
+        for (int s = 0; s < 3; ++s) {
+            for (int w = 0; w < 8; ++w) {
+                const int j = 8 * r + w;
+                const bool hit = j % 3 == s;
+                masks.bytes[r][s][2 * w] = static_cast<int8_t>(hit ? 2 * (j / 3) : -128);
+                masks.bytes[r][s][2 * w + 1] = static_cast<int8_t>(hit ? 2 * (j / 3) + 1 : -128);
+            }
+        }
+    }
+    return masks;
+}
+
+constexpr InterleaveMasks kInterleaveMasks = makeInterleaveMasks();
+
+__attribute__((target("ssse3")))
+inline void storeInterleaved(__m128i hx, __m128i hy, __m128i hz, uint16_t* out) {
+    for (int r = 0; r < 3; ++r) {
+        const __m128i mx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kInterleaveMasks.bytes[r][0]));
+        const __m128i my = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kInterleaveMasks.bytes[r][1]));
+        const __m128i mz = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kInterleaveMasks.bytes[r][2]));
+        const __m128i v = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(hx, mx), _mm_shuffle_epi8(hy, my)),
+                                       _mm_shuffle_epi8(hz, mz));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8 * r), v);
+    }
+}
+
+__attribute__((target("avx,f16c")))
+void packHalfF16C(const float* x, const float* y, const float* z, size_t n, uint16_t* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i hx = _mm256_cvtps_ph(_mm256_loadu_ps(x + i), _MM_FROUND_TO_NEAREST_INT);
+        const __m128i hy = _mm256_cvtps_ph(_mm256_loadu_ps(y + i), _MM_FROUND_TO_NEAREST_INT);
+        const __m128i hz = _mm256_cvtps_ph(_mm256_loadu_ps(z + i), _MM_FROUND_TO_NEAREST_INT);
+        storeInterleaved(hx, hy, hz, out + i * 3);
+    }
+    packScalar(x, y, z, i, n, OutputDType::FLOAT16, out);
+}
+
+// 4个float舍入到bfloat16，结果在每个32位lane的低16位
+__attribute__((target("sse4.1")))
+inline __m128i bfloat16x4(__m128 v) {
+    const __m128i bits = _mm_castps_si128(v);
+    const __m128i lsb = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+    const __m128i rounded = _mm_add_epi32(bits, _mm_add_epi32(_mm_set1_epi32(0x7fff), lsb));
+    // NaN不参与舍入（进位可能变成inf），只置静默位
+    const __m128i quiet = _mm_or_si128(bits, _mm_set1_epi32(0x00400000));
+    const __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(v, v));
+    return _mm_srli_epi32(_mm_blendv_epi8(rounded, quiet, is_nan), 16);
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i bfloat16x8(const float* p) {
+    return _mm_packus_epi32(bfloat16x4(_mm_loadu_ps(p)), bfloat16x4(_mm_loadu_ps(p + 4)));
+}
+
+__attribute__((target("sse4.1")))
+void packBFloat16SSE41(const float* x, const float* y, const float* z, size_t n, uint16_t* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        storeInterleaved(bfloat16x8(x + i), bfloat16x8(y + i), bfloat16x8(z + i), out + i * 3);
+    }
+    packScalar(x, y, z, i, n, OutputDType::BFLOAT16, out);
+}
+
+__attribute__((target("avx,f16c")))
+void unpackHalfF16C(const uint16_t* in, size_t n, float* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+    }
+    for (; i < n; ++i) {
+        out[i] = halfToFloat(in[i]);
+    }
+}
+
+bool hasF16C() {
+    static const bool supported = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    return supported;
+}
+
+bool hasSSE41() {
+    static const bool supported = __builtin_cpu_supports("sse4.1");
+    return supported;
+}
+
+#endif
+
+} // namespace
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits = floatBits(value);
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    bits &= 0x7fffffffu;
+    if (bits > 0x7f800000u) {
+        // NaN：保留尾数高位并置静默位，与F16C一致
+        return static_cast<uint16_t>(sign | 0x7e00u | ((bits >> 13) & 0x3ffu));
+    }
+    if (bits >= 0x477ff000u) {
+        // 不小于65520的值舍入后超出半精度范围
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+    if (bits < 0x38800000u) {
+        // 结果为非规格化数或0：加0.5使尾数对齐到 2^-24，由硬件完成舍入
+        const float shifted = bitsFloat(bits) + 0.5f;
+        return static_cast<uint16_t>(sign | (floatBits(shifted) - 0x3f000000u));
+    }
+    // 规格化数：指数偏置由127改为15，尾数舍入到10位（到最近偶数）
+    const uint32_t odd = (bits >> 13) & 1u;
+    bits += 0xc8000fffu + odd;
+    return static_cast<uint16_t>(sign | (bits >> 13));
+}
+
+float halfToFloat(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t magnitude = value & 0x7fffu;
+    uint32_t bits;
+    if (magnitude == 0x7c00u) {
+        bits = 0x7f800000u;
+    } else if (magnitude > 0x7c00u) {
+        // NaN：置静默位，与F16C一致
+        bits = 0x7fc00000u | ((magnitude & 0x3ffu) << 13);
+    } else if (magnitude >= 0x0400u) {
+        bits = (magnitude << 13) + 0x38000000u;
+    } else {
+        bits = floatBits(static_cast<float>(magnitude) * 5.9604644775390625e-8f);  // 2^-24
+    }
+    return bitsFloat(bits | sign);
+}
+
+uint16_t floatToBFloat16(float value) {
+    const uint32_t bits = floatBits(value);
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((bits | 0x00400000u) >> 16);
+    }
+    return static_cast<uint16_t>((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+}
+
+float bfloat16ToFloat(uint16_t value) {
+    return bitsFloat(static_cast<uint32_t>(value) << 16);
+}
+
+void packPoints(const float* x, const float* y, const float* z, size_t n, OutputDType dtype, void* out) {
+    if (dtype == OutputDType::FLOAT32) {
+        float* dst = static_cast<float*>(out);
+        for (size_t i = 0; i < n; ++i) {
+            dst[i * 3 + 0] = x[i];
+            dst[i * 3 + 1] = y[i];
+            dst[i * 3 + 2] = z[i];
+        }
+        return;
+    }
+    uint16_t* dst = static_cast<uint16_t*>(out);
+#ifdef RS_XUE_X86
+    if (dtype == OutputDType::FLOAT16 && hasF16C()) {
+        packHalfF16C(x, y, z, n, dst);
+        return;
+    }
+    if (dtype == OutputDType::BFLOAT16 && hasSSE41()) {
+        packBFloat16SSE41(x, y, z, n, dst);
+        return;
+    }
+#endif
+    packScalar(x, y, z, 0, n, dtype, dst);
+}
+
+void packIntensity(const float* intensity, size_t n, uint8_t* out) {
+    for (size_t i = 0; i < n; ++i) {
+        // NaN不满足 v > 0，落到0
+        const float v = intensity[i];
+        const float clamped = v > 0.f ? (v < 255.f ? v : 255.f) : 0.f;
+        out[i] = static_cast<uint8_t>(clamped + 0.5f);
+    }
+}
+
+void unpackValues(const uint16_t* in, size_t n, OutputDType dtype, float* out) {
+    if (dtype == OutputDType::BFLOAT16) {
+        // 移位即可，编译器直接向量化
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = bfloat16ToFloat(in[i]);
+        }
+        return;
+    }
+#ifdef RS_XUE_X86
+    if (hasF16C()) {
+        unpackHalfF16C(in, n, out);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = halfToFloat(in[i]);
+    }
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rs_realtime {
+
+/**
+ * @brief 坐标输出精度
+ */
+enum class OutputDType {
+    FLOAT32,        // 单精度
+    FLOAT16,        // IEEE半精度，±65504，1米处约0.5毫米、100米处约6厘米的分辨率
+    BFLOAT16        // bfloat16（保存为uint16位模式），与float32同范围，只保留8位尾数
+};
+
+/**
+ * @brief 每个分量占用的字节数
+ */
+inline size_t dtypeSize(OutputDType dtype) {
+    return dtype == OutputDType::FLOAT32 ? 4 : 2;
+}
+
+/**
+ * @brief 单个值的转换，舍入到最近偶数；溢出为±inf，NaN保持为NaN
+ */
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t value);
+uint16_t floatToBFloat16(float value);
+float bfloat16ToFloat(uint16_t value);
+
+/**
+ * @brief 把SoA坐标交错写为 (n, 3) 的 dtype 数组，转换与交错在同一遍完成
+ *
+ * CPU支持F16C（半精度）或SSE4.1（bfloat16）时运行时分派到向量实现，每次处理8个点；
+ * 否则逐点转换。结果与逐点转换逐位相同。
+ */
+void packPoints(const float* x, const float* y, const float* z, size_t n, OutputDType dtype, void* out);
+
+/**
+ * @brief 强度转为uint8：四舍五入并截断到 [0, 255]，NaN为0
+ */
+void packIntensity(const float* intensity, size_t n, uint8_t* out);
+
+/**
+ * @brief 把 n 个半精度或bfloat16值展开为float32（读取降精度输出时使用）
+ */
+void unpackValues(const uint16_t* in, size_t n, OutputDType dtype, float* out);
+
+} // namespace rs_realtime
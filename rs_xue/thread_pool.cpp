@@ -0,0 +1,132 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace rs_realtime {
+
+namespace {
+
+// 标记当前线程是否正在执行线程池任务，用于嵌套调用时退化为串行
+thread_local bool t_in_pool = false;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : generation_(0),
+      pending_(0),
+      stop_(false),
+      fn_(nullptr),
+      n_(0),
+      grain_(1),
+      next_(0) {
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(num_threads - 1);
+    for (size_t i = 1; i < num_threads; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::runChunks(size_t worker) {
+    while (true) {
+        const size_t begin = next_.fetch_add(grain_);
+        if (begin >= n_) {
+            break;
+        }
+        try {
+            (*fn_)(begin, std::min(begin + grain_, n_), worker);
+        } catch (...) {
+            // 记下第一个异常，跳过剩余的块，由调用线程在全部线程退出回调后重新抛出
+            next_.store(n_);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            break;
+        }
+    }
+}
+
+void ThreadPool::workerLoop(size_t worker) {
+    t_in_pool = true;
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        runChunks(worker);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, size_t grain, const RangeFn& fn) {
+    if (n == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    if (workers_.empty() || t_in_pool || n <= grain) {
+        fn(0, n, 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submit_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fn_ = &fn;
+        n_ = n;
+        grain_ = grain;
+        next_.store(0);
+        pending_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    work_cv_.notify_all();
+
+    // 调用线程作为0号worker参与计算
+    t_in_pool = true;
+    runChunks(0);
+    t_in_pool = false;
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return pending_ == 0; });
+        fn_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace rs_realtime
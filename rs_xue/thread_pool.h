@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rs_realtime {
+
+/**
+ * @brief 常驻工作线程池，供各点云处理阶段做数据并行
+ *
+ * parallelFor 把 [0, n) 按 grain 切块，调用线程与工作线程一起抢块执行。
+ * 回调收到的 worker 编号在 [0, size()) 之内，可用来索引每线程私有的临时缓冲。
+ * 不同线程同时提交的任务串行执行；在回调内部嵌套调用 parallelFor 时直接在当前线程串行执行。
+ * 回调抛出异常时其余未开始的块被跳过，parallelFor 等所有线程退出回调后在调用线程重新抛出第一个异常。
+ */
+class ThreadPool {
+public:
+    using RangeFn = std::function<void(size_t begin, size_t end, size_t worker)>;
+
+    /**
+     * @param num_threads 参与计算的线程总数（含调用线程），0表示使用硬件并发数
+     */
+    explicit ThreadPool(size_t num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief 参与计算的线程总数（含调用线程）
+     */
+    size_t size() const { return workers_.size() + 1; }
+
+    void parallelFor(size_t n, size_t grain, const RangeFn& fn);
+
+    /**
+     * @brief 进程内共享的线程池
+     */
+    static ThreadPool& global();
+
+private:
+    void workerLoop(size_t worker);
+    void runChunks(size_t worker);
+
+    std::vector<std::thread> workers_;
+    std::mutex submit_mutex_;              // 串行化不同线程提交的任务
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_;
+    size_t pending_;
+    bool stop_;
+
+    // 当前任务
+    const RangeFn* fn_;
+    size_t n_;
+    size_t grain_;
+    std::atomic<size_t> next_;
+    std::exception_ptr error_;             // 本次任务中回调抛出的第一个异常
+};
+
+} // namespace rs_realtime
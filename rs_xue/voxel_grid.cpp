@@ -0,0 +1,172 @@
+#include "voxel_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rs_realtime {
+
+namespace {
+
+// 每个轴21位，坐标偏移后打包进64位键
+constexpr int32_t kAxisOffset = 1 << 20;
+constexpr uint64_t kAxisMask = (1ull << 21) - 1;
+constexpr uint64_t kEmptyKey = ~0ull;
+
+} // namespace
+
+uint64_t VoxelHashGrid::packKey(int32_t cx, int32_t cy, int32_t cz) {
+    return ((static_cast<uint64_t>(cx + kAxisOffset) & kAxisMask) << 42) |
+           ((static_cast<uint64_t>(cy + kAxisOffset) & kAxisMask) << 21) |
+           (static_cast<uint64_t>(cz + kAxisOffset) & kAxisMask);
+}
+
+void VoxelHashGrid::unpackKey(uint64_t key, int32_t* coord) {
+    coord[0] = static_cast<int32_t>((key >> 42) & kAxisMask) - kAxisOffset;
+    coord[1] = static_cast<int32_t>((key >> 21) & kAxisMask) - kAxisOffset;
+    coord[2] = static_cast<int32_t>(key & kAxisMask) - kAxisOffset;
+}
+
+uint64_t VoxelHashGrid::hashKey(uint64_t key) {
+    // splitmix64 末级混合
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return key;
+}
+
+void VoxelHashGrid::build(const float* x, const float* y, const float* z, size_t n, size_t stride,
+                          float cell_size) {
+    cell_size_ = cell_size;
+    inv_cell_size_ = 1.f / cell_size;
+
+    // 哈希表容量取不小于2n的2的幂，保证装载因子不超过0.5
+    size_t capacity = 16;
+    while (capacity < 2 * n) {
+        capacity <<= 1;
+    }
+    table_key_.assign(capacity, kEmptyKey);
+    table_cell_.resize(capacity);
+    table_mask_ = capacity - 1;
+
+    cell_key_.clear();
+    cell_coord_.clear();
+    cell_begin_.clear();
+    point_cell_.resize(n);
+
+    // 第一步：计算每个点的体素并登记到哈希表，同时统计每个体素的点数
+    for (size_t i = 0; i < n; ++i) {
+        const float px = x[i * stride];
+        const float py = y[i * stride];
+        const float pz = z[i * stride];
+        if (!std::isfinite(px) || !std::isfinite(py) || !std::isfinite(pz)) {
+            point_cell_[i] = kInvalidCell;
+            continue;
+        }
+        const int32_t cx = static_cast<int32_t>(std::floor(px * inv_cell_size_));
+        const int32_t cy = static_cast<int32_t>(std::floor(py * inv_cell_size_));
+        const int32_t cz = static_cast<int32_t>(std::floor(pz * inv_cell_size_));
+        const uint64_t key = packKey(cx, cy, cz);
+
+        uint64_t slot = hashKey(key) & table_mask_;
+        while (table_key_[slot] != kEmptyKey && table_key_[slot] != key) {
+            slot = (slot + 1) & table_mask_;
+        }
+        if (table_key_[slot] == kEmptyKey) {
+            table_key_[slot] = key;
+            table_cell_[slot] = static_cast<uint32_t>(cell_key_.size());
+            cell_key_.push_back(key);
+            cell_coord_.push_back(cx);
+            cell_coord_.push_back(cy);
+            cell_coord_.push_back(cz);
+            cell_begin_.push_back(0);
+        }
+        const uint32_t cell = table_cell_[slot];
+        point_cell_[i] = cell;
+        cell_begin_[cell] += 1;
+    }
+
+    // 第二步：计数转前缀和
+    const size_t num_cells = cell_key_.size();
+    cell_begin_.push_back(0);
+    uint32_t running = 0;
+    for (size_t c = 0; c <= num_cells; ++c) {
+        const uint32_t count = cell_begin_[c];
+        cell_begin_[c] = running;
+        running += count;
+    }
+
+    // 第三步：按体素分散点下标与坐标
+    cursor_.assign(cell_begin_.begin(), cell_begin_.end() - 1);
+    sorted_index_.resize(running);
+    sx_.resize(running);
+    sy_.resize(running);
+    sz_.resize(running);
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t cell = point_cell_[i];
+        if (cell == kInvalidCell) {
+            continue;
+        }
+        const uint32_t pos = cursor_[cell]++;
+        sorted_index_[pos] = static_cast<uint32_t>(i);
+        sx_[pos] = x[i * stride];
+        sy_[pos] = y[i * stride];
+        sz_[pos] = z[i * stride];
+    }
+}
+
+uint32_t VoxelHashGrid::findCell(int32_t cx, int32_t cy, int32_t cz) const {
+    if (table_key_.empty()) {
+        return kInvalidCell;
+    }
+    const uint64_t key = packKey(cx, cy, cz);
+    uint64_t slot = hashKey(key) & table_mask_;
+    while (table_key_[slot] != kEmptyKey) {
+        if (table_key_[slot] == key) {
+            return table_cell_[slot];
+        }
+        slot = (slot + 1) & table_mask_;
+    }
+    return kInvalidCell;
+}
+
+uint32_t VoxelHashGrid::findCell(float px, float py, float pz) const {
+    if (!std::isfinite(px) || !std::isfinite(py) || !std::isfinite(pz)) {
+        return kInvalidCell;
+    }
+    return findCell(static_cast<int32_t>(std::floor(px * inv_cell_size_)),
+                    static_cast<int32_t>(std::floor(py * inv_cell_size_)),
+                    static_cast<int32_t>(std::floor(pz * inv_cell_size_)));
+}
+
+size_t VoxelHashGrid::neighborCellsAt(int32_t cx, int32_t cy, int32_t cz, uint32_t* out) const {
+    size_t count = 0;
+    for (int32_t dx = -1; dx <= 1; ++dx) {
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            for (int32_t dz = -1; dz <= 1; ++dz) {
+                const uint32_t nc = findCell(cx + dx, cy + dy, cz + dz);
+                if (nc != kInvalidCell) {
+                    out[count++] = nc;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+size_t VoxelHashGrid::neighborCells(uint32_t c, uint32_t* out) const {
+    const int32_t* coord = cellCoord(c);
+    return neighborCellsAt(coord[0], coord[1], coord[2], out);
+}
+
+size_t VoxelHashGrid::neighborCells(float px, float py, float pz, uint32_t* out) const {
+    if (!std::isfinite(px) || !std::isfinite(py) || !std::isfinite(pz)) {
+        return 0;
+    }
+    return neighborCellsAt(static_cast<int32_t>(std::floor(px * inv_cell_size_)),
+                           static_cast<int32_t>(std::floor(py * inv_cell_size_)),
+                           static_cast<int32_t>(std::floor(pz * inv_cell_size_)), out);
+}
+
+} // namespace rs_realtime
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rs_realtime {
+
+/**
+ * @brief 体素分桶的近邻索引
+ *
+ * 按 cell_size 把点划入体素，体素坐标打包成64位键放入开放寻址哈希表；
+ * 点按体素计数排序，同一体素的点在 sorted 数组中连续，坐标也按该顺序拷贝一份，
+ * 邻域查询只需扫描相邻的27个体素的连续区间。
+ * 非有限坐标（NaN/Inf）的点不进入索引。实例可跨帧复用，内部缓冲不会反复分配。
+ */
+class VoxelHashGrid {
+public:
+    static constexpr uint32_t kInvalidCell = 0xffffffffu;
+
+    /**
+     * @brief 建立索引
+     *
+     * @param stride 相邻点同一字段之间的间隔（以float计）
+     */
+    void build(const float* x, const float* y, const float* z, size_t n, size_t stride, float cell_size);
+
+    void build(const float* x, const float* y, const float* z, size_t n, float cell_size) {
+        build(x, y, z, n, 1, cell_size);
+    }
+
+    float cellSize() const { return cell_size_; }
+    size_t numPoints() const { return point_cell_.size(); }
+    size_t numCells() const { return cell_key_.size(); }
+
+    /**
+     * @brief 原始下标对应的体素编号，无效点为 kInvalidCell
+     */
+    uint32_t pointCell(size_t i) const { return point_cell_[i]; }
+
+    /**
+     * @brief 体素c内的点在排序数组中的区间 [cellBegin(c), cellEnd(c))
+     */
+    uint32_t cellBegin(uint32_t c) const { return cell_begin_[c]; }
+    uint32_t cellEnd(uint32_t c) const { return cell_begin_[c + 1]; }
+
+    /**
+     * @brief 体素的整数坐标
+     */
+    const int32_t* cellCoord(uint32_t c) const { return &cell_coord_[c * 3]; }
+
+    /**
+     * @brief 排序位置到原始下标的映射，以及按排序位置存放的坐标
+     */
+    const uint32_t* sortedIndex() const { return sorted_index_.data(); }
+    const float* sortedX() const { return sx_.data(); }
+    const float* sortedY() const { return sy_.data(); }
+    const float* sortedZ() const { return sz_.data(); }
+
+    /**
+     * @brief 查找给定整数坐标的体素，不存在时返回 kInvalidCell
+     */
+    uint32_t findCell(int32_t cx, int32_t cy, int32_t cz) const;
+
+    /**
+     * @brief 查找任意坐标所在的体素，不存在时返回 kInvalidCell
+     */
+    uint32_t findCell(float px, float py, float pz) const;
+
+    /**
+     * @brief 收集体素c及其26邻域中存在的体素，返回数量（不超过27）
+     */
+    size_t neighborCells(uint32_t c, uint32_t* out) const;
+
+    /**
+     * @brief 收集任意坐标周围3x3x3范围内存在的体素，返回数量（不超过27）
+     */
+    size_t neighborCells(float px, float py, float pz, uint32_t* out) const;
+
+    /**
+     * @brief 体素整数坐标打包成64位键（每轴21位），以及键的哈希
+     */
+    static uint64_t packKey(int32_t cx, int32_t cy, int32_t cz);
+    static uint64_t hashKey(uint64_t key);
+
+    /**
+     * @brief packKey 的逆运算，写出 (cx, cy, cz)
+     */
+    static void unpackKey(uint64_t key, int32_t* coord);
+
+private:
+    size_t neighborCellsAt(int32_t cx, int32_t cy, int32_t cz, uint32_t* out) const;
+
+    float cell_size_ = 1.f;
+    float inv_cell_size_ = 1.f;
+
+    // 开放寻址哈希表：键 -> 体素编号
+    std::vector<uint64_t> table_key_;
+    std::vector<uint32_t> table_cell_;
+    uint64_t table_mask_ = 0;
+
+    std::vector<uint64_t> cell_key_;
+    std::vector<int32_t> cell_coord_;
+    std::vector<uint32_t> cell_begin_;
+    std::vector<uint32_t> cursor_;
+
+    std::vector<uint32_t> point_cell_;
+    std::vector<uint32_t> sorted_index_;
+    std::vector<float> sx_;
+    std::vector<float> sy_;
+    std::vector<float> sz_;
+};
+
+} // namespace rs_realtime
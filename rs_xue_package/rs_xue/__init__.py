@@ -36,6 +36,44 @@ if so_files:
         convert_pcap = rs_xue_module.convert_pcap
     if hasattr(rs_xue_module, 'convert_pcap_with_calib'):
         convert_pcap_with_calib = rs_xue_module.convert_pcap_with_calib
+    if hasattr(rs_xue_module, 'ConvertOptions'):
+        ConvertOptions = rs_xue_module.ConvertOptions
+    if hasattr(rs_xue_module, 'BevRasterizer'):
+        BevRasterizer = rs_xue_module.BevRasterizer
+    if hasattr(rs_xue_module, 'OutlierFilterConfig'):
+        OutlierFilterConfig = rs_xue_module.OutlierFilterConfig
+        OutlierMethod = rs_xue_module.OutlierMethod
+    if hasattr(rs_xue_module, 'GroundSegmentationConfig'):
+        GroundSegmentationConfig = rs_xue_module.GroundSegmentationConfig
+    if hasattr(rs_xue_module, 'CameraProjector'):
+        CameraModel = rs_xue_module.CameraModel
+        CameraProjector = rs_xue_module.CameraProjector
+    if hasattr(rs_xue_module, 'pcap_arrow_stream'):
+        pcap_arrow_stream = rs_xue_module.pcap_arrow_stream
+    if hasattr(rs_xue_module, 'ClientStats'):
+        ClientStats = rs_xue_module.ClientStats
+    if hasattr(rs_xue_module, 'FramePoolConfig'):
+        FramePoolConfig = rs_xue_module.FramePoolConfig
+        HugePageMode = rs_xue_module.HugePageMode
+    if hasattr(rs_xue_module, 'ClusteringConfig'):
+        ClusteringConfig = rs_xue_module.ClusteringConfig
+        EuclideanClusterer = rs_xue_module.EuclideanClusterer
+    if hasattr(rs_xue_module, 'AccumulatorConfig'):
+        AccumulatorConfig = rs_xue_module.AccumulatorConfig
+    if hasattr(rs_xue_module, 'NormalEstimationConfig'):
+        NormalEstimationConfig = rs_xue_module.NormalEstimationConfig
+        NormalEstimator = rs_xue_module.NormalEstimator
+    if hasattr(rs_xue_module, 'OutputDType'):
+        OutputDType = rs_xue_module.OutputDType
+        to_float32 = rs_xue_module.to_float32
+    if hasattr(rs_xue_module, 'ChangeDetectionConfig'):
+        ChangeDetectionConfig = rs_xue_module.ChangeDetectionConfig
+        ChangeDetector = rs_xue_module.ChangeDetector
+        ChangeLabel = rs_xue_module.ChangeLabel
+    if hasattr(rs_xue_module, 'NpyWriterConfig'):
+        NpyWriterConfig = rs_xue_module.NpyWriterConfig
+        WriterBackend = rs_xue_module.WriterBackend
+        Durability = rs_xue_module.Durability
         
     __all__ = ['Client']
     
@@ -48,6 +86,34 @@ if so_files:
         __all__.append('convert_pcap')
     if 'convert_pcap_with_calib' in locals():
         __all__.append('convert_pcap_with_calib')
+    if 'ConvertOptions' in locals():
+        __all__.append('ConvertOptions')
+    if 'BevRasterizer' in locals():
+        __all__.append('BevRasterizer')
+    if 'OutlierFilterConfig' in locals():
+        __all__.extend(['OutlierFilterConfig', 'OutlierMethod'])
+    if 'GroundSegmentationConfig' in locals():
+        __all__.append('GroundSegmentationConfig')
+    if 'CameraProjector' in locals():
+        __all__.extend(['CameraModel', 'CameraProjector'])
+    if 'pcap_arrow_stream' in locals():
+        __all__.append('pcap_arrow_stream')
+    if 'ClientStats' in locals():
+        __all__.append('ClientStats')
+    if 'FramePoolConfig' in locals():
+        __all__.extend(['FramePoolConfig', 'HugePageMode'])
+    if 'ClusteringConfig' in locals():
+        __all__.extend(['ClusteringConfig', 'EuclideanClusterer'])
+    if 'AccumulatorConfig' in locals():
+        __all__.append('AccumulatorConfig')
+    if 'NormalEstimationConfig' in locals():
+        __all__.extend(['NormalEstimationConfig', 'NormalEstimator'])
+    if 'OutputDType' in locals():
+        __all__.extend(['OutputDType', 'to_float32'])
+    if 'ChangeDetectionConfig' in locals():
+        __all__.extend(['ChangeDetectionConfig', 'ChangeDetector', 'ChangeLabel'])
+    if 'NpyWriterConfig' in locals():
+        __all__.extend(['NpyWriterConfig', 'WriterBackend', 'Durability'])
 else:
     raise ImportError("No compiled .so file found in the package")
 
@@ -0,0 +1,186 @@
+// 帧间变化检测基准测试：在合成的连续帧上测量每帧耗时，以及动态点与静态点的标记情况
+//
+// 用法: bench_change_detection [frames] [voxel_size] [history_frames]
+// 传感器以 10 m/s 沿x轴行驶（每帧1米，带轻微转向），场景由地面网格、道路两侧的墙和
+// 16辆以 4~12 m/s 行驶的车辆（长方体表面）组成；每帧取传感器40米范围内的点变换到传感器系，
+// 再按真值位姿做自车运动补偿后比较。统计动态点被标为变化（NEW/VANISHED）的比例与静态点的误报率。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "change_detector.h"
+#include "thread_pool.h"
+
+using namespace rs_realtime;
+
+namespace {
+
+constexpr float kRange = 40.f;
+constexpr size_t kNumCars = 16;
+
+struct Scene {
+    std::vector<float> x, y, z;     // 静态点（世界系）
+    std::vector<float> car_x, car_y, car_z;  // 车辆表面点（相对车辆原点）
+    std::vector<float> car_start, car_lane, car_speed;
+};
+
+Scene makeScene() {
+    Scene s;
+    // 地面：0.25米网格
+    for (float gx = -50.f; gx <= 200.f; gx += 0.25f) {
+        for (float gy = -20.f; gy <= 20.f; gy += 0.25f) {
+            s.x.push_back(gx);
+            s.y.push_back(gy);
+            s.z.push_back(-1.8f);
+        }
+    }
+    // 道路两侧的墙：0.1米网格
+    for (float gx = -50.f; gx <= 200.f; gx += 0.1f) {
+        for (float gz = -1.8f; gz <= 1.2f; gz += 0.1f) {
+            for (float side : {-20.f, 20.f}) {
+                s.x.push_back(gx);
+                s.y.push_back(side);
+                s.z.push_back(gz);
+            }
+        }
+    }
+    // 车辆：4 x 1.8 x 1.5 米的长方体表面（不含底面），0.1米网格
+    for (float u = 0.f; u <= 4.f; u += 0.1f) {
+        for (float v = 0.f; v <= 1.5f; v += 0.1f) {
+            for (float side : {0.f, 1.8f}) {
+                s.car_x.push_back(u);
+                s.car_y.push_back(side);
+                s.car_z.push_back(-1.7f + v);
+            }
+        }
+        for (float w = 0.f; w <= 1.8f; w += 0.1f) {
+            s.car_x.push_back(u);
+            s.car_y.push_back(w);
+            s.car_z.push_back(-0.2f);
+        }
+    }
+    for (float w = 0.f; w <= 1.8f; w += 0.1f) {
+        for (float v = 0.f; v <= 1.5f; v += 0.1f) {
+            for (float end : {0.f, 4.f}) {
+                s.car_x.push_back(end);
+                s.car_y.push_back(w);
+                s.car_z.push_back(-1.7f + v);
+            }
+        }
+    }
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    for (size_t c = 0; c < kNumCars; ++c) {
+        s.car_start.push_back(-20.f + 10.f * static_cast<float>(c));
+        s.car_lane.push_back(-15.f + 4.f * static_cast<float>(c % 8));
+        s.car_speed.push_back(4.f + 8.f * unit(rng));
+    }
+    return s;
+}
+
+/**
+ * @brief 生成第 k 帧：传感器系坐标、真值动态标记与传感器位姿
+ */
+void makeFrame(const Scene& s, int k, std::mt19937& rng, std::vector<float>& x, std::vector<float>& y,
+               std::vector<float>& z, std::vector<uint8_t>& dynamic, RigidTransform& world_from_sensor) {
+    std::normal_distribution<float> jitter(0.f, 0.01f);
+    const float t = 0.1f * static_cast<float>(k);
+    const float yaw = 0.05f * std::sin(t);
+    const float c = std::cos(yaw);
+    const float sn = std::sin(yaw);
+    world_from_sensor.R = {c, -sn, 0.f, sn, c, 0.f, 0.f, 0.f, 1.f};
+    world_from_sensor.t = {10.f * t, std::sin(0.5f * t), 0.f};
+    const RigidTransform sensor_from_world = world_from_sensor.inverse();
+    const float ox = world_from_sensor.t[0];
+    const float oy = world_from_sensor.t[1];
+
+    x.clear();
+    y.clear();
+    z.clear();
+    dynamic.clear();
+    auto emit = [&](float wx, float wy, float wz, uint8_t is_dynamic) {
+        const float dx = wx - ox;
+        const float dy = wy - oy;
+        if (dx * dx + dy * dy > kRange * kRange) {
+            return;
+        }
+        x.push_back(wx + jitter(rng));
+        y.push_back(wy + jitter(rng));
+        z.push_back(wz + jitter(rng));
+        dynamic.push_back(is_dynamic);
+    };
+    for (size_t i = 0; i < s.x.size(); ++i) {
+        emit(s.x[i], s.y[i], s.z[i], 0);
+    }
+    for (size_t car = 0; car < kNumCars; ++car) {
+        const float cx = s.car_start[car] + s.car_speed[car] * t;
+        for (size_t i = 0; i < s.car_x.size(); ++i) {
+            emit(cx + s.car_x[i], s.car_lane[car] + s.car_y[i], s.car_z[i], 1);
+        }
+    }
+    transformPoints(sensor_from_world, x.data(), y.data(), z.data(), x.size());
+}
+
+void run(ThreadPool& pool, const Scene& scene, int frames, float voxel_size, uint32_t history) {
+    ChangeDetectionConfig config;
+    config.enabled = true;
+    config.voxel_size = voxel_size;
+    config.history_frames = history;
+    ChangeDetector detector(pool);
+    detector.setConfig(config);
+
+    std::mt19937 rng(7);
+    std::vector<float> x, y, z;
+    std::vector<uint8_t> dynamic, labels;
+    RigidTransform world_from_sensor;
+    std::vector<double> times;
+    size_t dynamic_total = 0, dynamic_changed = 0, static_total = 0, static_changed = 0, points = 0;
+    for (int k = 0; k < frames; ++k) {
+        makeFrame(scene, k, rng, x, y, z, dynamic, world_from_sensor);
+        labels.resize(x.size());
+        const auto t0 = std::chrono::steady_clock::now();
+        detector.detect(x.data(), y.data(), z.data(), x.size(), 1, world_from_sensor, nullptr, labels.data());
+        const auto t1 = std::chrono::steady_clock::now();
+        if (k == 0) {  // 第一帧没有历史
+            continue;
+        }
+        times.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        points += x.size();
+        for (size_t i = 0; i < x.size(); ++i) {
+            const bool changed = labels[i] == static_cast<uint8_t>(ChangeLabel::NEW) ||
+                                 labels[i] == static_cast<uint8_t>(ChangeLabel::VANISHED);
+            if (dynamic[i]) {
+                ++dynamic_total;
+                dynamic_changed += changed;
+            } else {
+                ++static_total;
+                static_changed += changed;
+            }
+        }
+    }
+    std::sort(times.begin(), times.end());
+    std::printf("threads=%-3zu points/frame=%zu median=%7.2f ms  min=%7.2f ms  "
+                "dynamic flagged=%.1f%%  static flagged=%.2f%%\n",
+                pool.size(), points / times.size(), times[times.size() / 2], times.front(),
+                100.0 * static_cast<double>(dynamic_changed) / static_cast<double>(std::max<size_t>(dynamic_total, 1)),
+                100.0 * static_cast<double>(static_changed) / static_cast<double>(std::max<size_t>(static_total, 1)));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int frames = std::max(argc > 1 ? std::atoi(argv[1]) : 50, 2);
+    const float voxel_size = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 0.2f;
+    const uint32_t history = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 1;
+
+    const Scene scene = makeScene();
+    ThreadPool single(1);
+    run(single, scene, frames, voxel_size, history);
+    run(ThreadPool::global(), scene, frames, voxel_size, history);
+    return 0;
+}
@@ -0,0 +1,119 @@
+// 欧氏聚类基准测试：在合成的整帧点云上测量耗时与簇数
+//
+// 用法: bench_clustering [num_points] [iterations] [tolerance]
+// 合成场景由地面、四面墙、按网格摆放的立方体障碍物、细杆和稀疏噪点组成；
+// 分别测量含地面（整块地面连成一个大簇，最坏情况）与已去除地面两种输入。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "euclidean_clusterer.h"
+#include "thread_pool.h"
+
+using namespace rs_realtime;
+
+namespace {
+
+void makeFrame(size_t n, std::vector<float>& x, std::vector<float>& y, std::vector<float>& z,
+               std::vector<uint8_t>& ground) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::normal_distribution<float> jitter(0.f, 0.02f);
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    ground.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        const int kind = static_cast<int>(i % 20);
+        if (kind < 10) {
+            // 地面：按距离衰减的环状采样
+            const float range = 2.f + 60.f * unit(rng) * unit(rng);
+            const float angle = unit(rng) * 6.2831853f;
+            x[i] = range * std::cos(angle);
+            y[i] = range * std::sin(angle);
+            z[i] = -1.8f + jitter(rng);
+            ground[i] = 1;
+        } else if (kind < 14) {
+            // 立面：四面墙
+            const int wall = static_cast<int>(unit(rng) * 4.f);
+            const float along = unit(rng) * 60.f - 30.f;
+            const float offset = 30.f + jitter(rng);
+            x[i] = (wall < 2) ? along : (wall == 2 ? offset : -offset);
+            y[i] = (wall < 2) ? (wall == 0 ? offset : -offset) : along;
+            z[i] = -1.5f + unit(rng) * 3.f;
+        } else if (kind < 19) {
+            // 障碍物：64个车辆大小的立方体表面
+            const int box = static_cast<int>(unit(rng) * 64.f);
+            const float bx = -24.f + 6.f * static_cast<float>(box % 8);
+            const float by = -24.f + 6.f * static_cast<float>(box / 8);
+            const int face = static_cast<int>(unit(rng) * 5.f);
+            const float u = unit(rng) * 4.f;
+            const float v = unit(rng) * 1.6f;
+            x[i] = bx + (face == 0 ? 0.f : face == 1 ? 4.f : u);
+            y[i] = by + (face == 2 ? 0.f : face == 3 ? 1.8f : (face < 2 ? unit(rng) * 1.8f : unit(rng) * 1.8f));
+            z[i] = -1.5f + (face == 4 ? 1.6f : v);
+        } else if (i % 40 < 39) {
+            // 细杆：100根
+            const int pole = static_cast<int>(unit(rng) * 100.f);
+            const float angle = static_cast<float>(pole) * 0.0628f;
+            x[i] = 40.f * std::cos(angle) + jitter(rng);
+            y[i] = 40.f * std::sin(angle) + jitter(rng);
+            z[i] = -1.5f + unit(rng) * 4.f;
+        } else {
+            // 噪点
+            x[i] = unit(rng) * 120.f - 60.f;
+            y[i] = unit(rng) * 120.f - 60.f;
+            z[i] = unit(rng) * 6.f - 2.f;
+        }
+    }
+}
+
+void run(const char* name, ThreadPool& pool, float tolerance, const std::vector<float>& x,
+         const std::vector<float>& y, const std::vector<float>& z, const uint8_t* exclude, int iterations) {
+    ClusteringConfig config;
+    config.enabled = true;
+    config.tolerance = tolerance;
+    EuclideanClusterer clusterer(pool);
+    clusterer.setConfig(config);
+    std::vector<int32_t> labels(x.size());
+    FrameClusters clusters;
+    size_t num_clusters = clusterer.cluster(x.data(), y.data(), z.data(), x.size(), 1, exclude, labels.data(), clusters);  // 预热
+    std::vector<double> times;
+    for (int i = 0; i < iterations; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        num_clusters = clusterer.cluster(x.data(), y.data(), z.data(), x.size(), 1, exclude, labels.data(), clusters);
+        const auto t1 = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    std::sort(times.begin(), times.end());
+    size_t noise = 0;
+    for (int32_t label : labels) {
+        noise += label < 0;
+    }
+    std::printf("%-14s threads=%-3zu median=%8.2f ms  min=%8.2f ms  clusters=%zu unlabelled=%zu/%zu\n",
+                name, pool.size(), times[times.size() / 2], times.front(), num_clusters, noise, x.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t num_points = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 260000;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+    const float tolerance = argc > 3 ? static_cast<float>(std::atof(argv[3])) : 0.5f;
+
+    std::vector<float> x, y, z;
+    std::vector<uint8_t> ground;
+    makeFrame(num_points, x, y, z, ground);
+
+    ThreadPool single(1);
+    run("with ground", single, tolerance, x, y, z, nullptr, iterations);
+    run("with ground", ThreadPool::global(), tolerance, x, y, z, nullptr, iterations);
+    run("ground removed", single, tolerance, x, y, z, ground.data(), iterations);
+    run("ground removed", ThreadPool::global(), tolerance, x, y, z, ground.data(), iterations);
+    return 0;
+}
@@ -0,0 +1,114 @@
+// 地面分割基准测试：在合成的整帧点云上测量耗时与标签准确率
+//
+// 用法: bench_ground_segmentation [num_points] [iterations]
+// 合成场景由带缓坡的地面、四面墙和若干立方体障碍物组成，已知每个点的真实标签。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "ground_segmenter.h"
+#include "thread_pool.h"
+
+using namespace rs_realtime;
+
+namespace {
+
+// 地面高度：沿x方向约3%的缓坡
+float groundHeight(float x, float) {
+    return -1.8f + 0.03f * x;
+}
+
+void makeFrame(size_t n, std::vector<float>& x, std::vector<float>& y, std::vector<float>& z,
+               std::vector<uint8_t>& truth) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::normal_distribution<float> jitter(0.f, 0.03f);
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    truth.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const int kind = static_cast<int>(i % 10);
+        if (kind < 6) {
+            // 地面：按距离衰减的环状采样
+            const float range = 2.f + 60.f * unit(rng) * unit(rng);
+            const float angle = unit(rng) * 6.2831853f;
+            x[i] = range * std::cos(angle);
+            y[i] = range * std::sin(angle);
+            z[i] = groundHeight(x[i], y[i]) + jitter(rng);
+            truth[i] = 1;
+        } else if (kind < 8) {
+            // 立面：四面墙
+            const int wall = static_cast<int>(unit(rng) * 4.f);
+            const float along = unit(rng) * 40.f - 20.f;
+            const float offset = 20.f + jitter(rng);
+            x[i] = (wall < 2) ? along : (wall == 2 ? offset : -offset);
+            y[i] = (wall < 2) ? (wall == 0 ? offset : -offset) : along;
+            z[i] = groundHeight(x[i], y[i]) + 0.3f + unit(rng) * 3.f;
+            truth[i] = 0;
+        } else {
+            // 障碍物：16个边长1.5米的立方体表面
+            const int box = static_cast<int>(unit(rng) * 16.f);
+            const float bx = -12.f + 8.f * static_cast<float>(box % 4);
+            const float by = -12.f + 8.f * static_cast<float>(box / 4);
+            const int face = static_cast<int>(unit(rng) * 5.f);
+            const float u = unit(rng) * 1.5f;
+            const float v = unit(rng) * 1.5f;
+            x[i] = bx + (face == 0 ? 0.f : face == 1 ? 1.5f : u);
+            y[i] = by + (face == 2 ? 0.f : face == 3 ? 1.5f : (face < 2 ? u : v));
+            const float base = groundHeight(bx, by) + 0.3f;
+            z[i] = base + (face == 4 ? 1.5f : v);
+            truth[i] = 0;
+        }
+    }
+}
+
+void run(const char* name, ThreadPool& pool, const std::vector<float>& x, const std::vector<float>& y,
+         const std::vector<float>& z, const std::vector<uint8_t>& truth, int iterations) {
+    GroundSegmentationConfig config;
+    config.enabled = true;
+    GroundSegmenter segmenter(pool);
+    segmenter.setConfig(config);
+    std::vector<uint8_t> ground(x.size());
+    std::vector<double> times;
+    segmenter.computeLabels(x.data(), y.data(), z.data(), x.size(), 1, ground.data());  // 预热，分配内部缓冲
+    for (int i = 0; i < iterations; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        segmenter.computeLabels(x.data(), y.data(), z.data(), x.size(), 1, ground.data());
+        const auto t1 = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    std::sort(times.begin(), times.end());
+
+    size_t tp = 0, fp = 0, fn = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        tp += ground[i] && truth[i];
+        fp += ground[i] && !truth[i];
+        fn += !ground[i] && truth[i];
+    }
+    std::printf("%-8s threads=%-3zu median=%7.2f ms  min=%7.2f ms  precision=%.4f recall=%.4f\n",
+                name, pool.size(), times[times.size() / 2], times.front(),
+                static_cast<double>(tp) / static_cast<double>(std::max<size_t>(1, tp + fp)),
+                static_cast<double>(tp) / static_cast<double>(std::max<size_t>(1, tp + fn)));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t num_points = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::vector<float> x, y, z;
+    std::vector<uint8_t> truth;
+    makeFrame(num_points, x, y, z, truth);
+
+    ThreadPool single(1);
+    run("ground", single, x, y, z, truth, iterations);
+    run("ground", ThreadPool::global(), x, y, z, truth, iterations);
+    return 0;
+}
@@ -0,0 +1,125 @@
+// 法向估计基准测试：在合成的有序帧上比较扫描顺序邻域、体素邻域与稠密区域近似（dense_neighbors）的耗时和精度
+//
+// 用法: bench_normals [rows] [cols] [iterations] [radius]
+// 模拟按列输出的机械式雷达：rows 线、每圈 cols 列，射线打在地面（z = -1.8）
+// 或半径25米的圆柱墙面上，约5%的回波缺失（NaN）。真值法向已知，输出平均角度误差。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "normal_estimator.h"
+#include "thread_pool.h"
+
+using namespace rs_realtime;
+
+namespace {
+
+struct Frame {
+    std::vector<float> x, y, z;
+    std::vector<float> nx, ny, nz;  // 真值法向（朝向传感器）
+};
+
+Frame makeFrame(uint32_t rows, uint32_t cols) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::normal_distribution<float> jitter(0.f, 0.01f);
+    const size_t n = static_cast<size_t>(rows) * cols;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    Frame f;
+    f.x.resize(n);
+    f.y.resize(n);
+    f.z.resize(n);
+    f.nx.assign(n, 0.f);
+    f.ny.assign(n, 0.f);
+    f.nz.assign(n, 0.f);
+    for (uint32_t c = 0; c < cols; ++c) {
+        const float azimuth = 6.2831853f * static_cast<float>(c) / static_cast<float>(cols);
+        for (uint32_t r = 0; r < rows; ++r) {
+            const size_t i = static_cast<size_t>(c) * rows + r;
+            // 俯仰角 -25° ~ +15° 均匀分布
+            const float elevation = (-25.f + 40.f * static_cast<float>(r) / static_cast<float>(rows - 1)) * 0.0174533f;
+            const float ground_range = elevation < 0.f ? 1.8f / std::tan(-elevation) : 1e9f;
+            const bool hits_ground = ground_range < 25.f;
+            const float range = (hits_ground ? ground_range : 25.f) + jitter(rng);
+            const float dir_x = std::cos(azimuth);
+            const float dir_y = std::sin(azimuth);
+            if (unit(rng) < 0.05f) {
+                f.x[i] = f.y[i] = f.z[i] = nan;
+                continue;
+            }
+            f.x[i] = range * dir_x;
+            f.y[i] = range * dir_y;
+            f.z[i] = hits_ground ? -1.8f + jitter(rng) : range * std::tan(elevation);
+            if (hits_ground) {
+                f.nz[i] = 1.f;
+            } else {
+                f.nx[i] = -dir_x;
+                f.ny[i] = -dir_y;
+            }
+        }
+    }
+    return f;
+}
+
+void run(const char* name, ThreadPool& pool, const NormalEstimationConfig& config, const Frame& f, int iterations) {
+    NormalEstimator estimator(pool);
+    estimator.setConfig(config);
+    const size_t n = f.x.size();
+    std::vector<float> nx(n), ny(n), nz(n), curvature(n);
+    size_t valid = 0;
+    std::vector<double> times;
+    for (int i = 0; i <= iterations; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        valid = estimator.estimate(f.x.data(), f.y.data(), f.z.data(), n, 1, nullptr, nullptr,
+                                   nx.data(), ny.data(), nz.data(), 1, curvature.data());
+        const auto t1 = std::chrono::steady_clock::now();
+        if (i > 0) {  // 第一次为预热
+            times.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        }
+    }
+    std::sort(times.begin(), times.end());
+    double error_deg = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        if (std::isfinite(nx[i])) {
+            const double dot = nx[i] * f.nx[i] + ny[i] * f.ny[i] + nz[i] * f.nz[i];
+            error_deg += std::acos(std::max(-1.0, std::min(1.0, dot))) * 57.2957795;
+        }
+    }
+    std::printf("%-10s threads=%-3zu median=%8.2f ms  min=%8.2f ms  valid=%zu/%zu  mean error=%.2f deg\n",
+                name, pool.size(), times[times.size() / 2], times.front(), valid, n,
+                valid ? error_deg / static_cast<double>(valid) : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const uint32_t rows = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 128;
+    const uint32_t cols = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 2048;
+    const int iterations = argc > 3 ? std::atoi(argv[3]) : 20;
+    const float radius = argc > 4 ? static_cast<float>(std::atof(argv[4])) : 0.5f;
+
+    const Frame frame = makeFrame(rows, cols);
+
+    NormalEstimationConfig organized;
+    organized.radius = radius;
+    organized.scan_rows = rows;
+    NormalEstimationConfig voxel = organized;
+    voxel.scan_rows = 0;
+    NormalEstimationConfig approx = voxel;
+    approx.dense_neighbors = 256;
+
+    ThreadPool single(1);
+    run("organized", single, organized, frame, iterations);
+    run("organized", ThreadPool::global(), organized, frame, iterations);
+    run("voxel", single, voxel, frame, iterations);
+    run("voxel", ThreadPool::global(), voxel, frame, iterations);
+    run("approx", single, approx, frame, iterations);
+    run("approx", ThreadPool::global(), approx, frame, iterations);
+    return 0;
+}
@@ -0,0 +1,131 @@
+// npy写入基准测试：比较 cnpy::npy_save（转换器原来的 saveNpy 路径）与 NpyWriter 各后端的文件数/秒与吞吐
+//
+// 用法: bench_npy_writer [frames] [points] [output_dir]
+// 每帧写4个文件，与开启地面分割、聚类与变化检测时的转换输出相同：
+// 坐标 (N, 3) float32、地面标签 uint8、聚类标签 int32、变化标签 uint8。
+// 每种写法写到 output_dir 下单独的子目录，计时包含最后等待全部写完（及刷盘），测完删除。
+// 输出目录应放在要测的磁盘上；页缓存充足时普通写主要测到的是拷贝进页缓存的开销。
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cnpy.h"
+#include "npy_writer.h"
+
+using namespace rs_realtime;
+
+namespace {
+
+struct Frame {
+    std::vector<float> points;
+    std::vector<uint8_t> ground;
+    std::vector<int32_t> cluster;
+    std::vector<uint8_t> change;
+};
+
+std::string framePath(const std::string& dir, int k) {
+    std::ostringstream oss;
+    oss << dir << "/cloud_" << std::setw(6) << std::setfill('0') << k;
+    return oss.str();
+}
+
+template <typename Fn>
+void run(const char* name, const std::string& root, Fn&& writeAll) {
+    const std::string dir = root + "/" + name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const auto t0 = std::chrono::steady_clock::now();
+    writeAll(dir);
+    const auto t1 = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+    uintmax_t bytes = 0;
+    size_t files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        bytes += entry.file_size();
+        ++files;
+    }
+    std::printf("%-28s %8.0f files/s  %8.1f MB/s  (%zu files, %.1f MB, %.3f s)\n", name,
+                static_cast<double>(files) / seconds, static_cast<double>(bytes) / 1e6 / seconds, files,
+                static_cast<double>(bytes) / 1e6, seconds);
+    std::filesystem::remove_all(dir);
+}
+
+void runWriter(const char* name, const std::string& root, int frames, const Frame& frame,
+               const NpyWriterConfig& config) {
+    run(name, root, [&](const std::string& dir) {
+        NpyWriter writer(config);
+        const size_t n = frame.ground.size();
+        for (int k = 0; k < frames; ++k) {
+            const std::string base = framePath(dir, k);
+            writer.write(base + ".npy", frame.points.data(), {n, 3});
+            writer.write(base + "_ground.npy", frame.ground.data(), {n});
+            writer.write(base + "_cluster.npy", frame.cluster.data(), {n});
+            writer.write(base + "_change.npy", frame.change.data(), {n});
+            writer.endFrame();
+        }
+        writer.flush();
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int frames = std::max(argc > 1 ? std::atoi(argv[1]) : 200, 1);
+    const size_t n = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    const std::string root = argc > 3 ? argv[3] : "bench_npy_writer_out";
+
+    Frame frame;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coord(-100.f, 100.f);
+    frame.points.resize(n * 3);
+    for (float& v : frame.points) {
+        v = coord(rng);
+    }
+    frame.ground.assign(n, 1);
+    frame.cluster.assign(n, -1);
+    frame.change.assign(n, 0);
+
+    std::printf("frames=%d points=%zu output=%s\n", frames, n, root.c_str());
+    run("saveNpy (cnpy)", root, [&](const std::string& dir) {
+        for (int k = 0; k < frames; ++k) {
+            const std::string base = framePath(dir, k);
+            cnpy::npy_save(base + ".npy", frame.points.data(), {n, 3}, "w");
+            cnpy::npy_save(base + "_ground.npy", frame.ground.data(), {n}, "w");
+            cnpy::npy_save(base + "_cluster.npy", frame.cluster.data(), {n}, "w");
+            cnpy::npy_save(base + "_change.npy", frame.change.data(), {n}, "w");
+        }
+    });
+
+    NpyWriterConfig config;
+    config.backend = WriterBackend::SYNC;
+    runWriter("SYNC", root, frames, frame, config);
+    config.backend = WriterBackend::THREADS;
+    runWriter("THREADS", root, frames, frame, config);
+    config.backend = WriterBackend::IO_URING;
+    {
+        NpyWriter probe(config);
+        if (probe.backend() != WriterBackend::IO_URING) {
+            std::printf("io_uring unavailable, IO_URING rows use the thread pool\n");
+        }
+    }
+    runWriter("IO_URING", root, frames, frame, config);
+    config.direct_io = true;
+    runWriter("IO_URING direct", root, frames, frame, config);
+    config.durability = Durability::EVERY_N_FRAMES;
+    config.sync_every = 50;
+    runWriter("IO_URING direct sync/50", root, frames, frame, config);
+    config.durability = Durability::END;
+    runWriter("IO_URING direct sync end", root, frames, frame, config);
+    config.direct_io = false;
+    runWriter("IO_URING sync end", root, frames, frame, config);
+    return 0;
+}
@@ -0,0 +1,105 @@
+// 离群点过滤基准测试：在合成的整帧点云上测量半径/统计过滤的耗时
+//
+// 用法: bench_outlier_filter [num_points] [iterations]
+// 合成场景由地面、若干立面和均匀分布的噪点（模拟雨雾回波）组成。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "outlier_filter.h"
+#include "thread_pool.h"
+
+using namespace rs_realtime;
+
+namespace {
+
+void makeFrame(size_t n, std::vector<float>& x, std::vector<float>& y, std::vector<float>& z) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::normal_distribution<float> jitter(0.f, 0.02f);
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    const size_t num_noise = n / 50;
+    for (size_t i = 0; i < n; ++i) {
+        if (i < num_noise) {
+            // 噪点：稀疏分布在整个视场内
+            x[i] = unit(rng) * 120.f - 60.f;
+            y[i] = unit(rng) * 120.f - 60.f;
+            z[i] = unit(rng) * 6.f - 2.f;
+        } else if (i % 4 != 0) {
+            // 地面：按距离衰减的环状采样
+            const float range = 2.f + 60.f * unit(rng) * unit(rng);
+            const float angle = unit(rng) * 6.2831853f;
+            x[i] = range * std::cos(angle);
+            y[i] = range * std::sin(angle);
+            z[i] = -1.8f + jitter(rng);
+        } else {
+            // 立面：四面墙
+            const int wall = static_cast<int>(unit(rng) * 4.f);
+            const float along = unit(rng) * 40.f - 20.f;
+            const float offset = 20.f + jitter(rng);
+            x[i] = (wall < 2) ? along : (wall == 2 ? offset : -offset);
+            y[i] = (wall < 2) ? (wall == 0 ? offset : -offset) : along;
+            z[i] = unit(rng) * 4.f - 1.8f;
+        }
+    }
+}
+
+double benchOnce(OutlierFilter& filter, const std::vector<float>& x, const std::vector<float>& y,
+                 const std::vector<float>& z, std::vector<uint8_t>& keep, size_t& inliers) {
+    const auto t0 = std::chrono::steady_clock::now();
+    inliers = filter.computeMask(x.data(), y.data(), z.data(), x.size(), 1, keep.data());
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+void run(const char* name, const OutlierFilterConfig& config, ThreadPool& pool,
+         const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z, int iterations) {
+    OutlierFilter filter(pool);
+    filter.setConfig(config);
+    std::vector<uint8_t> keep(x.size());
+    std::vector<double> times;
+    size_t inliers = 0;
+    benchOnce(filter, x, y, z, keep, inliers);  // 预热，分配内部缓冲
+    for (int i = 0; i < iterations; ++i) {
+        times.push_back(benchOnce(filter, x, y, z, keep, inliers));
+    }
+    std::sort(times.begin(), times.end());
+    std::printf("%-12s threads=%-3zu median=%8.2f ms  min=%8.2f ms  inliers=%zu/%zu\n",
+                name, pool.size(), times[times.size() / 2], times.front(), inliers, x.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t num_points = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::vector<float> x, y, z;
+    makeFrame(num_points, x, y, z);
+
+    OutlierFilterConfig radius;
+    radius.method = OutlierMethod::RADIUS;
+    radius.radius = 0.5f;
+    radius.min_neighbors = 3;
+
+    OutlierFilterConfig statistical;
+    statistical.method = OutlierMethod::STATISTICAL;
+    statistical.k = 8;
+    statistical.std_ratio = 1.0f;
+    statistical.search_radius = 1.0f;
+
+    ThreadPool single(1);
+    ThreadPool& all = ThreadPool::global();
+    run("radius", radius, single, x, y, z, iterations);
+    run("radius", radius, all, x, y, z, iterations);
+    run("statistical", statistical, single, x, y, z, iterations);
+    run("statistical", statistical, all, x, y, z, iterations);
+    return 0;
+}
@@ -0,0 +1,85 @@
+// 降精度输出基准测试：SoA坐标交错为 (N, 3) 输出的耗时，比较float32、逐点转换与向量化的半精度/bfloat16
+//
+// 用法: bench_reduced_precision [num_points] [iterations]
+// 坐标取 ±100 米内的随机值，同时报告往返后的最大绝对误差。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "reduced_precision.h"
+
+using namespace rs_realtime;
+
+namespace {
+
+template <typename Fn>
+double medianMs(int iterations, Fn&& fn) {
+    fn();  // 预热
+    std::vector<double> times;
+    for (int i = 0; i < iterations; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        fn();
+        const auto t1 = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 260000;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 50;
+
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> coord(-100.f, 100.f);
+    std::vector<float> x(n), y(n), z(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = coord(rng);
+        y[i] = coord(rng);
+        z[i] = coord(rng) * 0.05f;
+    }
+    std::vector<float> out32(n * 3);
+    std::vector<uint16_t> out16(n * 3);
+
+    const double t32 = medianMs(iterations, [&] {
+        packPoints(x.data(), y.data(), z.data(), n, OutputDType::FLOAT32, out32.data());
+    });
+    const double t_scalar = medianMs(iterations, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            out16[i * 3 + 0] = floatToHalf(x[i]);
+            out16[i * 3 + 1] = floatToHalf(y[i]);
+            out16[i * 3 + 2] = floatToHalf(z[i]);
+        }
+    });
+    const double t16 = medianMs(iterations, [&] {
+        packPoints(x.data(), y.data(), z.data(), n, OutputDType::FLOAT16, out16.data());
+    });
+    std::vector<float> back(n * 3);
+    unpackValues(out16.data(), n * 3, OutputDType::FLOAT16, back.data());
+    float error16 = 0.f;
+    for (size_t i = 0; i < n; ++i) {
+        error16 = std::max(error16, std::fabs(back[i * 3] - x[i]));
+    }
+    const double tbf = medianMs(iterations, [&] {
+        packPoints(x.data(), y.data(), z.data(), n, OutputDType::BFLOAT16, out16.data());
+    });
+    unpackValues(out16.data(), n * 3, OutputDType::BFLOAT16, back.data());
+    float error_bf = 0.f;
+    for (size_t i = 0; i < n; ++i) {
+        error_bf = std::max(error_bf, std::fabs(back[i * 3] - x[i]));
+    }
+
+    std::printf("points=%zu\n", n);
+    std::printf("float32 interleave      %7.3f ms  %6.2f MB\n", t32, n * 12 / 1e6);
+    std::printf("float16 per-point       %7.3f ms  %6.2f MB\n", t_scalar, n * 6 / 1e6);
+    std::printf("float16 packPoints      %7.3f ms  %6.2f MB  max error %.4f m\n", t16, n * 6 / 1e6, error16);
+    std::printf("bfloat16 packPoints     %7.3f ms  %6.2f MB  max error %.4f m\n", tbf, n * 6 / 1e6, error_bf);
+    return 0;
+}
@@ -0,0 +1,410 @@
+// PCAP UDP回放工具：把抓包中的 MSOP/DIFOP 报文重新发往指定地址，
+// 按原始节奏、N倍速或尽快发送，配合 tools/soak_replay.py 对实时客户端做长时间压测
+//
+// 用法: pcap_replay <file.pcap> [--host 127.0.0.1] [--msop-port 6699] [--difop-port 7788]
+//                   [--src-msop-port 6699] [--src-difop-port 7788]
+//                   [--speed 1.0] [--loops 1] [--batch 64] [--sndbuf 8388608]
+//
+// --speed 0 表示不做节奏控制、尽快发送；--loops 0 表示无限循环，直到收到 SIGINT/SIGTERM。
+// 结束时在标准输出打印一行JSON统计（报文数、字节数、耗时、吞吐与最大发送滞后）。
+// 只支持经典pcap格式（微秒/纳秒时间戳、两种字节序），链路层支持以太网（含VLAN）、
+// Linux cooked（SLL/SLL2）、原始IP与BSD loopback；IP分片报文会被跳过。
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void onSignal(int) {
+    g_stop = 1;
+}
+
+enum PacketKind : uint8_t { MSOP = 0, DIFOP = 1 };
+
+struct Packet {
+    const uint8_t* payload;
+    uint32_t length;
+    uint64_t ts_ns;         // 抓包时间戳
+    PacketKind kind;
+};
+
+struct Options {
+    std::string file;
+    std::string host = "127.0.0.1";
+    uint16_t msop_port = 6699;
+    uint16_t difop_port = 7788;
+    uint16_t src_msop_port = 6699;
+    uint16_t src_difop_port = 7788;
+    double speed = 1.0;
+    long loops = 1;
+    size_t batch = 64;
+    int sndbuf = 8 << 20;
+};
+
+struct ParseStats {
+    size_t records = 0;
+    size_t fragments = 0;   // 跳过的IP分片
+    size_t other = 0;       // 非目标端口或无法解析的报文
+};
+
+uint16_t readBe16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t readU32(const uint8_t* p, bool swapped) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return swapped ? __builtin_bswap32(v) : v;
+}
+
+// 解析到IP层：返回IP头偏移，无法识别的链路层返回-1
+long linkHeaderLength(uint32_t linktype, const uint8_t* frame, size_t caplen, uint16_t& ethertype) {
+    switch (linktype) {
+    case 1: {   // 以太网
+        size_t offset = 12;
+        if (caplen < offset + 2) {
+            return -1;
+        }
+        ethertype = readBe16(frame + offset);
+        while ((ethertype == 0x8100 || ethertype == 0x88a8) && caplen >= offset + 6) {
+            offset += 4;
+            ethertype = readBe16(frame + offset);
+        }
+        return static_cast<long>(offset + 2);
+    }
+    case 113:   // Linux cooked v1
+        if (caplen < 16) {
+            return -1;
+        }
+        ethertype = readBe16(frame + 14);
+        return 16;
+    case 276:   // Linux cooked v2
+        if (caplen < 20) {
+            return -1;
+        }
+        ethertype = readBe16(frame);
+        return 20;
+    case 0:     // BSD loopback，4字节地址族（主机字节序）
+        if (caplen < 5) {
+            return -1;
+        }
+        ethertype = (frame[4] >> 4) == 6 ? 0x86dd : 0x0800;
+        return 4;
+    case 12:
+    case 101:   // 原始IP
+        if (caplen < 1) {
+            return -1;
+        }
+        ethertype = (frame[0] >> 4) == 6 ? 0x86dd : 0x0800;
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+// 从一条链路层帧中取出UDP负载，返回false表示跳过
+bool extractUdp(uint32_t linktype, const uint8_t* frame, size_t caplen, ParseStats& stats,
+                const uint8_t*& payload, uint32_t& length, uint16_t& dst_port) {
+    uint16_t ethertype = 0;
+    const long link = linkHeaderLength(linktype, frame, caplen, ethertype);
+    if (link < 0) {
+        return false;
+    }
+    const uint8_t* ip = frame + link;
+    size_t remaining = caplen - static_cast<size_t>(link);
+    const uint8_t* udp = nullptr;
+    if (ethertype == 0x0800) {
+        if (remaining < 20 || (ip[0] >> 4) != 4 || ip[9] != 17) {
+            return false;
+        }
+        if (readBe16(ip + 6) & 0x3fff) {    // MF位或非零片偏移
+            ++stats.fragments;
+            return false;
+        }
+        const size_t ihl = static_cast<size_t>(ip[0] & 0x0f) * 4;
+        if (ihl < 20 || remaining < ihl + 8) {
+            return false;
+        }
+        udp = ip + ihl;
+        remaining -= ihl;
+    } else if (ethertype == 0x86dd) {
+        if (remaining < 48 || ip[6] != 17) {  // 只处理无扩展头的UDP
+            return false;
+        }
+        udp = ip + 40;
+        remaining -= 40;
+    } else {
+        return false;
+    }
+    dst_port = readBe16(udp + 2);
+    const size_t udp_len = readBe16(udp + 4);
+    if (udp_len < 8) {
+        return false;
+    }
+    payload = udp + 8;
+    length = static_cast<uint32_t>(std::min(udp_len, remaining) - 8);
+    return true;
+}
+
+bool loadPcap(const Options& opt, const uint8_t* data, size_t size, std::vector<Packet>& packets, ParseStats& stats) {
+    if (size < 24) {
+        std::fprintf(stderr, "file too small for a pcap header\n");
+        return false;
+    }
+    uint32_t magic;
+    std::memcpy(&magic, data, sizeof(magic));
+    bool swapped = false;
+    bool nanos = false;
+    switch (magic) {
+    case 0xa1b2c3d4: break;
+    case 0xa1b23c4d: nanos = true; break;
+    case 0xd4c3b2a1: swapped = true; break;
+    case 0x4d3cb2a1: swapped = true; nanos = true; break;
+    default:
+        std::fprintf(stderr, "not a classic pcap file (pcapng is not supported, convert with editcap -F pcap)\n");
+        return false;
+    }
+    const uint32_t linktype = readU32(data + 20, swapped) & 0x0fffffff;
+
+    size_t offset = 24;
+    while (offset + 16 <= size) {
+        const uint8_t* rec = data + offset;
+        const uint64_t sec = readU32(rec, swapped);
+        const uint64_t frac = readU32(rec + 4, swapped);
+        const size_t caplen = readU32(rec + 8, swapped);
+        offset += 16;
+        if (offset + caplen > size) {
+            break;  // 截断的最后一条记录
+        }
+        ++stats.records;
+        const uint8_t* payload = nullptr;
+        uint32_t length = 0;
+        uint16_t dst_port = 0;
+        if (extractUdp(linktype, data + offset, caplen, stats, payload, length, dst_port)) {
+            const uint64_t ts_ns = sec * 1000000000ull + (nanos ? frac : frac * 1000ull);
+            if (dst_port == opt.src_msop_port) {
+                packets.push_back({payload, length, ts_ns, MSOP});
+            } else if (dst_port == opt.src_difop_port) {
+                packets.push_back({payload, length, ts_ns, DIFOP});
+            } else {
+                ++stats.other;
+            }
+        } else {
+            ++stats.other;
+        }
+        offset += caplen;
+    }
+    return true;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--host" && has_value) {
+            opt.host = argv[++i];
+        } else if (arg == "--msop-port" && has_value) {
+            opt.msop_port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--difop-port" && has_value) {
+            opt.difop_port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--src-msop-port" && has_value) {
+            opt.src_msop_port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--src-difop-port" && has_value) {
+            opt.src_difop_port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--speed" && has_value) {
+            opt.speed = std::atof(argv[++i]);
+        } else if (arg == "--loops" && has_value) {
+            opt.loops = std::atol(argv[++i]);
+        } else if (arg == "--batch" && has_value) {
+            opt.batch = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--sndbuf" && has_value) {
+            opt.sndbuf = std::atoi(argv[++i]);
+        } else if (!arg.empty() && arg[0] != '-' && opt.file.empty()) {
+            opt.file = arg;
+        } else {
+            return false;
+        }
+    }
+    return !opt.file.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::fprintf(stderr,
+                     "usage: %s <file.pcap> [--host 127.0.0.1] [--msop-port 6699] [--difop-port 7788]\n"
+                     "       [--src-msop-port 6699] [--src-difop-port 7788] [--speed 1.0 (0 = max)]\n"
+                     "       [--loops 1 (0 = forever)] [--batch 64] [--sndbuf 8388608]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    // 整个文件映射到内存，发送时直接引用其中的负载，回放过程中没有磁盘I/O
+    const int fd = ::open(opt.file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::perror("open");
+        return 1;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        std::fprintf(stderr, "cannot stat %s or file is empty\n", opt.file.c_str());
+        ::close(fd);
+        return 1;
+    }
+    const size_t file_size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::perror("mmap");
+        return 1;
+    }
+
+    std::vector<Packet> packets;
+    ParseStats parse_stats;
+    if (!loadPcap(opt, static_cast<const uint8_t*>(mapped), file_size, packets, parse_stats)) {
+        return 1;
+    }
+    if (packets.empty()) {
+        std::fprintf(stderr, "no MSOP/DIFOP packets found (%zu records, %zu fragments skipped)\n",
+                     parse_stats.records, parse_stats.fragments);
+        return 1;
+    }
+    std::fprintf(stderr, "loaded %zu packets from %zu records (%zu fragments, %zu other skipped)\n",
+                 packets.size(), parse_stats.records, parse_stats.fragments, parse_stats.other);
+
+    const int sock = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        std::perror("socket");
+        return 1;
+    }
+    ::setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &opt.sndbuf, sizeof(opt.sndbuf));
+
+    sockaddr_in dest[2];
+    for (int k = 0; k < 2; ++k) {
+        std::memset(&dest[k], 0, sizeof(dest[k]));
+        dest[k].sin_family = AF_INET;
+        dest[k].sin_port = htons(k == MSOP ? opt.msop_port : opt.difop_port);
+        if (::inet_pton(AF_INET, opt.host.c_str(), &dest[k].sin_addr) != 1) {
+            std::fprintf(stderr, "invalid host address %s\n", opt.host.c_str());
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::vector<mmsghdr> msgs(opt.batch);
+    std::vector<iovec> iovs(opt.batch);
+    uint64_t sent_packets = 0, sent_msop = 0, sent_difop = 0, sent_bytes = 0, send_errors = 0;
+    int64_t max_late_ns = 0;
+    const uint64_t first_ts = packets.front().ts_ns;
+    const auto start = Clock::now();
+
+    for (long loop = 0; (opt.loops == 0 || loop < opt.loops) && !g_stop; ++loop) {
+        // 每轮从头按相对时间重新排程
+        const auto loop_start = Clock::now();
+        auto dueOf = [&](size_t i) {
+            // 抓包时间戳可能回退（如时钟调整），早于第一个报文的按偏移0立即发送
+            const uint64_t ts_ns = std::max(packets[i].ts_ns, first_ts);
+            const double offset_ns = static_cast<double>(ts_ns - first_ts) / opt.speed;
+            return loop_start + std::chrono::nanoseconds(static_cast<int64_t>(offset_ns));
+        };
+
+        size_t i = 0;
+        while (i < packets.size() && !g_stop) {
+            auto now = Clock::now();
+            if (opt.speed > 0) {
+                const auto due = dueOf(i);
+                if (due > now) {
+                    std::this_thread::sleep_until(due);
+                    now = Clock::now();
+                }
+                max_late_ns = std::max<int64_t>(max_late_ns,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - due).count());
+            }
+
+            // 已到期的报文合并为一次 sendmmsg；睡眠超时造成的滞后自然并入同一批
+            size_t count = 0;
+            while (i + count < packets.size() && count < opt.batch &&
+                   (opt.speed <= 0 || dueOf(i + count) <= now)) {
+                const Packet& pkt = packets[i + count];
+                iovs[count].iov_base = const_cast<uint8_t*>(pkt.payload);
+                iovs[count].iov_len = pkt.length;
+                std::memset(&msgs[count], 0, sizeof(mmsghdr));
+                msgs[count].msg_hdr.msg_name = &dest[pkt.kind];
+                msgs[count].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                msgs[count].msg_hdr.msg_iov = &iovs[count];
+                msgs[count].msg_hdr.msg_iovlen = 1;
+                ++count;
+            }
+
+            // 只统计 sendmmsg 确认发出的报文
+            auto countSent = [&](size_t begin, size_t end) {
+                for (size_t k = begin; k < end; ++k) {
+                    const Packet& pkt = packets[i + k];
+                    sent_bytes += pkt.length;
+                    (pkt.kind == MSOP ? sent_msop : sent_difop) += 1;
+                }
+                sent_packets += end - begin;
+            };
+            size_t done = 0;
+            while (done < count) {
+                const int ret = ::sendmmsg(sock, msgs.data() + done, static_cast<unsigned int>(count - done), 0);
+                if (ret > 0) {
+                    countSent(done, done + static_cast<size_t>(ret));
+                    done += static_cast<size_t>(ret);
+                    continue;
+                }
+                if (errno == EINTR && !g_stop) {
+                    continue;
+                }
+                if ((errno == ENOBUFS || errno == EAGAIN) && !g_stop) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    continue;
+                }
+                // 其余错误（如目标端口无人监听导致的 ECONNREFUSED）跳过当前报文
+                ++send_errors;
+                ++done;
+            }
+            i += count;
+        }
+    }
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("{\"packets\": %llu, \"msop\": %llu, \"difop\": %llu, \"bytes\": %llu, \"send_errors\": %llu, "
+                "\"elapsed_s\": %.6f, \"pps\": %.1f, \"mbps\": %.3f, \"max_late_us\": %.1f, \"interrupted\": %s}\n",
+                static_cast<unsigned long long>(sent_packets), static_cast<unsigned long long>(sent_msop),
+                static_cast<unsigned long long>(sent_difop), static_cast<unsigned long long>(sent_bytes),
+                static_cast<unsigned long long>(send_errors), elapsed,
+                elapsed > 0 ? sent_packets / elapsed : 0.0,
+                elapsed > 0 ? sent_bytes * 8.0 / elapsed / 1e6 : 0.0,
+                max_late_ns / 1000.0, g_stop ? "true" : "false");
+    std::fflush(stdout);
+
+    ::close(sock);
+    ::munmap(mapped, file_size);
+    return 0;
+}
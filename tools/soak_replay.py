@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""
+实时客户端的长时间回放（soak）测试
+
+用 pcap_replay 把抓包中的 MSOP/DIFOP 报文按原始节奏（或N倍速、或尽快）发往本机，
+同时以 ONLINE_LIDAR 模式运行 rs_xue.Client 持续取帧，结束后报告：
+  - 持续帧率
+  - 丢帧（驱动组帧后未被取走的帧、帧序号跳变）与不完整帧（点数明显少于中位数，多由丢包造成）
+  - 内核UDP丢包（/proc/net/snmp 中 RcvbufErrors 的增量，整机统计）
+  - 延迟分位数：整帧到达 -> 处理完成，整帧到达 -> Python 拿到数据
+
+超过 --max-frame-loss / --max-p99-ms 等阈值时以非0退出，便于在CI中回归。
+
+用法:
+  python tools/soak_replay.py capture.pcap --replay build/pcap_replay --speed 1 --loops 20
+"""
+
+import argparse
+import json
+import statistics
+import subprocess
+import sys
+import threading
+import time
+
+import rs_xue
+
+
+def read_udp_counters():
+    """读取 /proc/net/snmp 中的UDP计数，非Linux系统返回空字典"""
+    try:
+        with open("/proc/net/snmp") as f:
+            lines = [line.split() for line in f if line.startswith("Udp:")]
+    except OSError:
+        return {}
+    if len(lines) < 2:
+        return {}
+    return {name: int(value) for name, value in zip(lines[0][1:], lines[1][1:])}
+
+
+def percentile(sorted_values, q):
+    """线性插值分位数（与 numpy.percentile 默认方式一致）"""
+    pos = (len(sorted_values) - 1) * q / 100.0
+    lo = int(pos)
+    hi = min(lo + 1, len(sorted_values) - 1)
+    return sorted_values[lo] + (sorted_values[hi] - sorted_values[lo]) * (pos - lo)
+
+
+def percentiles_ms(values):
+    if not values:
+        return None
+    ms = sorted(v * 1e3 for v in values)
+    return {
+        "p50": percentile(ms, 50),
+        "p90": percentile(ms, 90),
+        "p99": percentile(ms, 99),
+        "max": ms[-1],
+    }
+
+
+def consume(client, records):
+    """取帧线程：只记录每帧的元数据，尽快返回以免自身成为瓶颈"""
+    while True:
+        frame = client.get_frame()
+        if frame is None:
+            break
+        records.append((
+            time.monotonic(),
+            frame["frame_id"],
+            len(frame["points"]),
+            frame["receive_time"],
+            frame["ready_time"],
+        ))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay a pcap into rs_xue.Client and report fps, loss and latency")
+    parser.add_argument("pcap", help="capture containing MSOP/DIFOP packets")
+    parser.add_argument("--replay", default="pcap_replay", help="path to the pcap_replay binary")
+    parser.add_argument("--host", default="127.0.0.1", help="address packets are sent to and received on")
+    parser.add_argument("--msop-port", type=int, default=16699, help="MSOP port used for the replay")
+    parser.add_argument("--difop-port", type=int, default=17788, help="DIFOP port used for the replay")
+    parser.add_argument("--speed", type=float, default=1.0, help="replay speed factor, 0 = as fast as possible")
+    parser.add_argument("--loops", type=int, default=1, help="number of passes over the capture")
+    parser.add_argument("--batch", type=int, default=64, help="packets per sendmmsg call")
+    parser.add_argument("--max-points", type=int, default=0, help="points reserved per pooled frame (0 = grow on demand)")
+    parser.add_argument("--warmup", type=int, default=5, help="frames excluded from the statistics")
+    parser.add_argument("--grace", type=float, default=1.0, help="seconds to wait for the last frames after the replay")
+    parser.add_argument("--incomplete-ratio", type=float, default=0.9,
+                        help="frames with fewer points than this fraction of the median count as incomplete")
+    parser.add_argument("--max-frame-loss", type=float, default=None, help="fail if the dropped frame ratio exceeds this")
+    parser.add_argument("--max-incomplete", type=float, default=None, help="fail if the incomplete frame ratio exceeds this")
+    parser.add_argument("--max-p99-ms", type=float, default=None, help="fail if the p99 arrival-to-Python latency exceeds this")
+    parser.add_argument("--min-fps", type=float, default=None, help="fail if the sustained frame rate is below this")
+    parser.add_argument("--json", default=None, help="also write the report to this file")
+    args = parser.parse_args()
+
+    client = rs_xue.Client()
+    if args.max_points > 0:
+        pool = rs_xue.FramePoolConfig()
+        pool.max_points = args.max_points
+        client.set_frame_pool(pool)
+    if not client.initialize("", msop_port=args.msop_port, difop_port=args.difop_port, host_ip=args.host):
+        print("failed to initialize client", file=sys.stderr)
+        return 2
+
+    records = []
+    consumer = threading.Thread(target=consume, args=(client, records), daemon=True)
+    consumer.start()
+
+    udp_before = read_udp_counters()
+    replay = subprocess.run(
+        [args.replay, args.pcap, "--host", args.host,
+         "--msop-port", str(args.msop_port), "--difop-port", str(args.difop_port),
+         "--speed", str(args.speed), "--loops", str(args.loops), "--batch", str(args.batch)],
+        stdout=subprocess.PIPE, text=True)
+    time.sleep(args.grace)
+    udp_after = read_udp_counters()
+    client.stop()
+    consumer.join(timeout=5.0)
+    stats = client.get_stats()
+
+    if replay.returncode != 0:
+        print("pcap_replay failed with exit code %d" % replay.returncode, file=sys.stderr)
+        return 2
+    replay_report = json.loads(replay.stdout.strip().splitlines()[-1])
+
+    frames = records[args.warmup:]
+    report = {
+        "replay": replay_report,
+        "client": {
+            "frames_received": stats.frames_received,
+            "frames_processed": stats.frames_processed,
+            "frames_delivered": stats.frames_delivered,
+            "frames_overwritten": stats.frames_overwritten,
+            "points_received": stats.points_received,
+            "max_queue_depth": stats.max_queue_depth,
+            "message_allocations": stats.message_allocations,
+            "message_growths": stats.message_growths,
+            "frame_pool_misses": stats.frame_pool_misses,
+            "column_allocations": stats.column_allocations,
+        },
+    }
+    if udp_before and udp_after:
+        report["kernel_udp_drops"] = {
+            key: udp_after.get(key, 0) - udp_before.get(key, 0)
+            for key in ("InErrors", "RcvbufErrors")
+        }
+
+    if len(frames) >= 2:
+        t_get = [r[0] for r in frames]
+        seq = [r[1] for r in frames]
+        points = [r[2] for r in frames]
+
+        # 序号回绕/重置（差值 <= 0）不计入
+        seq_gaps = sum(b - a - 1 for a, b in zip(seq, seq[1:]) if b - a > 1)
+        median_points = float(statistics.median(points))
+        incomplete = sum(1 for n in points if n < args.incomplete_ratio * median_points)
+        duration = t_get[-1] - t_get[0]
+        dropped = max(stats.frames_received - stats.frames_delivered, 0)
+
+        report["frames"] = {
+            "delivered": len(frames),
+            "duration_s": float(duration),
+            "fps": float((len(frames) - 1) / duration) if duration > 0 else 0.0,
+            "seq_gaps": seq_gaps,
+            "dropped_ratio": dropped / stats.frames_received if stats.frames_received else 0.0,
+            "median_points": median_points,
+            "incomplete": incomplete,
+            "incomplete_ratio": incomplete / len(frames),
+        }
+        report["latency_ms"] = {
+            "processing": percentiles_ms([r[4] - r[3] for r in frames]),
+            "end_to_end": percentiles_ms([r[0] - r[3] for r in frames]),
+        }
+
+    print(json.dumps(report, indent=2))
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(report, f, indent=2)
+
+    failures = []
+    summary = report.get("frames")
+    if summary is None:
+        failures.append("fewer than %d frames received" % (args.warmup + 2))
+    else:
+        if args.max_frame_loss is not None and summary["dropped_ratio"] > args.max_frame_loss:
+            failures.append("dropped frame ratio %.4f > %.4f" % (summary["dropped_ratio"], args.max_frame_loss))
+        if args.max_incomplete is not None and summary["incomplete_ratio"] > args.max_incomplete:
+            failures.append("incomplete frame ratio %.4f > %.4f" % (summary["incomplete_ratio"], args.max_incomplete))
+        if args.min_fps is not None and summary["fps"] < args.min_fps:
+            failures.append("fps %.2f < %.2f" % (summary["fps"], args.min_fps))
+        p99 = report["latency_ms"]["end_to_end"]["p99"]
+        if args.max_p99_ms is not None and p99 > args.max_p99_ms:
+            failures.append("p99 latency %.2f ms > %.2f ms" % (p99, args.max_p99_ms))
+    for failure in failures:
+        print("FAIL: " + failure, file=sys.stderr)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())